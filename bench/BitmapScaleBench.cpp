@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmapScaler.h"
 #include "SkBlurMask.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
@@ -100,6 +101,44 @@ private:
     typedef BitmapScaleBench INHERITED;
 };
 
+// Resizes with the convolution procs for a particular SIMD level, so the portable, SSE2 and AVX2
+// convolvers can be compared directly.
+class BitmapConvolveScaleBench: public BitmapScaleBench {
+ public:
+    BitmapConvolveScaleBench(int is, int os, const char* procsName, int maxSSELevel)
+        : INHERITED(is, os) {
+        SkConvolutionProcs procs = { 0, NULL, NULL, NULL, NULL };
+        fProcs = procs;
+        SkBitmapScaler::PlatformConvolutionProcs(&fProcs, maxSSELevel);
+
+        // If this machine or build doesn't have the procs we asked for, we'd really just be
+        // timing some lower level, so don't bother.
+        SkBitmapScaler::PlatformConvolutionProcs(&procs, maxSSELevel - 1);
+        fAvailable = 0 == maxSSELevel || procs.fConvolveVertically != fProcs.fConvolveVertically;
+
+        SkString name;
+        name.printf("convolve_%s", procsName);
+        setName(name.c_str());
+    }
+
+protected:
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return fAvailable && INHERITED::isSuitableFor(backend);
+    }
+
+    virtual void doScaleImage() SK_OVERRIDE {
+        SkBitmap result;
+        SkBitmapScaler::Resize(&result, fInputBitmap, SkBitmapScaler::RESIZE_LANCZOS3,
+                               SkIntToScalar(outputSize()), SkIntToScalar(outputSize()), fProcs);
+    }
+
+private:
+    SkConvolutionProcs fProcs;
+    bool               fAvailable;
+
+    typedef BitmapScaleBench INHERITED;
+};
+
 DEF_BENCH(return new BitmapFilterScaleBench(10, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(30, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(80, 90);)
@@ -109,3 +148,10 @@ DEF_BENCH(return new BitmapFilterScaleBench(90, 30);)
 DEF_BENCH(return new BitmapFilterScaleBench(90, 10);)
 DEF_BENCH(return new BitmapFilterScaleBench(256, 64);)
 DEF_BENCH(return new BitmapFilterScaleBench(64, 256);)
+
+DEF_BENCH(return new BitmapConvolveScaleBench(1024, 256, "portable", 0);)
+DEF_BENCH(return new BitmapConvolveScaleBench(1024, 256, "sse2", SK_CPU_SSE_LEVEL_SSE2);)
+DEF_BENCH(return new BitmapConvolveScaleBench(1024, 256, "avx2", SK_CPU_SSE_LEVEL_AVX2);)
+DEF_BENCH(return new BitmapConvolveScaleBench(256, 1024, "portable", 0);)
+DEF_BENCH(return new BitmapConvolveScaleBench(256, 1024, "sse2", SK_CPU_SSE_LEVEL_SSE2);)
+DEF_BENCH(return new BitmapConvolveScaleBench(256, 1024, "avx2", SK_CPU_SSE_LEVEL_AVX2);)
@@ -7,7 +7,9 @@
  */
 
 #include "Benchmark.h"
+#include "SkBBHFactory.h"
 #include "SkCanvas.h"
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -65,6 +67,43 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Time how long it takes to bulk-load a packed R-Tree, which is built anew each time.
+class PackedRTreeBuildBench : public Benchmark {
+public:
+    PackedRTreeBuildBench(const char* name, MakeRectProc proc, SkPackedRTree::Order order)
+        : fProc(proc)
+        , fOrder(order) {
+        fName.append("packedrtree_");
+        fName.append(name);
+        fName.append("_build");
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            SkPackedRTree tree(GENERATE_EXTENTS, GENERATE_EXTENTS, fOrder);
+            tree.reserve(NUM_BUILD_RECTS);
+            for (int j = 0; j < NUM_BUILD_RECTS; ++j) {
+                tree.insert(j, fProc(rand, j, NUM_BUILD_RECTS), true);
+            }
+            tree.flushDeferredInserts();
+        }
+    }
+private:
+    MakeRectProc fProc;
+    SkPackedRTree::Order fOrder;
+    SkString fName;
+    typedef Benchmark INHERITED;
+};
+
 // Time how long it takes to perform queries on an R-Tree, bulk-loaded or not
 class RTreeQueryBench : public Benchmark {
 public:
@@ -76,12 +115,13 @@ public:
     };
 
     RTreeQueryBench(const char* name, MakeRectProc proc, bool bulkLoad,
-                    QueryType q, SkRTree* tree)
+                    QueryType q, SkBBoxHierarchy* tree, const char* type = "rtree")
         : fTree(tree)
         , fProc(proc)
         , fBulkLoad(bulkLoad)
         , fQuery(q) {
-        fName.append("rtree_");
+        fName.append(type);
+        fName.append("_");
         fName.append(name);
         fName.append("_query");
         if (fBulkLoad) {
@@ -183,6 +223,19 @@ static inline SkRect make_random_rects(SkRandom& rand, int index, int numRects)
     return out;
 }
 
+static SkBBoxHierarchy* make_packed_rtree(SkPackedRTree::Order order) {
+    return SkNEW_ARGS(SkPackedRTree, (GENERATE_EXTENTS, GENERATE_EXTENTS, order));
+}
+
+static SkBBoxHierarchy* make_tile_grid() {
+    SkTileGridFactory::TileGridInfo info;
+    info.fTileInterval.set(GRID_WIDTH, GRID_WIDTH);
+    info.fMargin.setEmpty();
+    info.fOffset.setZero();
+    const int extent = SkScalarCeilToInt(GENERATE_EXTENTS);
+    return SkTileGridFactory(info)(extent, extent);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(
@@ -264,3 +317,97 @@ DEF_BENCH(
     return SkNEW_ARGS(RTreeQueryBench, ("(unsorted)concentric", &make_concentric_rects_increasing, true,
                       RTreeQueryBench::kRandom_QueryType, SkRTree::Create(5, 16, 1, false)));
 )
+
+// Packed R-Trees, and a tile grid for comparison, always bulk-loaded.
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(hilbert)XYordered", &make_XYordered_rects,
+                      SkPackedRTree::kHilbert_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(opindex)XYordered", &make_XYordered_rects,
+                      SkPackedRTree::kOpIndex_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(hilbert)XYordered", &make_XYordered_rects, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kHilbert_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(opindex)XYordered", &make_XYordered_rects, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kOpIndex_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("XYordered", &make_XYordered_rects, true,
+                      RTreeQueryBench::kRandom_QueryType, make_tile_grid(), "tilegrid"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(hilbert)YXordered", &make_YXordered_rects,
+                      SkPackedRTree::kHilbert_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(opindex)YXordered", &make_YXordered_rects,
+                      SkPackedRTree::kOpIndex_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(hilbert)YXordered", &make_YXordered_rects, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kHilbert_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(opindex)YXordered", &make_YXordered_rects, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kOpIndex_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("YXordered", &make_YXordered_rects, true,
+                      RTreeQueryBench::kRandom_QueryType, make_tile_grid(), "tilegrid"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(hilbert)random", &make_random_rects,
+                      SkPackedRTree::kHilbert_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(opindex)random", &make_random_rects,
+                      SkPackedRTree::kOpIndex_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(hilbert)random", &make_random_rects, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kHilbert_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(opindex)random", &make_random_rects, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kOpIndex_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("random", &make_random_rects, true,
+                      RTreeQueryBench::kRandom_QueryType, make_tile_grid(), "tilegrid"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(hilbert)concentric",
+                      &make_concentric_rects_increasing,
+                      SkPackedRTree::kHilbert_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(PackedRTreeBuildBench, ("(opindex)concentric",
+                      &make_concentric_rects_increasing,
+                      SkPackedRTree::kOpIndex_Order));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(hilbert)concentric",
+                      &make_concentric_rects_increasing, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kHilbert_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("(opindex)concentric",
+                      &make_concentric_rects_increasing, true,
+                      RTreeQueryBench::kRandom_QueryType,
+                      make_packed_rtree(SkPackedRTree::kOpIndex_Order), "packedrtree"));
+)
+DEF_BENCH(
+    return SkNEW_ARGS(RTreeQueryBench, ("concentric", &make_concentric_rects_increasing, true,
+                      RTreeQueryBench::kRandom_QueryType, make_tile_grid(), "tilegrid"));
+)
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "RecordOptsBench.h"
+
+#include "SkRecord.h"
+#include "SkRecordOpts.h"
+#include "SkRecorder.h"
+
+RecordOptsBench::RecordOptsBench(const char* name, const SkPicture* pic,
+                                 const char* passesName, uint32_t passes)
+    : fSrc(SkRef(pic))
+    , fPasses(passes) {
+    fName.printf("%s_%s", name, passesName);
+}
+
+static const struct {
+    const char* fName;
+    uint32_t fPasses;
+} gPasses[] = {
+    { "none",                       0 },
+    { "default",                    kDefault_SkRecordOptimizePasses },
+    { "all",                        ~0u },
+    { "NoopSaveRestores",           kNoopSaveRestores_SkRecordOptimizePass },
+    { "NoopSaveLayerDrawRestores",  kNoopSaveLayerDrawRestores_SkRecordOptimizePass },
+    { "NoopRedundantSetMatrices",   kNoopRedundantSetMatrices_SkRecordOptimizePass },
+    { "NoopRedundantClipRects",     kNoopRedundantClipRects_SkRecordOptimizePass },
+    { "MergeDrawRects",             kMergeDrawRects_SkRecordOptimizePass },
+    { "NoopOccludedDraws",          kNoopOccludedDraws_SkRecordOptimizePass },
+    { "MergeDrawPosTexts",          kMergeDrawPosTexts_SkRecordOptimizePass },
+};
+
+bool RecordOptsBench::ParsePasses(const char* name, uint32_t* passes) {
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gPasses); i++) {
+        if (0 == strcmp(name, gPasses[i].fName)) {
+            *passes = gPasses[i].fPasses;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* RecordOptsBench::onGetName() {
+    return fName.c_str();
+}
+
+bool RecordOptsBench::isSuitableFor(Backend backend) {
+    return backend == kNonRendering_Backend;
+}
+
+SkIPoint RecordOptsBench::onGetSize() {
+    return SkIPoint::Make(SkScalarCeilToInt(fSrc->cullRect().width()),
+                          SkScalarCeilToInt(fSrc->cullRect().height()));
+}
+
+void RecordOptsBench::onDraw(const int loops, SkCanvas*) {
+    const SkScalar w = fSrc->cullRect().width(),
+                   h = fSrc->cullRect().height();
+
+    for (int i = 0; i < loops; i++) {
+        SkRecord record;
+        SkRecorder recorder(&record, w, h);
+        fSrc->playback(&recorder);
+        SkRecordOptimize(&record, fPasses);
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef RecordOptsBench_DEFINED
+#define RecordOptsBench_DEFINED
+
+#include "Benchmark.h"
+#include "SkPicture.h"
+
+// Records an SkPicture into an SkRecord and runs the given SkRecordOptimize() passes on it.
+// Compare against passes "none" to see what the passes cost.
+class RecordOptsBench : public Benchmark {
+public:
+    RecordOptsBench(const char* name, const SkPicture*, const char* passesName, uint32_t passes);
+
+    // Parses the name of one of SkRecordOpts' passes, e.g. "MergeDrawRects", or "none",
+    // "default" or "all" into bits for SkRecordOptimize(), returning false if it's none of these.
+    static bool ParsePasses(const char* name, uint32_t* passes);
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE;
+    virtual bool isSuitableFor(Backend) SK_OVERRIDE;
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE;
+    virtual SkIPoint onGetSize() SK_OVERRIDE;
+
+private:
+    SkAutoTUnref<const SkPicture> fSrc;
+    SkString fName;
+    uint32_t fPasses;
+
+    typedef Benchmark INHERITED;
+};
+
+#endif//RecordOptsBench_DEFINED
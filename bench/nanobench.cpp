@@ -12,6 +12,7 @@
 #include "GMBench.h"
 #include "ProcStats.h"
 #include "ResultsWriter.h"
+#include "RecordOptsBench.h"
 #include "RecordingBench.h"
 #include "SKPBench.h"
 #include "Stats.h"
@@ -70,6 +71,8 @@ DEFINE_int32(maxLoops, 1000000, "Never run a bench more times than this.");
 DEFINE_string(clip, "0,0,1000,1000", "Clip for SKPs.");
 DEFINE_string(scales, "1.0", "Space-separated scales for SKPs.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
+DEFINE_string(recordOpts, "", "Also bench recording SKPs with these SkRecordOpts passes, by name, "
+                              "or none, default, or all.  See RecordOptsBench.");
 
 static SkString humanize(double ms) {
     if (FLAGS_verbose) return SkStringPrintf("%llu", (uint64_t)(ms*1e6));
@@ -410,6 +413,8 @@ public:
     BenchmarkStream() : fBenches(BenchRegistry::Head())
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
+                      , fCurrentRecordOpts(0)
+                      , fCurrentRecordOptsSKP(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0) {
         for (int i = 0; i < FLAGS_skps.count(); i++) {
@@ -430,6 +435,14 @@ public:
             exit(1);
         }
 
+        for (int i = 0; i < FLAGS_recordOpts.count(); i++) {
+            if (!RecordOptsBench::ParsePasses(FLAGS_recordOpts[i], &fRecordOpts.push_back())) {
+                SkDebugf("Can't parse %s from --recordOpts as SkRecordOpts passes.\n",
+                         FLAGS_recordOpts[i]);
+                exit(1);
+            }
+        }
+
         for (int i = 0; i < FLAGS_scales.count(); i++) {
             if (1 != sscanf(FLAGS_scales[i], "%f", &fScales.push_back())) {
                 SkDebugf("Can't parse %s from --scales as an SkScalar.\n", FLAGS_scales[i]);
@@ -491,6 +504,25 @@ public:
             return SkNEW_ARGS(RecordingBench, (name.c_str(), pic.get(), FLAGS_bbh));
         }
 
+        // Then once for each set of --recordOpts as RecordOptsBenches.
+        while (fCurrentRecordOpts < fRecordOpts.count()) {
+            while (fCurrentRecordOptsSKP < fSKPs.count()) {
+                const SkString& path = fSKPs[fCurrentRecordOptsSKP++];
+                SkAutoTUnref<SkPicture> pic;
+                if (!ReadPicture(path.c_str(), &pic)) {
+                    continue;
+                }
+                SkString name = SkOSPath::Basename(path.c_str());
+                fSourceType = "skp";
+                fBenchType  = "recording";
+                return SkNEW_ARGS(RecordOptsBench, (name.c_str(), pic.get(),
+                                                    FLAGS_recordOpts[fCurrentRecordOpts],
+                                                    fRecordOpts[fCurrentRecordOpts]));
+            }
+            fCurrentRecordOptsSKP = 0;
+            fCurrentRecordOpts++;
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -544,10 +576,13 @@ private:
     SkIRect            fClip;
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
+    SkTArray<uint32_t> fRecordOpts;
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
+    int fCurrentRecordOpts;
+    int fCurrentRecordOptsSKP;
     int fCurrentScale;
     int fCurrentSKP;
 };
@@ -48,6 +48,7 @@
           'dependencies': [
             'opts_ssse3',
             'opts_sse4',
+            'opts_avx2',
           ],
           'sources': [
             '../src/opts/opts_check_x86.cpp',
@@ -56,6 +57,7 @@
             '../src/opts/SkBlitRow_opts_SSE2.cpp',
             '../src/opts/SkBlitRect_opts_SSE2.cpp',
             '../src/opts/SkBlurImage_opts_SSE2.cpp',
+            '../src/opts/SkGradient_opts_SSE2.cpp',
             '../src/opts/SkMorphology_opts_SSE2.cpp',
             '../src/opts/SkTextureCompression_opts_none.cpp',
             '../src/opts/SkUtils_opts_SSE2.cpp',
@@ -83,6 +85,7 @@
             '../src/opts/SkBlitMask_opts_arm.cpp',
             '../src/opts/SkBlitRow_opts_arm.cpp',
             '../src/opts/SkBlurImage_opts_arm.cpp',
+            '../src/opts/SkGradient_opts_none.cpp',
             '../src/opts/SkMorphology_opts_arm.cpp',
             '../src/opts/SkTextureCompression_opts_arm.cpp',
             '../src/opts/SkUtils_opts_arm.cpp',
@@ -108,6 +111,7 @@
           'sources': [
             '../src/opts/SkBlitMask_opts_none.cpp',
             '../src/opts/SkBlurImage_opts_none.cpp',
+            '../src/opts/SkGradient_opts_none.cpp',
             '../src/opts/SkMorphology_opts_none.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
             '../src/opts/SkTextureCompression_opts_none.cpp',
@@ -136,6 +140,7 @@
             '../src/opts/SkBlitMask_opts_none.cpp',
             '../src/opts/SkBlitRow_opts_none.cpp',
             '../src/opts/SkBlurImage_opts_none.cpp',
+            '../src/opts/SkGradient_opts_none.cpp',
             '../src/opts/SkMorphology_opts_none.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
             '../src/opts/SkTextureCompression_opts_none.cpp',
@@ -161,6 +166,7 @@
             '../src/opts/SkBlitRow_opts_arm_neon.cpp',
             '../src/opts/SkBlurImage_opts_arm.cpp',
             '../src/opts/SkBlurImage_opts_neon.cpp',
+            '../src/opts/SkGradient_opts_none.cpp',
             '../src/opts/SkMorphology_opts_arm.cpp',
             '../src/opts/SkMorphology_opts_neon.cpp',
             '../src/opts/SkTextureCompression_opts_none.cpp',
@@ -256,6 +262,48 @@
         }],
       ],
     },
+    # Same again for AVX2 code, which must be compiled with -mavx2.
+    {
+      'target_name': 'opts_avx2',
+      'product_name': 'skia_opts_avx2',
+      'type': 'static_library',
+      'standalone_static_library': 1,
+      'dependencies': [
+        'core.gyp:*',
+        'effects.gyp:*'
+      ],
+      'include_dirs': [
+        '../src/core',
+        '../src/utils',
+      ],
+      'sources': [
+        '../src/opts/SkBitmapFilter_opts_AVX2.cpp',
+        '../src/opts/SkBlitRow_opts_AVX2.cpp',
+        '../src/opts/SkGradient_opts_AVX2.cpp',
+        '../src/opts/SkXfermode_opts_AVX2.cpp',
+      ],
+      'conditions': [
+        [ 'skia_os == "win"', {
+            'defines' : [ 'SK_CPU_SSE_LEVEL=52' ],
+        }],
+        [ 'skia_os in ["linux", "freebsd", "openbsd", "solaris", "nacl", "chromeos", "android"] \
+           and not skia_android_framework', {
+          'cflags': [
+            '-mavx2',
+          ],
+        }],
+        [ 'skia_os == "mac"', {
+          'xcode_settings': {
+            'OTHER_CPLUSPLUSFLAGS!': [
+              '-mssse3',
+            ],
+            'OTHER_CPLUSPLUSFLAGS': [
+              '-mavx2',
+            ],
+          },
+        }],
+      ],
+    },
     # NEON code must be compiled with -mfpu=neon which also affects scalar
     # code. To support dynamic NEON code paths, we need to build all
     # NEON-specific sources in a separate static library. The situation
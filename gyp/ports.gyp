@@ -72,6 +72,13 @@
           'dependencies': [
             'freetype.gyp:freetype',
           ],
+          'conditions': [
+            [ 'skia_freetype_private_faces', {
+              'defines': [
+                'SK_FONTHOST_FREETYPE_PRIVATE_FACES',
+              ],
+            }],
+          ],
         }],
         [ 'skia_os in ["linux", "freebsd", "openbsd", "solaris", "chromeos"]', {
           'conditions': [
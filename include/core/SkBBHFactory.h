@@ -29,6 +29,17 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Creates a read-only R-Tree packed into arrays, which is smaller and quicker to search than
+ *  SkRTree, but must be built all at once.  Pictures always build their BBH that way.
+ */
+class SK_API SkPackedRTreeFactory : public SkBBHFactory {
+public:
+    virtual SkBBoxHierarchy* operator()(int width, int height) const SK_OVERRIDE;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
 class SK_API SkTileGridFactory : public SkBBHFactory {
 public:
     struct TileGridInfo {
@@ -38,7 +38,8 @@ public:
      *  Create a PDF-backed document, writing the results into a file.
      *  If there is an error trying to create the doc, returns NULL.
      *  encoder sets the DCTEncoder for images, to encode a bitmap
-     *    as JPEG (DCT).
+     *    as JPEG (DCT). It may be called from SkTaskGroup threads, but
+     *    never from more than one at a time.
      *  rasterDpi - the DPI at which features without native PDF support
      *              will be rasterized (e.g. draw image with perspective,
      *              draw text with perspective, ...)
@@ -63,7 +64,8 @@ public:
      *  if there is a Done proc provided, it will be called with the stream.
      *  The proc can delete the stream, or whatever it needs to do.
      *  encoder sets the DCTEncoder for images, to encode a bitmap
-     *    as JPEG (DCT).
+     *    as JPEG (DCT). It may be called from SkTaskGroup threads, but
+     *    never from more than one at a time.
      *  Done - clean up method intended to allow deletion of the stream.
      *         Its aborted parameter is true if the cleanup is due to an abort
      *         call. It is false otherwise.
@@ -80,6 +82,19 @@ public:
             SkPicture::EncodeBitmap encoder = NULL,
             SkScalar rasterDpi = SK_ScalarDefaultRasterDPI);
 
+    /**
+     *  Like CreatePDF(SkWStream*, ...), but each page is written to the
+     *  stream by endPage() and then freed, so memory use is bounded by the
+     *  largest page rather than by the whole document.  Fonts are kept until
+     *  close(), which writes them; other resources a page shares with
+     *  earlier pages (e.g. a repeated bitmap) are written again.  Since the
+     *  stream is written as pages end, abort() leaves what's been written.
+     */
+    static SkDocument* CreateStreamingPDF(
+            SkWStream*, void (*Done)(SkWStream*,bool aborted) = NULL,
+            SkPicture::EncodeBitmap encoder = NULL,
+            SkScalar rasterDpi = SK_ScalarDefaultRasterDPI);
+
     /**
      *  Begin a new page for the document, returning the canvas that will draw
      *  into the page. The document owns this canvas, and it will go out of
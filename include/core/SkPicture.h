@@ -24,6 +24,7 @@ class GrReplacements;
 class SkBBoxHierarchy;
 class SkCanvas;
 class SkData;
+class SkMemoryStream;
 class SkPictureData;
 class SkPictureRecord;
 class SkStream;
@@ -103,6 +104,31 @@ public:
      */
     static SkPicture* CreateFromBuffer(SkReadBuffer&);
 
+    /**
+     *  Function signature defining a function that sets up an SkBitmap from encoded data. Unlike
+     *  InstallPixelRefProc, the data is passed as an SkData, which a pixelref that defers the
+     *  actual decode may ref instead of copying. For example:
+     *      return SkInstallDiscardablePixelRef(
+     *          SkDecodingImageGenerator::Create(encoded, SkDecodingImageGenerator::Options()), dst);
+     *  @param encoded Encoded data.
+     *  @param dst SkBitmap to install the pixel ref on.
+     *  @return Whether or not a pixel ref was successfully installed.
+     */
+    typedef bool (*InstallLazyPixelRefProc)(SkData* encoded, SkBitmap* dst);
+
+    /**
+     *  Recreate a picture that was serialized into memory, typically a file mapped with
+     *  SkData::NewFromFileName(). Unlike CreateFromStream(), the picture plays back from the data
+     *  in place instead of being re-recorded, and each encoded bitmap is handed to proc as a
+     *  subset of the data, so nothing needs decoding until it is drawn.
+     *  @param SkData Serialized picture data. The picture refs it.
+     *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
+     *              encoded bitmap data.
+     *  @return A new SkPicture representing the serialized data, or NULL if the data is
+     *          invalid.
+     */
+    static SkPicture* CreateFromData(SkData*, InstallLazyPixelRefProc proc);
+
     virtual ~SkPicture();
 
     /** Replays the drawing commands on the specified canvas. Note that
@@ -243,13 +269,15 @@ private:
     // V34: Add SkTextBlob serialization.
     // V35: Store SkRect (rather then width & height) in header
     // V36: Remove (obsolete) alphatype from SkColorTable
+    // V37: The ops may be split across several SK_PICT_READER_TAG chunks; header, factories
+    //      and typefaces are padded so every chunk starts 4-byte aligned
 
     // Note: If the picture version needs to be increased then please follow the
     // steps to generate new SKPs in (only accessible to Googlers): http://goo.gl/qATVcw
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t MIN_PICTURE_VERSION = 19;
-    static const uint32_t CURRENT_PICTURE_VERSION = 36;
+    static const uint32_t CURRENT_PICTURE_VERSION = 37;
 
     mutable uint32_t      fUniqueID;
 
@@ -269,19 +297,28 @@ private:
 
     SkPicture(SkScalar width, SkScalar height, const SkPictureRecord& record, bool deepCopyOps);
 
-    void createHeader(SkPictInfo* info) const;
+    static void CreateHeader(const SkRect& cullRect, SkPictInfo* info);
     static bool IsValidPictInfo(const SkPictInfo& info);
+    // stream reads data, which the picture's ops and encoded bitmaps stay in.
+    static SkPicture* CreateFromData(SkMemoryStream* stream, SkData* data,
+                                     InstallLazyPixelRefProc proc);
 
     friend class SkPictureRecorder;            // SkRecord-based constructor.
     friend class SkGpuDevice;                  // for fData access
     friend class GrLayerHoister;               // access to fRecord
     friend class CollectLayers;                // access to fRecord
     friend class SkPicturePlayback;            // to get fData
+    friend class SkPictureData;                // to create nested pictures from data
+    friend class SkStreamingPictureRecorder;   // to write the header
     friend class ReplaceDraw;
+    friend class SkPictureReuseIndex;          // to compare pictures' fRecords
+    friend class SkPictureUtils;               // to compute damage from fRecords
+    friend class PictureDataTester;            // for unit testing
 
     typedef SkRefCnt INHERITED;
 
-    // Takes ownership of the SkRecord, refs the (optional) BBH.
+    // Takes ownership of the SkRecord, refs the (optional) BBH. The record is kept as is, so
+    // callers optimize it first.
     SkPicture(SkScalar width, SkScalar height, SkRecord*, SkBBoxHierarchy*);
     // Return as a new SkPicture that's backed by SkRecord.
     static SkPicture* Forwardport(const SkPicture&);
@@ -291,6 +328,12 @@ private:
     SkAutoTDelete<SkRecord>       fRecord;
     SkAutoTUnref<SkBBoxHierarchy> fBBH;
 
+    // SkRecordHash() of a record, with 0 reserved to mean not yet computed.
+    static uint32_t ContentHash(const SkRecord&);
+    // ContentHash(*fRecord), computed the first time it's needed.
+    uint32_t contentHash() const;
+    mutable uint32_t              fContentHash;
+
     struct PathCounter;
 
     struct Analysis {
@@ -305,6 +348,7 @@ private:
         int         fNumFastPathDashEffects;
         int         fNumAAConcavePaths;
         int         fNumAAHairlineConcavePaths;
+        int         fNumPictures;  // DrawPicture ops, not counting those in nested pictures
     } fAnalysis;
 };
 
@@ -60,6 +60,23 @@ public:
     */
     SkPicture* endRecording();
 
+    /** Like endRecording(), but shares what it can with previous, typically
+        the picture recorded for the last frame. Each picture drawn into this
+        recording is swapped for an equal one drawn by previous, at any depth,
+        and if the whole recording equals previous or one of the pictures it
+        draws, that picture is returned (with a new ref) instead. Shared
+        pictures keep their ops and bounding box hierarchies, so the memory
+        used and the hierarchies built scale with what changed.
+
+        Pictures are equal when they make the same calls with equal arguments
+        and have the same cull size; their paints' effects, text blobs and
+        nested pictures must be the same objects, and their bitmaps must share
+        pixels. To share pictures drawn into pictures, record those with
+        endRecordingReusing() too, passing the same previous.
+        @param previous the picture to share with, or NULL.
+    */
+    SkPicture* endRecordingReusing(const SkPicture* previous);
+
 private:
     void reset();
 
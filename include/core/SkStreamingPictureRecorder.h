@@ -0,0 +1,69 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamingPictureRecorder_DEFINED
+#define SkStreamingPictureRecorder_DEFINED
+
+#include "SkPicture.h"
+#include "SkRefCnt.h"
+
+class SkCanvas;
+class SkPictureRecord;
+class SkWStream;
+
+/**
+ *  Records drawing commands straight into a serialized picture, for recordings too big to hold in
+ *  memory whole. The result is what SkPicture::serialize() would write (read it back with
+ *  SkPicture::CreateFromStream), but rather than keeping every op until the end, the ops are
+ *  written to the stream in chunks as recording goes. Paints, paths, bitmaps and nested pictures
+ *  are deduplicated as usual, and written out by endRecording().
+ */
+class SK_API SkStreamingPictureRecorder : SkNoncopyable {
+public:
+    SkStreamingPictureRecorder();
+    ~SkStreamingPictureRecorder();
+
+    /** Returns the canvas that records the drawing commands.
+        @param stream where to write the picture. It must outlive the recording.
+        @param width the width of the cull rect used when recording this picture.
+        @param height the height of the cull rect used when recording this picture.
+        @param encoder function used to encode bitmaps, as for SkPicture::serialize().
+        @param chunkSize roughly how many bytes of ops to hold before writing them out. Ops
+               inside a save or cull can't be written out until it ends, so deeply nested
+               drawing may hold more.
+        @return the canvas.
+    */
+    SkCanvas* beginRecording(SkWStream* stream, SkScalar width, SkScalar height,
+                             SkPicture::EncodeBitmap encoder = NULL,
+                             size_t chunkSize = kDefaultChunkSize);
+
+    /** Returns the recording canvas if one is active, or NULL if recording is
+        not active. This does not alter the refcnt on the canvas (if present).
+    */
+    SkCanvas* getRecordingCanvas();
+
+    /** Signal that the caller is done recording. This invalidates the canvas
+        returned by beginRecording/getRecordingCanvas, and writes the rest of the
+        picture to the stream.
+        @return false if writing the header or any chunk of ops failed. Like
+                SkPicture::serialize(), this doesn't check the writes of the rest.
+    */
+    bool endRecording();
+
+    static const size_t kDefaultChunkSize = 1 << 20;
+
+private:
+    SkWStream*                     fStream;
+    SkPicture::EncodeBitmap        fEncoder;
+    SkRect                         fCullRect;
+    bool                           fHeaderOK;
+    SkAutoTUnref<SkPictureRecord>  fRecord;
+
+    typedef SkNoncopyable INHERITED;
+};
+
+#endif
@@ -26,6 +26,14 @@ public:
          *  between them.
          */
         kInterpolateColorsInPremul_Flag = 1 << 0,
+
+        /** By default gradients look their colors up in a table of 256 entries, dithered
+         *  between neighboring entries. By setting this flag, linear and radial gradients
+         *  instead interpolate each pixel's color in floating point. This is slower, but avoids
+         *  the table's banding on long or low-contrast gradients. It applies to drawing into
+         *  32-bit destinations; other gradients, and 16-bit destinations, ignore it.
+         */
+        kHighQualityInterpolation_Flag = 1 << 1,
     };
 
     /** Returns a shader that generates a linear gradient between the two
@@ -91,6 +91,7 @@ private:
     SkTSet<SkPDFObject*>* fFirstPageResources;
     SkTSet<SkPDFObject*>* fOtherPageResources;
     SkTDArray<SkPDFObject*> fSubstitutes;
+    SkTDArray<SkPDFObject*> fDuplicates;  // Merged into other resources.
 
     SkPDFDict* fTrailerDict;
 
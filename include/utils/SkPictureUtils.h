@@ -12,6 +12,9 @@
 #include "SkTDArray.h"
 
 class SkData;
+class SkMatrix;
+class SkRegion;
+class SkSurface;
 struct SkRect;
 
 class SK_API SkPictureUtils {
@@ -78,6 +81,34 @@ public:
      *  and rect information.
      */
     static void GatherPixelRefsAndRects(SkPicture* pict, SkPixelRefContainer* prCont);
+
+    /**
+     *  Play back the picture into a raster surface, splitting the surface into
+     *  tileWidth x tileHeight tiles and drawing the tiles concurrently on
+     *  SkTaskGroup threads.  Each tile is clipped to its own bounds, so if the
+     *  picture was recorded with a bounding box hierarchy only the ops that
+     *  touch that tile are played back for it.
+     *
+     *  If matrix is not NULL, it is concatenated before each tile's playback.
+     *  Returns false (and draws nothing) if the surface's pixels can not be
+     *  accessed directly, e.g. for a GPU-backed surface.
+     */
+    static bool DrawTiled(const SkPicture* pict, SkSurface* surface, const SkMatrix* matrix,
+                          int tileWidth, int tileHeight);
+
+    /**
+     *  Set damage to the pixels, in the pictures' coordinates, that may draw
+     *  differently when after is played back in place of before. Playing back
+     *  after clipped to damage, over before's pixels, gives the same result as
+     *  playing all of it back.
+     *
+     *  The pictures' ops are matched by their content and bounds. Nested
+     *  pictures, and paints' effects, only match if they are the same objects,
+     *  so record with SkPictureRecorder::endRecordingReusing() to keep unchanged
+     *  parts of a frame from adding to its damage. Pictures that were not
+     *  recorded with SkPictureRecorder are damaged everywhere they draw.
+     */
+    static void ComputeDamage(const SkPicture* before, const SkPicture* after, SkRegion* damage);
 };
 
 #endif
@@ -6,6 +6,7 @@
  */
 
 #include "SkBBHFactory.h"
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkTileGrid.h"
 
@@ -24,6 +25,10 @@ SkBBoxHierarchy* SkRTreeFactory::operator()(int width, int height) const {
                            aspectRatio, sortDraws);
 }
 
+SkBBoxHierarchy* SkPackedRTreeFactory::operator()(int width, int height) const {
+    return SkNEW_ARGS(SkPackedRTree, (SkIntToScalar(width), SkIntToScalar(height)));
+}
+
 SkBBoxHierarchy* SkTileGridFactory::operator()(int width, int height) const {
     SkASSERT(fInfo.fMargin.width() >= 0);
     SkASSERT(fInfo.fMargin.height() >= 0);
@@ -241,23 +241,20 @@ static SkBitmapScaler::ResizeMethod ResizeMethodToAlgorithmMethod(
     }
 }
 
-// static
-bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
-                            const SkBitmap& source,
-                            ResizeMethod method,
-                            float destWidth, float destHeight,
-                            SkBitmap::Allocator* allocator) {
-
-  SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
-  PlatformConvolutionProcs(&convolveProcs);
-
+static bool resize(SkBitmap* resultPtr,
+                   const SkBitmap& source,
+                   SkBitmapScaler::ResizeMethod method,
+                   float destWidth, float destHeight,
+                   SkBitmap::Allocator* allocator,
+                   const SkConvolutionProcs& convolveProcs,
+                   bool inParallel) {
   SkRect destSubset = { 0, 0, destWidth, destHeight };
 
   // Ensure that the ResizeMethod enumeration is sound.
-    SkASSERT(((RESIZE_FIRST_QUALITY_METHOD <= method) &&
-        (method <= RESIZE_LAST_QUALITY_METHOD)) ||
-        ((RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
-        (method <= RESIZE_LAST_ALGORITHM_METHOD)));
+    SkASSERT(((SkBitmapScaler::RESIZE_FIRST_QUALITY_METHOD <= method) &&
+        (method <= SkBitmapScaler::RESIZE_LAST_QUALITY_METHOD)) ||
+        ((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
+        (method <= SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD)));
 
     SkRect dest = { 0, 0, destWidth, destHeight };
     if (!dest.contains(destSubset)) {
@@ -307,11 +304,19 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
         return false;
     }
 
-    BGRAConvolve2D(sourceSubset, static_cast<int>(source.rowBytes()),
-        !source.isOpaque(), filter.xFilter(), filter.yFilter(),
-        static_cast<int>(result.rowBytes()),
-        static_cast<unsigned char*>(result.getPixels()),
-        convolveProcs, true);
+    if (inParallel) {
+        BGRAConvolve2DParallel(sourceSubset, static_cast<int>(source.rowBytes()),
+            !source.isOpaque(), filter.xFilter(), filter.yFilter(),
+            static_cast<int>(result.rowBytes()),
+            static_cast<unsigned char*>(result.getPixels()),
+            convolveProcs, true);
+    } else {
+        BGRAConvolve2D(sourceSubset, static_cast<int>(source.rowBytes()),
+            !source.isOpaque(), filter.xFilter(), filter.yFilter(),
+            static_cast<int>(result.rowBytes()),
+            static_cast<unsigned char*>(result.getPixels()),
+            convolveProcs, true);
+    }
 
     *resultPtr = result;
     resultPtr->lockPixels();
@@ -319,6 +324,41 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
     return true;
 }
 
+// static
+bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
+                            const SkBitmap& source,
+                            ResizeMethod method,
+                            float destWidth, float destHeight,
+                            SkBitmap::Allocator* allocator) {
+    SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
+    PlatformConvolutionProcs(&convolveProcs);
+    return resize(resultPtr, source, method, destWidth, destHeight, allocator, convolveProcs,
+                  false);
+}
+
+// static
+bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
+                            const SkBitmap& source,
+                            ResizeMethod method,
+                            float destWidth, float destHeight,
+                            const SkConvolutionProcs& convolveProcs,
+                            SkBitmap::Allocator* allocator) {
+    return resize(resultPtr, source, method, destWidth, destHeight, allocator, convolveProcs,
+                  false);
+}
+
+// static
+bool SkBitmapScaler::ResizeInParallel(SkBitmap* resultPtr,
+                                      const SkBitmap& source,
+                                      ResizeMethod method,
+                                      float destWidth, float destHeight,
+                                      SkBitmap::Allocator* allocator) {
+    SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
+    PlatformConvolutionProcs(&convolveProcs);
+    return resize(resultPtr, source, method, destWidth, destHeight, allocator, convolveProcs,
+                  true);
+}
+
 // static -- simpler interface to the resizer; returns a default bitmap if scaling
 // fails for any reason.  This is the interface that Chrome expects.
 SkBitmap SkBitmapScaler::Resize(const SkBitmap& source,
@@ -85,6 +85,27 @@ public:
                        float dest_width, float dest_height,
                        SkBitmap::Allocator* allocator = NULL);
 
+    /** Same as Resize(), but convolves with the given procs instead of the ones
+        PlatformConvolutionProcs() picks.  Useful for tests and benchmarks.
+     */
+    static bool Resize(SkBitmap* result,
+                       const SkBitmap& source,
+                       ResizeMethod method,
+                       float dest_width, float dest_height,
+                       const SkConvolutionProcs& procs,
+                       SkBitmap::Allocator* allocator = NULL);
+
+    /** Same as Resize(), with bit-identical results, but splits the work into bands of rows
+        that run on SkTaskGroup threads (if there are any, see SkTaskGroup::Enabler).  This
+        is worthwhile for large images, but costs an intermediate image of
+        source height * dest_width pixels.
+     */
+    static bool ResizeInParallel(SkBitmap* result,
+                                 const SkBitmap& source,
+                                 ResizeMethod method,
+                                 float dest_width, float dest_height,
+                                 SkBitmap::Allocator* allocator = NULL);
+
     static SkBitmap Resize(const SkBitmap& source,
                            ResizeMethod method,
                            float dest_width, float dest_height,
@@ -95,6 +116,12 @@ public:
       */
 
     static void PlatformConvolutionProcs(SkConvolutionProcs*);
+
+    /** Like PlatformConvolutionProcs(), but ignores any SIMD versions that need more than
+        maxSSELevel (one of the SK_CPU_SSE_LEVEL_* values).  Platforms other than x86 ignore
+        maxSSELevel.  Useful for comparing the versions in tests and benchmarks.
+      */
+    static void PlatformConvolutionProcs(SkConvolutionProcs*, int maxSSELevel);
 };
 
 #endif
@@ -4,6 +4,8 @@
 
 #include "SkConvolver.h"
 #include "SkSize.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
 namespace {
@@ -487,3 +489,175 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
     }
 }
+
+namespace {
+
+    // Horizontally convolves the source rows BGRAConvolve2D() would, into a full intermediate
+    // image rather than a circular buffer.  Work is split into units: first groups of four
+    // rows (fFourRowGroups of them), then single rows.  Each row goes through the same proc
+    // BGRAConvolve2D() would pick for it, so the results match exactly.
+    class HorizontalPass {
+    public:
+        HorizontalPass(const unsigned char* sourceData, int sourceByteRowStride,
+                       bool sourceHasAlpha, const SkConvolutionFilter1D& filterX,
+                       const SkConvolutionProcs& procs, int firstRow, int lastRow,
+                       int simdLimit, unsigned char* const* rows)
+            : fSourceData(sourceData)
+            , fSourceByteRowStride(sourceByteRowStride)
+            , fSourceHasAlpha(sourceHasAlpha)
+            , fFilterX(filterX)
+            , fProcs(procs)
+            , fFirstRow(firstRow)
+            , fRows(rows) {
+            fFourRowGroups = 0;
+            if (procs.fConvolve4RowsHorizontally) {
+                // BGRAConvolve2D() uses groups of four while nextXRow + 3 < simdLimit.
+                fFourRowGroups = SkTMax(0, (simdLimit - firstRow) / 4);
+            }
+            fSingleRowStart = firstRow + 4 * fFourRowGroups;
+            fSimdLimit = simdLimit;
+            fUnits = fFourRowGroups + (lastRow - fSingleRowStart);
+        }
+
+        int units() const { return fUnits; }
+
+        void operator()(int unit) {
+            if (unit < fFourRowGroups) {
+                const int y = fFirstRow + 4 * unit;
+                const unsigned char* src[4];
+                unsigned char* outRow[4];
+                for (int i = 0; i < 4; ++i) {
+                    src[i] = this->sourceRow(y + i);
+                    outRow[i] = fRows[y + i - fFirstRow];
+                }
+                fProcs.fConvolve4RowsHorizontally(src, fFilterX, outRow);
+                return;
+            }
+
+            const int y = fSingleRowStart + (unit - fFourRowGroups);
+            unsigned char* outRow = fRows[y - fFirstRow];
+            if (fProcs.fConvolveHorizontally && y < fSimdLimit) {
+                fProcs.fConvolveHorizontally(this->sourceRow(y), fFilterX, outRow,
+                                             fSourceHasAlpha);
+            } else if (fSourceHasAlpha) {
+                ConvolveHorizontallyAlpha(this->sourceRow(y), fFilterX, outRow);
+            } else {
+                ConvolveHorizontallyNoAlpha(this->sourceRow(y), fFilterX, outRow);
+            }
+        }
+
+    private:
+        const unsigned char* sourceRow(int y) const {
+            return &fSourceData[(uint64_t)y * fSourceByteRowStride];
+        }
+
+        const unsigned char*         fSourceData;
+        int                          fSourceByteRowStride;
+        bool                         fSourceHasAlpha;
+        const SkConvolutionFilter1D& fFilterX;
+        const SkConvolutionProcs&    fProcs;
+        int                          fFirstRow;
+        unsigned char* const*        fRows;
+        int                          fFourRowGroups;
+        int                          fSingleRowStart;
+        int                          fSimdLimit;
+        int                          fUnits;
+    };
+
+    // Vertically convolves the intermediate image into output row outY.
+    class VerticalPass {
+    public:
+        VerticalPass(bool sourceHasAlpha, const SkConvolutionFilter1D& filterX,
+                     const SkConvolutionFilter1D& filterY, const SkConvolutionProcs& procs,
+                     int firstRow, unsigned char* const* rows,
+                     int outputByteRowStride, unsigned char* output)
+            : fSourceHasAlpha(sourceHasAlpha)
+            , fFilterX(filterX)
+            , fFilterY(filterY)
+            , fProcs(procs)
+            , fFirstRow(firstRow)
+            , fRows(rows)
+            , fOutputByteRowStride(outputByteRowStride)
+            , fOutput(output) {}
+
+        void operator()(int outY) {
+            int filterOffset, filterLength;
+            const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+                fFilterY.FilterForValue(outY, &filterOffset, &filterLength);
+            unsigned char* const* firstRowForFilter = &fRows[filterOffset - fFirstRow];
+            unsigned char* curOutputRow = &fOutput[(uint64_t)outY * fOutputByteRowStride];
+
+            if (fProcs.fConvolveVertically) {
+                fProcs.fConvolveVertically(filterValues, filterLength, firstRowForFilter,
+                                           fFilterX.numValues(), curOutputRow, fSourceHasAlpha);
+            } else {
+                ConvolveVertically(filterValues, filterLength, firstRowForFilter,
+                                   fFilterX.numValues(), curOutputRow, fSourceHasAlpha);
+            }
+        }
+
+    private:
+        bool                         fSourceHasAlpha;
+        const SkConvolutionFilter1D& fFilterX;
+        const SkConvolutionFilter1D& fFilterY;
+        const SkConvolutionProcs&    fProcs;
+        int                          fFirstRow;
+        unsigned char* const*        fRows;
+        int                          fOutputByteRowStride;
+        unsigned char*               fOutput;
+    };
+
+}  // namespace
+
+void BGRAConvolve2DParallel(const unsigned char* sourceData,
+                            int sourceByteRowStride,
+                            bool sourceHasAlpha,
+                            const SkConvolutionFilter1D& filterX,
+                            const SkConvolutionFilter1D& filterY,
+                            int outputByteRowStride,
+                            unsigned char* output,
+                            const SkConvolutionProcs& convolveProcs,
+                            bool useSimdIfPossible) {
+    if (SkTaskGroup::ThreadCount() == 0) {
+        // No threads to share the work with, so save the memory for the intermediate image.
+        BGRAConvolve2D(sourceData, sourceByteRowStride, sourceHasAlpha, filterX, filterY,
+                       outputByteRowStride, output, convolveProcs, useSimdIfPossible);
+        return;
+    }
+    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
+
+    // These are the same source rows, and SIMD limits, that BGRAConvolve2D() works out.
+    int filterOffset, filterLength;
+    filterY.FilterForValue(0, &filterOffset, &filterLength);
+    const int firstRow = filterOffset;
+
+    int lastFilterOffset, lastFilterLength;
+    filterX.FilterForValue(filterX.numValues() - 1, &lastFilterOffset, &lastFilterLength);
+    const int avoidSimdRows = 1 + convolveProcs.fExtraHorizontalReads /
+        (lastFilterOffset + lastFilterLength);
+
+    filterY.FilterForValue(filterY.numValues() - 1, &lastFilterOffset, &lastFilterLength);
+    const int lastRow = lastFilterOffset + lastFilterLength;
+    const int simdLimit = lastRow - avoidSimdRows;
+
+    // Unlike BGRAConvolve2D(), we keep every horizontally convolved row, so that bands of
+    // output rows can be convolved vertically independently.  Rows are padded the same way.
+    const int numRows = SkTMax(lastRow - firstRow, 0);
+    const size_t rowBytes = ((filterX.numValues() + 15) & ~0xF) * 4;
+    SkAutoTMalloc<unsigned char> intermediate(numRows * rowBytes);
+    SkAutoTMalloc<unsigned char*> rows(numRows);
+    for (int i = 0; i < numRows; i++) {
+        rows[i] = intermediate.get() + i * rowBytes;
+    }
+
+    // A band of about 16 rows is plenty of work to hand to another thread.
+    static const int kRowsPerBand = 16;
+
+    HorizontalPass horizontal(sourceData, sourceByteRowStride, sourceHasAlpha, filterX,
+                              convolveProcs, firstRow, lastRow, simdLimit, rows.get());
+    sk_parallel_for(horizontal.units(), kRowsPerBand / 4, horizontal);
+
+    VerticalPass vertical(sourceHasAlpha, filterX, filterY, convolveProcs, firstRow, rows.get(),
+                          outputByteRowStride, output);
+    sk_parallel_for(filterY.numValues(), kRowsPerBand, vertical);
+}
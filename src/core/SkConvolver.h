@@ -202,4 +202,19 @@ SK_API void BGRAConvolve2D(const unsigned char* sourceData,
     const SkConvolutionProcs&,
     bool useSimdIfPossible);
 
+// Same as BGRAConvolve2D(), with bit-identical results, but splits both passes into bands of
+// rows that run on SkTaskGroup threads.  This needs memory for the whole horizontally
+// convolved image (source rows used * xfilter.numValues() * 4 bytes), where BGRAConvolve2D()
+// only keeps a few rows at a time.  If there are no SkTaskGroup threads, this just calls
+// BGRAConvolve2D().
+SK_API void BGRAConvolve2DParallel(const unsigned char* sourceData,
+    int sourceByteRowStride,
+    bool sourceHasAlpha,
+    const SkConvolutionFilter1D& xfilter,
+    const SkConvolutionFilter1D& yfilter,
+    int outputByteRowStride,
+    unsigned char* output,
+    const SkConvolutionProcs&,
+    bool useSimdIfPossible);
+
 #endif  // SK_CONVOLVER_H
@@ -16,6 +16,7 @@
 #include "SkPath.h"
 #include "SkTemplates.h"
 #include "SkTLS.h"
+#include "SkTSort.h"
 #include "SkTypeface.h"
 
 //#define SPEW_PURGE_STATUS
@@ -80,6 +81,10 @@ SkGlyphCache::SkGlyphCache(SkTypeface* typeface, const SkDescriptor* desc, SkSca
     SkASSERT(ctx);
 
     fPrev = fNext = NULL;
+    fState = kInUse_State;
+    fLastUsed = 0;
+    fMemoryAccounted = 0;
+    fOwner = NULL;
 
     fDesc = desc->copy();
     fScalerContext->getFontMetrics(&fFontMetrics);
@@ -487,11 +492,8 @@ void SkGlyphCache_Globals::purgeAll() {
     this->internalPurge(fTotalMemoryUsed);
 }
 
-/*  This guy calls the visitor from within the mutext lock, so the visitor
-    cannot:
-    - take too much time
-    - try to acquire the mutext again
-    - call a fontscaler (which might call into the cache)
+/*  The visitor is called with the strike in use by this thread, but outside of
+    any lock, so it may take its time. It must not try to reattach the strike.
 */
 SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
                               const SkDescriptor* desc,
@@ -503,29 +505,12 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     SkASSERT(desc);
 
     SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
-    SkGlyphCache*         cache;
-    bool                  insideMutex = true;
+    SkGlyphCache* cache = globals.acquireCache(*desc);
 
-    globals.validate();
-
-    for (cache = globals.internalGetHead(); cache != NULL; cache = cache->fNext) {
-        if (cache->fDesc->equals(*desc)) {
-            globals.internalDetachCache(cache);
-            goto FOUND_IT;
-        }
-    }
-
-    /* Release the mutex now, before we create a new entry (which might have
-        side-effects like trying to access the cache/mutex (yikes!)
-    */
-    ac.release();           // release the mutex now
-    insideMutex = false;    // can't use globals anymore
-
-    // Check if we can create a scaler-context before creating the glyphcache.
-    // If not, we may have exhausted OS/font resources, so try purging the
-    // cache once and try again.
-    {
+    if (NULL == cache) {
+        // Check if we can create a scaler-context before creating the glyphcache.
+        // If not, we may have exhausted OS/font resources, so try purging the
+        // cache once and try again.
         // pass true the first time, to notice if the scalercontext failed,
         // so we can try the purge.
         SkScalerContext* ctx = typeface->createScalerContext(desc, true);
@@ -535,18 +520,13 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
             SkASSERT(ctx);
         }
         cache = SkNEW_ARGS(SkGlyphCache, (typeface, desc, ctx));
+        globals.addCache(cache);
     }
 
-FOUND_IT:
-
     AutoValidate av(cache);
 
     if (!proc(cache, context)) {   // need to reattach
-        if (insideMutex) {
-            globals.internalAttachCacheToHead(cache);
-        } else {
-            globals.attachCacheToHead(cache);
-        }
+        globals.releaseCache(cache);
         cache = NULL;
     }
     return cache;
@@ -554,33 +534,189 @@ FOUND_IT:
 
 void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
-    SkASSERT(cache->fNext == NULL);
+    SkASSERT(cache->fOwner);
 
-    getGlobals().attachCacheToHead(cache);
+    cache->fOwner->releaseCache(cache);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
+SkGlyphCache_Globals::~SkGlyphCache_Globals() {
+    SkGlyphCache* cache = fHead;
+    while (cache) {
+        SkGlyphCache* next = cache->fNext;
+        SkDELETE(cache);
+        cache = next;
+    }
+
+    SkASSERT(0 == fReaders);
+    this->internalFreeRetired();
+    if (fSnapshot) {
+        Snapshot::Free(fSnapshot);
+    }
+
+    SkDELETE(fMutex);
+}
+
+namespace {
+
+struct ChecksumLT {
+    bool operator()(const SkGlyphCache* a, const SkGlyphCache* b) const {
+        return a->getDescriptor().getChecksum() < b->getDescriptor().getChecksum();
+    }
+};
+
+}  // namespace
+
+SkGlyphCache_Globals::Snapshot* SkGlyphCache_Globals::Snapshot::Create(SkGlyphCache* head,
+                                                                       int count) {
+    size_t size = sizeof(Snapshot) + SkTMax(count - 1, 0) * sizeof(SkGlyphCache*);
+    Snapshot* snapshot = (Snapshot*)sk_malloc_throw(size);
+    snapshot->fNextRetired = NULL;
+    snapshot->fCount = count;
+
+    int i = 0;
+    for (SkGlyphCache* cache = head; cache != NULL; cache = cache->fNext) {
+        snapshot->fCaches[i++] = cache;
+    }
+    SkASSERT(i == count);
+    SkTQSort(snapshot->fCaches, snapshot->fCaches + count - 1, ChecksumLT());
+    return snapshot;
+}
+
+SkGlyphCache* SkGlyphCache_Globals::acquireCache(const SkDescriptor& desc) {
+    sk_atomic_inc(&fReaders);   // Full barrier, pairs with the one in internalFreeRetired().
+
+    SkGlyphCache* found = NULL;
+    const Snapshot* snapshot = sk_acquire_load(&fSnapshot);
+    if (snapshot) {
+        const uint32_t checksum = desc.getChecksum();
+        SkGlyphCache* const* caches = snapshot->fCaches;
+
+        // find the first strike with our checksum
+        int lo = 0;
+        int hi = snapshot->fCount;
+        while (lo < hi) {
+            int mid = (hi + lo) >> 1;
+            if (caches[mid]->fDesc->getChecksum() < checksum) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        // There may be several strikes for desc; take the first one nobody is using.
+        for (int i = lo; i < snapshot->fCount; ++i) {
+            SkGlyphCache* cache = caches[i];
+            if (cache->fDesc->getChecksum() != checksum) {
+                break;
+            }
+            if (cache->fDesc->equals(desc) &&
+                sk_atomic_cas(&cache->fState, SkGlyphCache::kFree_State,
+                              SkGlyphCache::kInUse_State)) {
+                // Pairs with the release in releaseCache(), so we see the last user's writes.
+                (void)sk_acquire_load(&cache->fState);
+                found = cache;
+                break;
+            }
+        }
+    }
+
+    sk_atomic_dec(&fReaders);
+    return found;
+}
+
+void SkGlyphCache_Globals::addCache(SkGlyphCache* cache) {
+    SkASSERT(NULL == cache->fOwner);
+    SkASSERT(NULL == cache->fPrev && NULL == cache->fNext);
+    SkASSERT(SkGlyphCache::kInUse_State == cache->fState);
+
     SkAutoMutexAcquire    ac(fMutex);
 
     this->validate();
+
+    cache->fOwner = this;
+    cache->fMemoryAccounted = cache->fMemoryUsed;
+    if (fHead) {
+        fHead->fPrev = cache;
+        cache->fNext = fHead;
+    }
+    fHead = cache;
+
+    fCacheCount += 1;
+    fTotalMemoryUsed += cache->fMemoryAccounted;
+    sk_release_store(&fClock, fClock + 1);
+
+    this->internalPublishSnapshot();
+    this->internalPurge();
+}
+
+void SkGlyphCache_Globals::releaseCache(SkGlyphCache* cache) {
+    SkASSERT(this == cache->fOwner);
+    SkASSERT(SkGlyphCache::kInUse_State == cache->fState);
     cache->validate();
 
-    this->internalAttachCacheToHead(cache);
+    sk_release_store(&cache->fLastUsed, sk_acquire_load(&fClock));
+
+    if (cache->fMemoryUsed == cache->fMemoryAccounted) {
+        // Nothing new to account for, so we can skip the mutex.
+        sk_release_store(&cache->fState, (int32_t)SkGlyphCache::kFree_State);
+        return;
+    }
+
+    SkAutoMutexAcquire    ac(fMutex);
+
+    fTotalMemoryUsed += cache->fMemoryUsed - cache->fMemoryAccounted;
+    cache->fMemoryAccounted = cache->fMemoryUsed;
+    sk_release_store(&cache->fState, (int32_t)SkGlyphCache::kFree_State);
+
     this->internalPurge();
 }
 
-SkGlyphCache* SkGlyphCache_Globals::internalGetTail() const {
-    SkGlyphCache* cache = fHead;
-    if (cache) {
-        while (cache->fNext) {
-            cache = cache->fNext;
-        }
+void SkGlyphCache_Globals::internalPublishSnapshot() {
+    Snapshot* prev = fSnapshot;
+    sk_release_store(&fSnapshot, Snapshot::Create(fHead, fCacheCount));
+    if (prev) {
+        prev->fNextRetired = fRetiredSnapshots;
+        fRetiredSnapshots = prev;
+    }
+    this->internalFreeRetired();
+}
+
+void SkGlyphCache_Globals::internalFreeRetired() {
+    if (NULL == fRetiredSnapshots && NULL == fRetiredCaches) {
+        return;
+    }
+    // A full barrier, pairing with the one in acquireCache(): any reader that has not yet
+    // counted itself in fReaders will see our latest fSnapshot, which holds nothing retired.
+    // If there are readers still at work, we leave the retired list for next time.
+    if (sk_atomic_add(&fReaders, 0) > 0) {
+        return;
+    }
+
+    while (fRetiredSnapshots) {
+        Snapshot* next = fRetiredSnapshots->fNextRetired;
+        Snapshot::Free(fRetiredSnapshots);
+        fRetiredSnapshots = next;
+    }
+    while (fRetiredCaches) {
+        SkGlyphCache* next = fRetiredCaches->fNext;
+        SkDELETE(fRetiredCaches);
+        fRetiredCaches = next;
     }
-    return cache;
 }
 
+namespace {
+
+struct PurgeCandidate {
+    uint32_t      fLastUsed;
+    SkGlyphCache* fCache;
+
+    bool operator<(const PurgeCandidate& other) const { return fLastUsed < other.fLastUsed; }
+};
+
+}  // namespace
+
 size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
     this->validate();
 
@@ -606,21 +742,53 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
         return 0;
     }
 
+    // Gather the strikes nobody is using, least recently used first. Their fLastUsed can
+    // change under us, so we sort a copy.
+    SkTDArray<PurgeCandidate> candidates;
+    for (SkGlyphCache* cache = fHead; cache != NULL; cache = cache->fNext) {
+        if (SkGlyphCache::kFree_State == sk_acquire_load(&cache->fState)) {
+            PurgeCandidate* candidate = candidates.append();
+            candidate->fLastUsed = sk_acquire_load(&cache->fLastUsed);
+            candidate->fCache = cache;
+        }
+    }
+    if (candidates.count() > 1) {
+        SkTQSort(candidates.begin(), candidates.end() - 1);
+    }
+
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // we start at the tail and proceed backwards, as the linklist is in LRU
-    // order, with unimportant entries at the tail.
-    SkGlyphCache* cache = this->internalGetTail();
-    while (cache != NULL &&
-           (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        SkGlyphCache* prev = cache->fPrev;
-        bytesFreed += cache->fMemoryUsed;
+    for (int i = 0; i < candidates.count() &&
+                    (bytesFreed < bytesNeeded || countFreed < countNeeded); ++i) {
+        SkGlyphCache* cache = candidates[i].fCache;
+        if (!sk_atomic_cas(&cache->fState, SkGlyphCache::kFree_State,
+                           SkGlyphCache::kDead_State)) {
+            continue;   // someone just acquired it
+        }
+        bytesFreed += cache->fMemoryAccounted;
         countFreed += 1;
 
-        this->internalDetachCache(cache);
-        SkDELETE(cache);
-        cache = prev;
+        SkASSERT(fCacheCount > 0);
+        fCacheCount -= 1;
+        fTotalMemoryUsed -= cache->fMemoryAccounted;
+
+        if (cache->fPrev) {
+            cache->fPrev->fNext = cache->fNext;
+        } else {
+            fHead = cache->fNext;
+        }
+        if (cache->fNext) {
+            cache->fNext->fPrev = cache->fPrev;
+        }
+        // Readers may still find it in the current snapshot, so we can't delete it yet.
+        cache->fPrev = NULL;
+        cache->fNext = fRetiredCaches;
+        fRetiredCaches = cache;
+    }
+
+    if (countFreed) {
+        this->internalPublishSnapshot();
     }
 
     this->validate();
@@ -635,34 +803,6 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkGlyphCache_Globals::internalAttachCacheToHead(SkGlyphCache* cache) {
-    SkASSERT(NULL == cache->fPrev && NULL == cache->fNext);
-    if (fHead) {
-        fHead->fPrev = cache;
-        cache->fNext = fHead;
-    }
-    fHead = cache;
-
-    fCacheCount += 1;
-    fTotalMemoryUsed += cache->fMemoryUsed;
-}
-
-void SkGlyphCache_Globals::internalDetachCache(SkGlyphCache* cache) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= cache->fMemoryUsed;
-
-    if (cache->fPrev) {
-        cache->fPrev->fNext = cache->fNext;
-    } else {
-        fHead = cache->fNext;
-    }
-    if (cache->fNext) {
-        cache->fNext->fPrev = cache->fPrev;
-    }
-    cache->fPrev = cache->fNext = NULL;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -690,7 +830,8 @@ void SkGlyphCache_Globals::validate() const {
 
     const SkGlyphCache* head = fHead;
     while (head != NULL) {
-        computedBytes += head->fMemoryUsed;
+        SkASSERT(this == head->fOwner);
+        computedBytes += head->fMemoryAccounted;
         computedCount += 1;
         head = head->fNext;
     }
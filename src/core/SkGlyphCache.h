@@ -32,7 +32,9 @@ class SkGlyphCache_Globals;
     adding it to the strike.
 
     The strikes are held in a global list, available to all threads. To interact
-    with one, call either VisitCache() or DetachCache().
+    with one, call either VisitCache() or DetachCache(). A strike is only ever
+    used by one thread at a time, but it stays in the global list while in use,
+    so handing it out and taking it back normally needs no lock.
 */
 class SkGlyphCache {
 public:
@@ -130,8 +132,9 @@ public:
                                     void* context);
 
     /** Given a strike that was returned by either VisitCache() or DetachCache()
-        add it back into the global cache list (after which the caller should
-        not reference it anymore.
+        hand it back to the global cache (after which the caller should
+        not reference it anymore). This takes no lock unless the strike grew
+        (new glyphs, images or paths) while it was detached.
     */
     static void AttachCache(SkGlyphCache*);
 
@@ -142,7 +145,8 @@ public:
         a different strike will be generated. This is fine. It does mean we
         can have more than 1 strike for the same descriptor, but that will
         eventually get purged, and the win is that different thread will never
-        block each other while a strike is being used.
+        block each other while a strike is being used. Finding and detaching
+        an existing strike is lock-free.
     */
     static SkGlyphCache* DetachCache(SkTypeface* typeface,
                                      const SkDescriptor* desc) {
@@ -188,6 +192,18 @@ private:
     static bool DetachProc(const SkGlyphCache*, void*) { return true; }
 
     SkGlyphCache*       fNext, *fPrev;
+
+    // How SkGlyphCache_Globals hands this strike to one thread at a time without a lock.
+    enum State {
+        kFree_State,    // waiting in the globals to be acquired
+        kInUse_State,   // held by exactly one thread
+        kDead_State     // purged, deleted once no thread can still be looking at it
+    };
+    int32_t               fState;           // changed atomically
+    uint32_t              fLastUsed;        // fOwner's clock when last released
+    size_t                fMemoryAccounted; // how much of fMemoryUsed fOwner has counted
+    SkGlyphCache_Globals* fOwner;           // set when added to a globals list
+
     SkDescriptor*       fDesc;
     SkScalerContext*    fScalerContext;
     SkPaint::FontMetrics fFontMetrics;
@@ -225,8 +241,6 @@ private:
     AuxProcRec* fAuxProcList;
     void invokeAndRemoveAuxProcs();
 
-    inline static SkGlyphCache* FindTail(SkGlyphCache* head);
-
     friend class SkGlyphCache_Globals;
 };
 
@@ -23,6 +23,19 @@
 
 class SkMutex;
 
+/**
+ *  The list of strikes for either the whole process or a single thread.
+ *
+ *  Strikes stay in this list while a thread is using them; a strike's fState says whether it is
+ *  free to be acquired.  Finding and acquiring a strike takes no lock: readers search an immutable
+ *  Snapshot of the list, sorted by descriptor checksum, and claim a free strike with a CAS.
+ *  Releasing a strike is also lock-free, unless it grew while in use, in which case we take
+ *  fMutex to account for its new size and purge if that puts us over budget.
+ *
+ *  Adding and purging strikes happen under fMutex and publish a new Snapshot.  Purged strikes and
+ *  replaced Snapshots may still be seen by readers, so they are only deleted once no reader is
+ *  inside acquireCache().
+ */
 class SkGlyphCache_Globals {
 public:
     enum UseMutex {
@@ -37,24 +50,20 @@ public:
         fCacheCount = 0;
         fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
 
+        fSnapshot = NULL;
+        fReaders = 0;
+        fClock = 0;
+        fRetiredSnapshots = NULL;
+        fRetiredCaches = NULL;
+
         fMutex = (kYes_UseMutex == um) ? SkNEW(SkMutex) : NULL;
     }
 
-    ~SkGlyphCache_Globals() {
-        SkGlyphCache* cache = fHead;
-        while (cache) {
-            SkGlyphCache* next = cache->fNext;
-            SkDELETE(cache);
-            cache = next;
-        }
-
-        SkDELETE(fMutex);
-    }
+    ~SkGlyphCache_Globals();
 
     SkMutex*        fMutex;
 
     SkGlyphCache* internalGetHead() const { return fHead; }
-    SkGlyphCache* internalGetTail() const;
 
     size_t getTotalMemoryUsed() const { return fTotalMemoryUsed; }
     int getCacheCountUsed() const { return fCacheCount; }
@@ -78,14 +87,17 @@ public:
                fTotalMemoryUsed > fCacheSizeLimit;
     }
 
-    void purgeAll(); // does not change budget
+    void purgeAll(); // does not change budget; strikes in use are not purged
 
-    // call when a glyphcache is available for caching (i.e. not in use)
-    void attachCacheToHead(SkGlyphCache*);
+    // Returns a strike matching desc that no other thread is using, now in use by the caller,
+    // or NULL if there is none.  Lock-free.
+    SkGlyphCache* acquireCache(const SkDescriptor& desc);
 
-    // can only be called when the mutex is already held
-    void internalDetachCache(SkGlyphCache*);
-    void internalAttachCacheToHead(SkGlyphCache*);
+    // Adds a newly created strike to the list.  It stays in use by the caller.
+    void addCache(SkGlyphCache*);
+
+    // Call when done with a strike from acquireCache() or addCache().
+    void releaseCache(SkGlyphCache*);
 
     // can return NULL
     static SkGlyphCache_Globals* FindTLS() {
@@ -99,17 +111,38 @@ public:
     static void DeleteTLS() { SkTLS::Delete(CreateTLS); }
 
 private:
+    // All the strikes in the list, sorted by descriptor checksum.  Never changes once published.
+    struct Snapshot {
+        Snapshot*     fNextRetired;
+        int           fCount;
+        SkGlyphCache* fCaches[1];   // really fCount long
+
+        static Snapshot* Create(SkGlyphCache* head, int count);
+        static void Free(Snapshot* snapshot) { sk_free(snapshot); }
+    };
+
+    // Everything below is guarded by fMutex, except as noted.
     SkGlyphCache* fHead;
     size_t  fTotalMemoryUsed;
     size_t  fCacheSizeLimit;
     int32_t fCacheCountLimit;
     int32_t fCacheCount;
 
+    Snapshot*     fSnapshot;            // Read by acquireCache() without fMutex.
+    int32_t       fReaders;             // Threads in acquireCache(); changed atomically.
+    uint32_t      fClock;               // Ticks on each add; read by releaseCache() for LRU.
+    Snapshot*     fRetiredSnapshots;    // Replaced, to be freed when fReaders is 0.
+    SkGlyphCache* fRetiredCaches;       // Purged, to be deleted when fReaders is 0.
+
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
     // Returns number of bytes freed.
     size_t internalPurge(size_t minBytesNeeded = 0);
 
+    // can only be called when the mutex is already held
+    void internalPublishSnapshot();
+    void internalFreeRetired();
+
     static void* CreateTLS() {
         return SkNEW_ARGS(SkGlyphCache_Globals, (kNo_UseMutex));
     }
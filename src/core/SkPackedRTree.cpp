@@ -0,0 +1,233 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPackedRTree.h"
+#include "SkTSort.h"
+
+// Our Hilbert curve fills a 2^16 x 2^16 grid, so distances along it fit in 32 bits.
+static const int kHilbertBits = 16;
+
+// Distance along the Hilbert curve to (x, y), both in [0, 2^kHilbertBits).
+static uint32_t hilbert_distance(uint32_t x, uint32_t y) {
+    const uint32_t n = 1 << kHilbertBits;
+    uint32_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        const uint32_t rx = (x & s) ? 1 : 0,
+                       ry = (y & s) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve's sub-curves line up.
+        if (0 == ry) {
+            if (1 == rx) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            SkTSwap(x, y);
+        }
+    }
+    return d;
+}
+
+// Maps v from [min, max] to [0, 2^kHilbertBits), clamping.
+static uint32_t to_grid(SkScalar v, SkScalar min, SkScalar max) {
+    const SkScalar kMax = SkIntToScalar((1 << kHilbertBits) - 1);
+    const SkScalar scaled = (v - min) * kMax / (max - min);
+    return SkScalarFloorToInt(SkScalarPin(scaled, 0, kMax));
+}
+
+SkPackedRTree::SkPackedRTree(SkScalar width, SkScalar height, Order order)
+    : fDomain(SkRect::MakeWH(width, height))
+    , fOrder(order) {}
+
+void SkPackedRTree::reserve(unsigned opCount) {
+    fDeferred.setReserve(opCount);
+}
+
+void SkPackedRTree::insert(unsigned opIndex, const SkRect& bounds, bool defer) {
+    if (bounds.isEmpty()) {
+        // Nothing can intersect it.
+        return;
+    }
+    Item* item = fDeferred.append();
+    item->fBounds = bounds;
+    item->fOpIndex = opIndex;
+    if (!defer) {
+        this->build();
+    }
+}
+
+void SkPackedRTree::flushDeferredInserts() {
+    if (!fDeferred.isEmpty()) {
+        this->build();
+    }
+}
+
+bool SkPackedRTree::HilbertLessThan(const Item& a, const Item& b) {
+    // Ties (e.g. identical bounds) keep their opIndex order.
+    return a.fKey < b.fKey || (a.fKey == b.fKey && a.fOpIndex < b.fOpIndex);
+}
+
+bool SkPackedRTree::OpIndexLessThan(const Item& a, const Item& b) {
+    return a.fOpIndex < b.fOpIndex;
+}
+
+void SkPackedRTree::build() {
+    // Anything already in the tree goes back in, ahead of what's been inserted since.
+    if (!fLevels.isEmpty()) {
+        const Level& bottom = fLevels[0];
+        Item* items = fDeferred.insert(0, bottom.fCount);
+        for (int i = 0; i < bottom.fCount; i++) {
+            items[i].fBounds.setLTRB(bottom.fLeft[i], bottom.fTop[i],
+                                     bottom.fRight[i], bottom.fBottom[i]);
+            items[i].fOpIndex = fOpIndices[i];
+        }
+        fLevels.rewind();
+    }
+
+    const int count = fDeferred.count();
+    if (0 == count) {
+        return;
+    }
+
+    if (kHilbert_Order == fOrder) {
+        SkRect domain = fDomain;
+        if (domain.isEmpty()) {
+            domain.setLTRB(fDeferred[0].fBounds.centerX(), fDeferred[0].fBounds.centerY(),
+                           fDeferred[0].fBounds.centerX(), fDeferred[0].fBounds.centerY());
+            for (int i = 1; i < count; i++) {
+                domain.growToInclude(fDeferred[i].fBounds.centerX(),
+                                     fDeferred[i].fBounds.centerY());
+            }
+            domain.outset(1, 1);
+        }
+        for (int i = 0; i < count; i++) {
+            const SkRect& b = fDeferred[i].fBounds;
+            fDeferred[i].fKey = hilbert_distance(to_grid(b.centerX(), domain.fLeft, domain.fRight),
+                                                 to_grid(b.centerY(), domain.fTop, domain.fBottom));
+        }
+        SkTQSort(fDeferred.begin(), fDeferred.end() - 1, &HilbertLessThan);
+    } else {
+        // Pictures insert in opIndex order, so we rarely need to sort.
+        for (int i = 1; i < count; i++) {
+            if (fDeferred[i].fOpIndex < fDeferred[i - 1].fOpIndex) {
+                SkTQSort(fDeferred.begin(), fDeferred.end() - 1, &OpIndexLessThan);
+                break;
+            }
+        }
+    }
+
+    // Size every level: each has a node per kFanout nodes below it, up to a lone root.
+    int total = 0;
+    for (int n = count; ; n = (n + kFanout - 1) / kFanout) {
+        fLevels.append()->fCount = n;
+        total += n;
+        if (1 == n) {
+            break;
+        }
+    }
+    fBounds.reset(4 * total);
+    fOpIndices.reset(count);
+
+    SkScalar* edges = fBounds.get();
+    for (int l = 0; l < fLevels.count(); l++) {
+        Level& level = fLevels[l];
+        SkScalar* left   = edges;
+        SkScalar* top    = left   + level.fCount;
+        SkScalar* right  = top    + level.fCount;
+        SkScalar* bottom = right  + level.fCount;
+        edges = bottom + level.fCount;
+
+        if (0 == l) {
+            for (int i = 0; i < count; i++) {
+                const SkRect& b = fDeferred[i].fBounds;
+                left[i] = b.fLeft;
+                top[i] = b.fTop;
+                right[i] = b.fRight;
+                bottom[i] = b.fBottom;
+                fOpIndices[i] = fDeferred[i].fOpIndex;
+            }
+        } else {
+            const Level& below = fLevels[l - 1];
+            for (int i = 0; i < level.fCount; i++) {
+                const int begin = i * kFanout,
+                          end = SkTMin(begin + kFanout, below.fCount);
+                left[i] = below.fLeft[begin];
+                top[i] = below.fTop[begin];
+                right[i] = below.fRight[begin];
+                bottom[i] = below.fBottom[begin];
+                for (int j = begin + 1; j < end; j++) {
+                    left[i]   = SkTMin(left[i],   below.fLeft[j]);
+                    top[i]    = SkTMin(top[i],    below.fTop[j]);
+                    right[i]  = SkTMax(right[i],  below.fRight[j]);
+                    bottom[i] = SkTMax(bottom[i], below.fBottom[j]);
+                }
+            }
+        }
+
+        level.fLeft = left;
+        level.fTop = top;
+        level.fRight = right;
+        level.fBottom = bottom;
+    }
+
+    fDeferred.reset();
+}
+
+void SkPackedRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
+    SkASSERT(fDeferred.isEmpty());  // Can't search with deferred inserts.
+    if (fLevels.isEmpty() || query.isEmpty()) {
+        return;
+    }
+    const int first = results->count();
+    this->search(fLevels.count() - 1, 0, 1, query, results);
+
+    // Hilbert order isn't draw order.
+    if (kHilbert_Order == fOrder && results->count() - first > 1) {
+        SkTQSort(results->begin() + first, results->end() - 1);
+    }
+}
+
+static inline bool intersects(const SkScalar left[], const SkScalar top[],
+                              const SkScalar right[], const SkScalar bottom[], int i,
+                              const SkRect& query) {
+    // Non-short-circuiting &, so there's no branch to mispredict.
+    return (left[i] < query.fRight) & (query.fLeft < right[i]) &
+           (top[i] < query.fBottom) & (query.fTop < bottom[i]);
+}
+
+void SkPackedRTree::search(int l, int begin, int end, const SkRect& query,
+                           SkTDArray<unsigned>* results) const {
+    const Level& level = fLevels[l];
+    if (0 == l) {
+        // Write every opIndex, but only advance past those that intersect.
+        const int first = results->count();
+        unsigned* hits = results->append(end - begin);
+        int count = 0;
+        for (int i = begin; i < end; i++) {
+            hits[count] = fOpIndices[i];
+            count += intersects(level.fLeft, level.fTop, level.fRight, level.fBottom, i, query);
+        }
+        results->setCount(first + count);
+        return;
+    }
+    for (int i = begin; i < end; i++) {
+        if (intersects(level.fLeft, level.fTop, level.fRight, level.fBottom, i, query)) {
+            const int childBegin = i * kFanout;
+            this->search(l - 1, childBegin, SkTMin(childBegin + kFanout, fLevels[l - 1].fCount),
+                         query, results);
+        }
+    }
+}
+
+size_t SkPackedRTree::bytesUsed() const {
+    int total = 0;
+    for (int l = 0; l < fLevels.count(); l++) {
+        total += fLevels[l].fCount;
+    }
+    return 4 * total * sizeof(SkScalar)
+         + this->getCount() * sizeof(unsigned)
+         + fLevels.count() * sizeof(Level);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedRTree_DEFINED
+#define SkPackedRTree_DEFINED
+
+#include "SkBBoxHierarchy.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+/**
+ * A read-only R-Tree, bulk-loaded once and then only searched, as a picture's BBH is.
+ *
+ * Rather than nodes allocated and linked as in SkRTree, it packs each level of the tree into
+ * arrays.  Every node has kFanout children (but the last on each level), so a node's children
+ * are found by index alone: node i's children are [i * kFanout, (i + 1) * kFanout) on the level
+ * below.  Each level holds its bounds as four contiguous float arrays, one per edge, so testing
+ * a node's children against a query reads a few cache lines and vectorizes well.  The bottom
+ * level holds the inserted bounds themselves, alongside an array of their opIndex.
+ *
+ * With kHilbert_Order, the tree is built over the bounds sorted by where their centers fall
+ * along a Hilbert curve, which keeps nearby bounds together in each node.  search() then sorts
+ * what it finds.  With kOpIndex_Order, the tree is built over the bounds sorted by opIndex,
+ * which is draw order and already roughly spatial for most pictures, so results come out sorted.
+ * Sorting results usually costs more than the tighter Hilbert nodes save, so that's the default.
+ *
+ * All insertions should be deferred and followed by flushDeferredInserts(), which builds the
+ * tree.  A non-deferred insert, or a flush after the tree is built, rebuilds the whole tree.
+ */
+class SkPackedRTree : public SkBBoxHierarchy {
+public:
+    SK_DECLARE_INST_COUNT(SkPackedRTree)
+
+    enum Order {
+        kOpIndex_Order,
+        kHilbert_Order,
+    };
+
+    static const int kFanout = 16;
+
+    /**
+     * Bounds are expected to lie mostly within (0, 0, width, height), which only affects how
+     * well kHilbert_Order sorts them.
+     */
+    SkPackedRTree(SkScalar width, SkScalar height, Order order = kOpIndex_Order);
+
+    virtual void reserve(unsigned opCount) SK_OVERRIDE;
+    virtual void insert(unsigned opIndex, const SkRect& bounds, bool defer = false) SK_OVERRIDE;
+    virtual void flushDeferredInserts() SK_OVERRIDE;
+    virtual void search(const SkRect& query, SkTDArray<unsigned>* results) const SK_OVERRIDE;
+
+    // Number of levels in the tree, including the bottom one, or 0 if empty.
+    int getDepth() const { return fLevels.count(); }
+    // Number of bounds in the tree.  Empty bounds are never inserted.
+    int getCount() const { return fLevels.isEmpty() ? 0 : fLevels[0].fCount; }
+    // Bytes held by the built tree.
+    size_t bytesUsed() const;
+
+private:
+    struct Item {
+        SkRect   fBounds;
+        unsigned fOpIndex;
+        uint32_t fKey;  // Hilbert distance of fBounds' center, if sorting.
+    };
+
+    struct Level {
+        int fCount;
+        const SkScalar* fLeft;
+        const SkScalar* fTop;
+        const SkScalar* fRight;
+        const SkScalar* fBottom;
+    };
+
+    static bool HilbertLessThan(const Item&, const Item&);
+    static bool OpIndexLessThan(const Item&, const Item&);
+
+    void build();
+    void search(int level, int begin, int end, const SkRect& query,
+                SkTDArray<unsigned>* results) const;
+
+    const SkRect fDomain;
+    const Order  fOrder;
+
+    SkTDArray<Item> fDeferred;
+
+    SkAutoTMalloc<SkScalar> fBounds;     // Edges of every level, each level's fLeft first.
+    SkAutoTMalloc<unsigned> fOpIndices;  // Parallel to fLevels[0].
+    SkTDArray<Level>        fLevels;     // fLevels[0] is the bottom; fLevels.top() the root.
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
@@ -37,6 +37,7 @@
 #endif
 
 #include "SkRecord.h"
+#include "SkRecordCompare.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
 #include "SkRecorder.h"
@@ -50,7 +51,7 @@ template <typename T> int SafeCount(const T* obj) {
 namespace {
 
 // Some commands have a paint, some have an optional paint.  Either way, get back a pointer.
-static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+static const SkPaint* AsPtr(const SkRecords::SharedPaint& p) { return p.get(); }
 static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
 
 /** SkRecords visitor to determine whether an instance may require an
@@ -65,6 +66,7 @@ struct BitmapTester {
     SK_CREATE_MEMBER_DETECTOR(bitmap);
     SK_CREATE_MEMBER_DETECTOR(paint);
 
+    BitmapTester() : fLastPaint(NULL) {}
 
     // Main entry for visitor:
     // If the command is a DrawPicture, recurse.
@@ -74,21 +76,27 @@ struct BitmapTester {
     bool operator()(const SkRecords::DrawPicture& op) { return op.picture->willPlayBackBitmaps(); }
 
     template <typename T>
-    bool operator()(const T& r) { return CheckBitmap(r); }
+    bool operator()(const T& r) { return this->checkBitmap(r); }
 
 
     // If the command has a bitmap, of course we're going to play back bitmaps.
     template <typename T>
-    static SK_WHEN(HasMember_bitmap<T>, bool) CheckBitmap(const T&) { return true; }
+    SK_WHEN(HasMember_bitmap<T>, bool) checkBitmap(const T&) { return true; }
 
     // If not, look for one in its paint (if it has a paint).
     template <typename T>
-    static SK_WHEN(!HasMember_bitmap<T>, bool) CheckBitmap(const T& r) { return CheckPaint(r); }
+    SK_WHEN(!HasMember_bitmap<T>, bool) checkBitmap(const T& r) { return this->checkPaint(r); }
 
     // If we have a paint, dig down into the effects looking for a bitmap.
     template <typename T>
-    static SK_WHEN(HasMember_paint<T>, bool) CheckPaint(const T& r) {
+    SK_WHEN(HasMember_paint<T>, bool) checkPaint(const T& r) {
         const SkPaint* paint = AsPtr(r.paint);
+        if (paint == fLastPaint) {
+            // Paints are interned, so runs of ops sharing a paint share this pointer.
+            // We'd have returned true last time if it had a bitmap.
+            return false;
+        }
+        fLastPaint = paint;
         if (paint) {
             const SkShader* shader = paint->getShader();
             if (shader &&
@@ -101,7 +109,9 @@ struct BitmapTester {
 
     // If we don't have a paint, that non-paint has no bitmap.
     template <typename T>
-    static SK_WHEN(!HasMember_paint<T>, bool) CheckPaint(const T&) { return false; }
+    SK_WHEN(!HasMember_paint<T>, bool) checkPaint(const T&) { return false; }
+
+    const SkPaint* fLastPaint;
 };
 
 bool WillPlaybackBitmaps(const SkRecord& record) {
@@ -135,11 +145,13 @@ struct SkPicture::PathCounter {
         : numPaintWithPathEffectUses (0)
         , numFastPathDashEffects (0)
         , numAAConcavePaths (0)
-        , numAAHairlineConcavePaths (0) {
+        , numAAHairlineConcavePaths (0)
+        , numPictures (0) {
     }
 
     // Recurse into nested pictures.
     void operator()(const SkRecords::DrawPicture& op) {
+        numPictures++;
         const SkPicture::Analysis& analysis = op.picture->fAnalysis;
         numPaintWithPathEffectUses += analysis.fNumPaintWithPathEffectUses;
         numFastPathDashEffects     += analysis.fNumFastPathDashEffects;
@@ -154,12 +166,12 @@ struct SkPicture::PathCounter {
     }
 
     void operator()(const SkRecords::DrawPoints& op) {
-        this->checkPaint(&op.paint);
-        const SkPathEffect* effect = op.paint.getPathEffect();
+        this->checkPaint(op.paint.get());
+        const SkPathEffect* effect = op.paint->getPathEffect();
         if (effect) {
             SkPathEffect::DashInfo info;
             SkPathEffect::DashType dashType = effect->asADash(&info);
-            if (2 == op.count && SkPaint::kRound_Cap != op.paint.getStrokeCap() &&
+            if (2 == op.count && SkPaint::kRound_Cap != op.paint->getStrokeCap() &&
                 SkPathEffect::kDash_DashType == dashType && 2 == info.fCount) {
                 numFastPathDashEffects++;
             }
@@ -167,12 +179,12 @@ struct SkPicture::PathCounter {
     }
 
     void operator()(const SkRecords::DrawPath& op) {
-        this->checkPaint(&op.paint);
-        if (op.paint.isAntiAlias() && !op.path.isConvex()) {
+        this->checkPaint(op.paint.get());
+        if (op.paint->isAntiAlias() && !op.path.isConvex()) {
             numAAConcavePaths++;
 
-            if (SkPaint::kStroke_Style == op.paint.getStyle() &&
-                0 == op.paint.getStrokeWidth()) {
+            if (SkPaint::kStroke_Style == op.paint->getStyle() &&
+                0 == op.paint->getStrokeWidth()) {
                 numAAHairlineConcavePaths++;
             }
         }
@@ -190,6 +202,7 @@ struct SkPicture::PathCounter {
     int numFastPathDashEffects;
     int numAAConcavePaths;
     int numAAHairlineConcavePaths;
+    int numPictures;
 };
 
 SkPicture::Analysis::Analysis(const SkRecord& record) {
@@ -203,6 +216,7 @@ SkPicture::Analysis::Analysis(const SkRecord& record) {
     fNumFastPathDashEffects     = counter.numFastPathDashEffects;
     fNumAAConcavePaths          = counter.numAAConcavePaths;
     fNumAAHairlineConcavePaths  = counter.numAAHairlineConcavePaths;
+    fNumPictures                = counter.numPictures;
 
     fHasText = false;
     TextHunter text;
@@ -254,11 +268,12 @@ SkPicture::SkPicture(SkScalar width, SkScalar height,
                      bool deepCopyOps)
     : fCullWidth(width)
     , fCullHeight(height)
+    , fContentHash(0)
     , fAnalysis() {
     this->needsNewGenID();
 
     SkPictInfo info;
-    this->createHeader(&info);
+    CreateHeader(this->cullRect(), &info);
     fData.reset(SkNEW_ARGS(SkPictureData, (record, info, deepCopyOps)));
 }
 
@@ -430,6 +445,7 @@ SkPicture::SkPicture(SkPictureData* data, SkScalar width, SkScalar height)
     : fData(data)
     , fCullWidth(width)
     , fCullHeight(height)
+    , fContentHash(0)
     , fAnalysis() {
     this->needsNewGenID();
 }
@@ -438,6 +454,7 @@ SkPicture* SkPicture::Forwardport(const SkPicture& src) {
     SkAutoTDelete<SkRecord> record(SkNEW(SkRecord));
     SkRecorder canvas(record.get(), src.cullRect().width(), src.cullRect().height());
     src.playback(&canvas);
+    SkRecordOptimize(record.get());
     return SkNEW_ARGS(SkPicture, (src.cullRect().width(), src.cullRect().height(),
                                   record.detach(), NULL/*bbh*/));
 }
@@ -452,6 +469,10 @@ SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc pro
 
     // Check to see if there is a playback to recreate.
     if (stream->readBool()) {
+        if (info.fVersion >= 37 &&
+            stream->skip(SK_PICT_HEADER_PADDING) != SK_PICT_HEADER_PADDING) {
+            return NULL;
+        }
         SkPictureData* data = SkPictureData::CreateFromStream(stream, info, proc);
         if (NULL == data) {
             return NULL;
@@ -463,6 +484,37 @@ SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc pro
     return NULL;
 }
 
+SkPicture* SkPicture::CreateFromData(SkData* data, InstallLazyPixelRefProc proc) {
+    SkMemoryStream stream(data);
+    return CreateFromData(&stream, data, proc);
+}
+
+SkPicture* SkPicture::CreateFromData(SkMemoryStream* stream, SkData* data,
+                                     InstallLazyPixelRefProc proc) {
+    SkPictInfo info;
+
+    if (!InternalOnly_StreamIsSKP(stream, &info)) {
+        return NULL;
+    }
+
+    // Check to see if there is a playback to recreate.
+    if (stream->readBool()) {
+        if (info.fVersion >= 37 &&
+            stream->skip(SK_PICT_HEADER_PADDING) != SK_PICT_HEADER_PADDING) {
+            return NULL;
+        }
+        SkPictureData* pictureData = SkPictureData::CreateFromData(stream, data, info, proc);
+        if (NULL == pictureData) {
+            return NULL;
+        }
+        // Unlike CreateFromStream(), don't Forwardport: that would copy every op into an SkRecord.
+        return SkNEW_ARGS(SkPicture, (pictureData,
+                                      info.fCullRect.width(), info.fCullRect.height()));
+    }
+
+    return NULL;
+}
+
 // fRecord OK
 SkPicture* SkPicture::CreateFromBuffer(SkReadBuffer& buffer) {
     SkPictInfo info;
@@ -485,7 +537,7 @@ SkPicture* SkPicture::CreateFromBuffer(SkReadBuffer& buffer) {
 }
 
 // fRecord OK
-void SkPicture::createHeader(SkPictInfo* info) const {
+void SkPicture::CreateHeader(const SkRect& cullRect, SkPictInfo* info) {
     // Copy magic bytes at the beginning of the header
     SkASSERT(sizeof(kMagic) == 8);
     SkASSERT(sizeof(kMagic) == sizeof(info->fMagic));
@@ -493,7 +545,7 @@ void SkPicture::createHeader(SkPictInfo* info) const {
 
     // Set picture info after magic bytes in the header
     info->fVersion = CURRENT_PICTURE_VERSION;
-    info->fCullRect = this->cullRect();
+    info->fCullRect = cullRect;
     info->fFlags = SkPictInfo::kCrossProcess_Flag;
     // TODO: remove this flag, since we're always float (now)
     info->fFlags |= SkPictInfo::kScalarIsFloat_Flag;
@@ -516,12 +568,14 @@ void SkPicture::serialize(SkWStream* stream, EncodeBitmap encoder) const {
     }
 
     SkPictInfo info;
-    this->createHeader(&info);
+    CreateHeader(this->cullRect(), &info);
     SkASSERT(sizeof(SkPictInfo) == 32);
     stream->write(&info, sizeof(info));
 
     if (data) {
+        static const uint32_t kZero = 0;
         stream->writeBool(true);
+        stream->write(&kZero, SK_PICT_HEADER_PADDING);
         data->serialize(stream, encoder);
     } else {
         stream->writeBool(false);
@@ -541,7 +595,7 @@ void SkPicture::flatten(SkWriteBuffer& buffer) const {
     }
 
     SkPictInfo info;
-    this->createHeader(&info);
+    CreateHeader(this->cullRect(), &info);
     buffer.writeByteArray(&info.fMagic, sizeof(info.fMagic));
     buffer.writeUInt(info.fVersion);
     buffer.writeRect(info.fCullRect);
@@ -616,18 +670,26 @@ uint32_t SkPicture::uniqueID() const {
     return fUniqueID;
 }
 
+uint32_t SkPicture::ContentHash(const SkRecord& record) {
+    return SkTMax<uint32_t>(1, SkRecordHash(record));
+}
 
-static SkRecord* optimized(SkRecord* r) {
-    SkRecordOptimize(r);
-    return r;
+uint32_t SkPicture::contentHash() const {
+    SkASSERT(fRecord.get());
+    // Like fUniqueID, racing threads can only ever store the same value.
+    if (0 == fContentHash) {
+        fContentHash = ContentHash(*fRecord);
+    }
+    return fContentHash;
 }
 
 // fRecord OK
 SkPicture::SkPicture(SkScalar width, SkScalar height, SkRecord* record, SkBBoxHierarchy* bbh)
     : fCullWidth(width)
     , fCullHeight(height)
-    , fRecord(optimized(record))
+    , fRecord(record)
     , fBBH(SkSafeRef(bbh))
+    , fContentHash(0)
     , fAnalysis(*fRecord) {
     // TODO: delay as much of this work until just before first playback?
     if (fBBH.get()) {
@@ -164,7 +164,7 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     size_t size = compute_chunk_size(array, count);
 
     // TODO: write_tag_size should really take a size_t
-    write_tag_size(stream, SK_PICT_FACTORY_TAG, (uint32_t) size);
+    write_tag_size(stream, SK_PICT_FACTORY_TAG, (uint32_t) SkAlign4(size));
     SkDEBUGCODE(size_t start = stream->bytesWritten());
     stream->write32(count);
 
@@ -180,6 +180,10 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     }
 
     SkASSERT(size == (stream->bytesWritten() - start));
+
+    // v37+: pad the chunk, so the ones after it stay 4-byte aligned.
+    static const uint32_t kZero = 0;
+    stream->write(&kZero, SkAlign4(size) - size);
 }
 
 void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
@@ -191,9 +195,16 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     SkTypeface** array = (SkTypeface**)storage.get();
     rec.copyToArray((SkRefCnt**)array);
 
+    // v37+: the typefaces are preceded by their padded length in bytes, so a reader can skip
+    // the padding that keeps the chunks after them 4-byte aligned.
+    SkDynamicMemoryWStream typefaces;
     for (int i = 0; i < count; i++) {
-        array[i]->serialize(stream);
+        array[i]->serialize(&typefaces);
     }
+    typefaces.padToAlign4();
+    SkAutoDataUnref data(typefaces.copyToData());
+    stream->write32(SkToU32(data->size()));
+    stream->write(data->data(), data->size());
 }
 
 void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
@@ -322,10 +333,22 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
 
     switch (tag) {
         case SK_PICT_READER_TAG:
-            SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromStream(stream, size);
-            if (!fOpData) {
-                return false;
+            if (NULL == fOpData) {
+                fOpData = SkData::NewFromStream(stream, size);
+                if (!fOpData) {
+                    return false;
+                }
+            } else {
+                // A later chunk of the ops (v37+), gathered up by finishOpChunks().
+                if (NULL == fOpChunks.get()) {
+                    fOpChunks.reset(SkNEW(SkDynamicMemoryWStream));
+                    fOpChunks->write(fOpData->data(), fOpData->size());
+                }
+                SkAutoDataUnref chunk(SkData::NewFromStream(stream, size));
+                if (!chunk) {
+                    return false;
+                }
+                fOpChunks->write(chunk->data(), chunk->size());
             }
             break;
         case SK_PICT_FACTORY_TAG: {
@@ -342,6 +365,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
 #endif
             fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (size));
+            size_t bytesRead = sizeof(uint32_t);
             for (size_t i = 0; i < size; i++) {
                 SkString str;
                 const size_t len = stream->readPackedUInt();
@@ -350,14 +374,35 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                     return false;
                 }
                 fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
+                bytesRead += SkWStream::SizeOfPackedUInt(len) + len;
+            }
+            if (fInfo.fVersion >= 37) {
+                // The chunk is padded to 4 bytes.
+                const size_t padding = SkAlign4(bytesRead) - bytesRead;
+                if (stream->skip(padding) != padding) {
+                    return false;
+                }
             }
         } break;
         case SK_PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
             const int count = SkToInt(size);
+            SkStream* typefaceStream = stream;
+            SkAutoDataUnref typefaceData;
+            SkAutoTDelete<SkMemoryStream> paddedStream;
+            if (fInfo.fVersion >= 37) {
+                // The typefaces are preceded by their padded length. Reading them from a copy
+                // of exactly that many bytes skips the padding.
+                typefaceData.reset(SkData::NewFromStream(stream, stream->readU32()));
+                if (!typefaceData) {
+                    return false;
+                }
+                paddedStream.reset(SkNEW_ARGS(SkMemoryStream, (typefaceData)));
+                typefaceStream = paddedStream.get();
+            }
             fTFPlayback.setCount(count);
             for (int i = 0; i < count; i++) {
-                SkAutoTUnref<SkTypeface> tf(SkTypeface::Deserialize(stream));
+                SkAutoTUnref<SkTypeface> tf(SkTypeface::Deserialize(typefaceStream));
                 if (!tf.get()) {    // failed to deserialize
                     // fTFPlayback asserts it never has a null, so we plop in
                     // the default here.
@@ -509,6 +554,89 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer,
     return true;    // success
 }
 
+bool SkPictureData::parseDataTag(SkMemoryStream* stream, SkData* data,
+                                 uint32_t tag, uint32_t size,
+                                 SkPicture::InstallLazyPixelRefProc proc) {
+    const size_t offset = stream->getPosition();
+    // SkReader32 needs 4-byte aligned memory, so a chunk that isn't is copied. From v37 every
+    // chunk starts 4-byte aligned in the SKP, so an SKP loaded from aligned memory isn't copied;
+    // before that the op stream followed a 33-byte header and always was.
+    const bool aligned = SkIsAlign4(reinterpret_cast<intptr_t>(data->bytes() + offset));
+
+    switch (tag) {
+        case SK_PICT_READER_TAG:
+            if (fOpData) {
+                // Later chunks of the ops have to be gathered up into one copy.
+                return this->parseStreamTag(stream, tag, size, NULL);
+            }
+            if (aligned && size <= data->size() - offset) {
+                fOpData = SkData::NewSubset(data, offset, size);
+                stream->skip(size);
+            } else {
+                fOpData = SkData::NewFromStream(stream, size);
+                if (!fOpData) {
+                    return false;
+                }
+            }
+            break;
+        case SK_PICT_PICTURE_TAG: {
+            fPictureCount = size;
+            fPictureRefs = SkNEW_ARRAY(const SkPicture*, fPictureCount);
+            bool success = true;
+            int i = 0;
+            for ( ; i < fPictureCount; i++) {
+                fPictureRefs[i] = SkPicture::CreateFromData(stream, data, proc);
+                if (NULL == fPictureRefs[i]) {
+                    success = false;
+                    break;
+                }
+            }
+            if (!success) {
+                // Delete all of the pictures that were already created (up to but excluding i):
+                for (int j = 0; j < i; j++) {
+                    fPictureRefs[j]->unref();
+                }
+                // Delete the array
+                SkDELETE_ARRAY(fPictureRefs);
+                fPictureCount = 0;
+                return false;
+            }
+        } break;
+        case SK_PICT_BUFFER_SIZE_TAG: {
+            if (size > data->size() - offset) {
+                return false;
+            }
+            const void* storage = data->bytes() + offset;
+            SkAutoMalloc copy;
+            if (!aligned) {
+                storage = memcpy(copy.reset(size), storage, size);
+            }
+            stream->skip(size);
+
+            SkReadBuffer buffer(storage, size);
+            buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
+            buffer.setVersion(fInfo.fVersion);
+
+            fFactoryPlayback->setupBuffer(buffer);
+            fTFPlayback.setupBuffer(buffer);
+            // Even when the buffer is a copy, encoded bitmaps are handed subsets of data.
+            buffer.setLazyBitmapDecoder(proc, data, offset);
+
+            while (!buffer.eof()) {
+                tag = buffer.readUInt();
+                size = buffer.readUInt();
+                if (!this->parseBufferTag(buffer, tag, size)) {
+                    return false;
+                }
+            }
+        } break;
+        default:
+            // Factories and typefaces are read the same way whatever the stream.
+            return this->parseStreamTag(stream, tag, size, NULL);
+    }
+    return true;    // success
+}
+
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                SkPicture::InstallPixelRefProc proc) {
@@ -531,6 +659,18 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
     return data.detach();
 }
 
+SkPictureData* SkPictureData::CreateFromData(SkMemoryStream* stream,
+                                             SkData* data,
+                                             const SkPictInfo& info,
+                                             SkPicture::InstallLazyPixelRefProc proc) {
+    SkAutoTDelete<SkPictureData> pictureData(SkNEW_ARGS(SkPictureData, (info)));
+
+    if (!pictureData->parseData(stream, data, proc)) {
+        return NULL;
+    }
+    return pictureData.detach();
+}
+
 bool SkPictureData::parseStream(SkStream* stream,
                                 SkPicture::InstallPixelRefProc proc) {
     for (;;) {
@@ -544,6 +684,7 @@ bool SkPictureData::parseStream(SkStream* stream,
             return false; // we're invalid
         }
     }
+    this->finishOpChunks();
     return true;
 }
 
@@ -562,6 +703,31 @@ bool SkPictureData::parseBuffer(SkReadBuffer& buffer) {
     return true;
 }
 
+bool SkPictureData::parseData(SkMemoryStream* stream, SkData* data,
+                              SkPicture::InstallLazyPixelRefProc proc) {
+    for (;;) {
+        uint32_t tag = stream->readU32();
+        if (SK_PICT_EOF_TAG == tag) {
+            break;
+        }
+
+        uint32_t size = stream->readU32();
+        if (!this->parseDataTag(stream, data, tag, size, proc)) {
+            return false; // we're invalid
+        }
+    }
+    this->finishOpChunks();
+    return true;
+}
+
+void SkPictureData::finishOpChunks() {
+    if (fOpChunks.get()) {
+        fOpData->unref();
+        fOpData = fOpChunks->copyToData();
+        fOpChunks.free();
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
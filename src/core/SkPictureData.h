@@ -15,6 +15,8 @@
 #include "SkPictureFlat.h"
 
 class SkData;
+class SkDynamicMemoryWStream;
+class SkMemoryStream;
 class SkPictureRecord;
 class SkReader32;
 class SkStream;
@@ -39,6 +41,10 @@ struct SkPictInfo {
     uint32_t    fFlags;
 };
 
+// Since v37 the bool after SkPictInfo is followed by this many zero bytes, so the header is
+// 36 bytes long and the chunks that follow it stay 4-byte aligned.
+#define SK_PICT_HEADER_PADDING  3
+
 #define SK_PICT_READER_TAG     SkSetFourByteTag('r', 'e', 'a', 'd')
 #define SK_PICT_FACTORY_TAG    SkSetFourByteTag('f', 'a', 'c', 't')
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
@@ -62,6 +68,10 @@ public:
                                            const SkPictInfo&,
                                            SkPicture::InstallPixelRefProc);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
+    // Like CreateFromStream(), but stream reads data, and the ops and encoded bitmaps are
+    // referenced in place rather than copied out of it.
+    static SkPictureData* CreateFromData(SkMemoryStream*, SkData*, const SkPictInfo&,
+                                         SkPicture::InstallLazyPixelRefProc);
 
     virtual ~SkPictureData();
 
@@ -81,6 +91,7 @@ protected:
 
     bool parseStream(SkStream*, SkPicture::InstallPixelRefProc);
     bool parseBuffer(SkReadBuffer& buffer);
+    bool parseData(SkMemoryStream*, SkData*, SkPicture::InstallLazyPixelRefProc);
 
 public:
     const SkBitmap& getBitmap(SkReader32* reader) const {
@@ -142,7 +153,10 @@ private:
 
     // these help us with reading/writing
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size, SkPicture::InstallPixelRefProc);
+    void finishOpChunks();
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
+    bool parseDataTag(SkMemoryStream*, SkData*, uint32_t tag, uint32_t size,
+                      SkPicture::InstallLazyPixelRefProc);
     void flattenToBuffer(SkWriteBuffer&) const;
 
     // Only used by getBitmap() if the passed in index is SkBitmapHeap::INVALID_SLOT. This empty
@@ -155,6 +169,8 @@ private:
     SkTRefArray<SkPaint>* fPaints;
 
     SkData* fOpData;    // opcodes and parameters
+    // While parsing a picture whose ops are split into several chunks, the ones read so far.
+    SkAutoTDelete<SkDynamicMemoryWStream> fOpChunks;
 
     SkAutoTUnref<const SkPathHeap> fPathHeap;  // reference counted
 
@@ -33,6 +33,10 @@ SkPictureRecord::SkPictureRecord(const SkISize& dimensions, uint32_t flags)
     : INHERITED(dimensions.width(), dimensions.height())
     , fFlattenableHeap(HEAP_BLOCK_SIZE)
     , fPaints(&fFlattenableHeap)
+    , fOpStream(NULL)
+    , fOpChunkSize(0)
+    , fFlushedOpBytes(0)
+    , fOpStreamOK(true)
     , fRecordFlags(flags) {
 
     fBitmapHeap = SkNEW(SkBitmapHeap);
@@ -135,6 +139,9 @@ static inline size_t get_paint_offset(DrawType op, size_t opSize) {
 #endif//SK_DEBUG
 
 void SkPictureRecord::willSave() {
+    // Drawing that is all saves and restores has no ops at the top level to flush before.
+    this->maybeFlushOps();
+
     // record the offset to us, making it non-positive to distinguish a save
     // from a clip entry.
     fRestoreOffsetStack.push(-(int32_t)fWriter.bytesWritten());
@@ -155,6 +162,8 @@ void SkPictureRecord::recordSave() {
 
 SkCanvas::SaveLayerStrategy SkPictureRecord::willSaveLayer(const SkRect* bounds,
                                                            const SkPaint* paint, SaveFlags flags) {
+    this->maybeFlushOps();
+
     // record the offset to us, making it non-positive to distinguish a save
     // from a clip entry.
     fRestoreOffsetStack.push(-(int32_t)fWriter.bytesWritten());
@@ -244,7 +253,8 @@ void SkPictureRecord::recordRestore(bool fillInSkips) {
     fContentInfo.onRestore();
 
     if (fillInSkips) {
-        this->fillRestoreOffsetPlaceholdersForCurrentStackLevel((uint32_t)fWriter.bytesWritten());
+        this->fillRestoreOffsetPlaceholdersForCurrentStackLevel(
+                SkToU32(fFlushedOpBytes + fWriter.bytesWritten()));
     }
     size_t size = 1 * kUInt32Size; // RESTORE consists solely of 1 op code
     size_t initialOffset = this->addDraw(RESTORE, &size);
@@ -332,13 +342,33 @@ void SkPictureRecord::fillRestoreOffsetPlaceholdersForCurrentStackLevel(uint32_t
     }
 
 #ifdef SK_DEBUG
-    // assert that the final offset value points to a save verb
-    uint32_t opSize;
-    DrawType drawOp = peek_op_and_size(&fWriter, -offset, &opSize);
-    SkASSERT(SAVE == drawOp || SAVE_LAYER == drawOp);
+    // assert that the final offset value points to a save verb (unless it was streamed out)
+    if (0 == fFlushedOpBytes || fRestoreOffsetStack.count() > 1) {
+        uint32_t opSize;
+        DrawType drawOp = peek_op_and_size(&fWriter, -offset, &opSize);
+        SkASSERT(SAVE == drawOp || SAVE_LAYER == drawOp);
+    }
 #endif
 }
 
+void SkPictureRecord::setOpStream(SkWStream* stream, size_t chunkSize) {
+    SkASSERT(kNoInitialSave == fInitialSaveCount);
+    SkASSERT(chunkSize > 0);
+    fOpStream = stream;
+    fOpChunkSize = chunkSize;
+}
+
+void SkPictureRecord::flushOps() {
+    SkASSERT(fOpStream);
+    const size_t size = fWriter.bytesWritten();
+    fOpStreamOK &= fOpStream->write32(SK_PICT_READER_TAG) &&
+                   fOpStream->write32(SkToU32(size)) &&
+                   fWriter.writeToStream(fOpStream);
+    fFlushedOpBytes += size;
+    // Keeps the storage for the next chunk.
+    fWriter.rewindToOffset(0);
+}
+
 void SkPictureRecord::beginRecording() {
     // we have to call this *after* our constructor, to ensure that it gets
     // recorded. This is balanced by restoreToCount() call from endRecording,
@@ -363,6 +393,14 @@ size_t SkPictureRecord::recordRestoreOffsetPlaceholder(SkRegion::Op op) {
     // restore command is recorded.
     int32_t prevOffset = fRestoreOffsetStack.top();
 
+    if (fOpStream && 1 == fRestoreOffsetStack.count()) {
+        // The initial save's restore is only recorded at the very end, after everything before it
+        // has been streamed out, so top-level clips can't be patched to skip to it.
+        size_t offset = fWriter.bytesWritten();
+        this->addInt(0);
+        return offset;
+    }
+
     if (regionOpExpands(op)) {
         // Run back through any previous clip ops, and mark their offset to
         // be 0, disabling their ability to trigger a jump-to-restore, otherwise
@@ -890,14 +928,16 @@ void SkPictureRecord::onPopCull() {
     SkASSERT(!fCullOffsetStack.isEmpty());
 
     uint32_t cullSkipOffset = fCullOffsetStack.top();
-    fCullOffsetStack.pop();
 
     // op only
     size_t size = kUInt32Size;
     size_t initialOffset = this->addDraw(POP_CULL, &size);
+    // Only pop once the op is written, so addDraw() can't stream out the cull skip offset.
+    fCullOffsetStack.pop();
 
     // update the cull skip offset to point past this op.
-    fWriter.overwriteTAt<uint32_t>(cullSkipOffset, SkToU32(fWriter.bytesWritten()));
+    fWriter.overwriteTAt<uint32_t>(cullSkipOffset,
+                                   SkToU32(fFlushedOpBytes + fWriter.bytesWritten()));
 
     this->validate(initialOffset, size);
 }
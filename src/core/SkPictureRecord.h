@@ -99,6 +99,16 @@ public:
         return fWriter;
     }
 
+    /**
+     *  Streams the ops out as they are recorded instead of keeping them all. Whenever at least
+     *  chunkSize bytes of ops are held, they are written to stream as an SK_PICT_READER_TAG chunk
+     *  at the next point where none of them can still need patching. Call before beginRecording().
+     */
+    void setOpStream(SkWStream* stream, size_t chunkSize);
+
+    // Whether every chunk written to the op stream so far was written successfully.
+    bool opStreamOK() const { return fOpStreamOK; }
+
     void beginRecording();
     void endRecording();
 
@@ -107,6 +117,17 @@ protected:
 
 private:
     void handleOptimization(int opt);
+    void flushOps();
+
+    void maybeFlushOps() {
+        // Top-level clips don't record restore offsets when streaming, so nothing recorded can
+        // still need patching unless it's inside a save (other than the initial one) or a cull.
+        if (fOpStream && fWriter.bytesWritten() >= fOpChunkSize &&
+            fRestoreOffsetStack.count() <= 1 && fCullOffsetStack.isEmpty()) {
+            this->flushOps();
+        }
+    }
+
     size_t recordRestoreOffsetPlaceholder(SkRegion::Op);
     void fillRestoreOffsetPlaceholdersForCurrentStackLevel(uint32_t restoreOffset);
 
@@ -131,6 +152,8 @@ private:
      * operates in this manner.
      */
     size_t addDraw(DrawType drawType, size_t* size) {
+        this->maybeFlushOps();
+
         size_t offset = fWriter.bytesWritten();
 
         this->predrawNotify();
@@ -250,6 +273,11 @@ private:
 
     SkWriter32 fWriter;
 
+    SkWStream* fOpStream;
+    size_t     fOpChunkSize;
+    size_t     fFlushedOpBytes;     // offset in the whole op stream of fWriter's first byte
+    bool       fOpStreamOK;
+
     // we ref each item in these arrays
     SkTDArray<const SkPicture*>  fPictureRefs;
     SkTDArray<const SkTextBlob*> fTextBlobRefs;
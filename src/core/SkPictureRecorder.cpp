@@ -7,8 +7,11 @@
 
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
+#include "SkRecordCompare.h"
 #include "SkRecordDraw.h"
+#include "SkRecordOpts.h"
 #include "SkRecorder.h"
+#include "SkTDynamicHash.h"
 #include "SkTypes.h"
 
 SkPictureRecorder::SkPictureRecorder() {}
@@ -36,9 +39,129 @@ SkCanvas* SkPictureRecorder::getRecordingCanvas() {
 }
 
 SkPicture* SkPictureRecorder::endRecording() {
+    SkRecordOptimize(fRecord.get());
     return SkNEW_ARGS(SkPicture, (fCullWidth, fCullHeight, fRecord.detach(), fBBH.get()));
 }
 
+// Indexes an SkRecord-backed picture, and those it draws at any depth, by content.
+class SkPictureReuseIndex : SkNoncopyable {
+public:
+    explicit SkPictureReuseIndex(const SkPicture* root) {
+        SkTDArray<const SkPicture*> pending;
+        *pending.append() = root;
+        while (!pending.isEmpty()) {
+            const SkPicture* picture;
+            pending.pop(&picture);
+            // Pictures equal to one we've seen draw the same pictures, so we skip those too.
+            if (NULL == picture->fRecord.get() || fPictures.find(picture->contentHash())) {
+                continue;
+            }
+            fPictures.add(picture);
+            if (0 == picture->fAnalysis.fNumPictures) {
+                continue;
+            }
+
+            CollectPictures collect(&pending);
+            for (unsigned i = 0; i < picture->fRecord->count(); i++) {
+                picture->fRecord->visit<void>(i, collect);
+            }
+        }
+    }
+
+    // Returns an indexed picture equal to record, which has the given hash and cull size, and
+    // which has a BBH if needBBH; or NULL if there's none.
+    const SkPicture* find(const SkRecord& record, uint32_t hash,
+                          SkScalar width, SkScalar height, bool needBBH) const {
+        const SkPicture* picture = fPictures.find(hash);
+        if (picture &&
+            picture->fCullWidth == width &&
+            picture->fCullHeight == height &&
+            (picture->fBBH.get() || !needBBH) &&
+            SkRecordEqual(*picture->fRecord, record)) {
+            return picture;
+        }
+        return NULL;
+    }
+
+    // Swaps each picture drawn by record for an equal indexed one.
+    void share(SkRecord* record) const {
+        SharePictures share(*this);
+        for (unsigned i = 0; i < record->count(); i++) {
+            record->mutate<void>(i, share);
+        }
+    }
+
+private:
+    void sharePicture(SkRecords::DrawPicture* op) const {
+        const SkPicture* picture = op->picture;
+        if (NULL == picture->fRecord.get()) {
+            return;
+        }
+        const SkPicture* shared = this->find(*picture->fRecord, picture->contentHash(),
+                                             picture->fCullWidth, picture->fCullHeight,
+                                             SkToBool(picture->fBBH.get()));
+        if (shared && shared != picture) {
+            op->picture.reset(shared);
+        }
+    }
+
+    struct CollectPictures {
+        explicit CollectPictures(SkTDArray<const SkPicture*>* pictures) : fPictures(pictures) {}
+
+        void operator()(const SkRecords::DrawPicture& op) { *fPictures->append() = op.picture; }
+        template <typename T> void operator()(const T&) {}
+
+        SkTDArray<const SkPicture*>* fPictures;
+    };
+
+    struct SharePictures {
+        explicit SharePictures(const SkPictureReuseIndex& index) : fIndex(index) {}
+
+        void operator()(SkRecords::DrawPicture* op) { fIndex.sharePicture(op); }
+        template <typename T> void operator()(T*) {}
+
+        const SkPictureReuseIndex& fIndex;
+    };
+
+    // SkTDynamicHash wants keys by reference, so we hand it the hash cached in the picture,
+    // which contentHash() has always filled in before a picture is indexed.
+    static const uint32_t& CachedHash(const SkPicture& picture) {
+        SkASSERT(0 != picture.fContentHash);
+        return picture.fContentHash;
+    }
+
+    struct Traits {
+        static const uint32_t& GetKey(const SkPicture& picture) { return CachedHash(picture); }
+        static uint32_t Hash(const uint32_t& key) { return key; }
+    };
+    SkTDynamicHash<const SkPicture, uint32_t, Traits> fPictures;
+};
+
+SkPicture* SkPictureRecorder::endRecordingReusing(const SkPicture* previous) {
+    if (NULL == previous) {
+        return this->endRecording();
+    }
+
+    SkPictureReuseIndex index(previous);
+    index.share(fRecord.get());
+
+    // Compare the record as the picture would hold it, optimized.
+    SkRecordOptimize(fRecord.get());
+    const uint32_t hash = SkPicture::ContentHash(*fRecord);
+    if (const SkPicture* shared = index.find(*fRecord, hash, fCullWidth, fCullHeight,
+                                             SkToBool(fBBH.get()))) {
+        fRecord.free();
+        // Pictures are immutable, so sharing one as non-const is safe.
+        return SkRef(const_cast<SkPicture*>(shared));
+    }
+
+    // The record is already optimized, so it's stored exactly as hashed.
+    SkPicture* picture = SkNEW_ARGS(SkPicture, (fCullWidth, fCullHeight, fRecord.detach(),
+                                                fBBH.get()));
+    picture->fContentHash = hash;
+    return picture;
+}
+
 void SkPictureRecorder::partialReplay(SkCanvas* canvas) const {
     if (NULL == canvas) {
         return;
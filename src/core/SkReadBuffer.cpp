@@ -34,6 +34,9 @@ SkReadBuffer::SkReadBuffer() {
     fFactoryArray = NULL;
     fFactoryCount = 0;
     fBitmapDecoder = NULL;
+    fLazyBitmapDecoder = NULL;
+    fLazyBitmapData = NULL;
+    fLazyBitmapDataOffset = 0;
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     fDecodedBitmapIndex = -1;
 #endif // DEBUG_NON_DETERMINISTIC_ASSERT
@@ -53,6 +56,9 @@ SkReadBuffer::SkReadBuffer(const void* data, size_t size) {
     fFactoryArray = NULL;
     fFactoryCount = 0;
     fBitmapDecoder = NULL;
+    fLazyBitmapDecoder = NULL;
+    fLazyBitmapData = NULL;
+    fLazyBitmapDataOffset = 0;
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     fDecodedBitmapIndex = -1;
 #endif // DEBUG_NON_DETERMINISTIC_ASSERT
@@ -74,6 +80,9 @@ SkReadBuffer::SkReadBuffer(SkStream* stream) {
     fFactoryArray = NULL;
     fFactoryCount = 0;
     fBitmapDecoder = NULL;
+    fLazyBitmapDecoder = NULL;
+    fLazyBitmapData = NULL;
+    fLazyBitmapDataOffset = 0;
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     fDecodedBitmapIndex = -1;
 #endif // DEBUG_NON_DETERMINISTIC_ASSERT
@@ -82,6 +91,7 @@ SkReadBuffer::SkReadBuffer(SkStream* stream) {
 SkReadBuffer::~SkReadBuffer() {
     sk_free(fMemoryPtr);
     SkSafeUnref(fBitmapStorage);
+    SkSafeUnref(fLazyBitmapData);
 }
 
 bool SkReadBuffer::readBool() {
@@ -223,7 +233,16 @@ bool SkReadBuffer::readBitmap(SkBitmap* bitmap) {
             const void* data = this->skip(length);
             const int32_t xOffset = this->readInt();
             const int32_t yOffset = this->readInt();
-            if (fBitmapDecoder != NULL && fBitmapDecoder(data, length, bitmap)) {
+            bool decoded;
+            if (fLazyBitmapDecoder != NULL) {
+                const size_t offset = fLazyBitmapDataOffset +
+                        (static_cast<const char*>(data) - static_cast<const char*>(fReader.base()));
+                SkAutoDataUnref encoded(SkData::NewSubset(fLazyBitmapData, offset, length));
+                decoded = fLazyBitmapDecoder(encoded, bitmap);
+            } else {
+                decoded = fBitmapDecoder != NULL && fBitmapDecoder(data, length, bitmap);
+            }
+            if (decoded) {
                 if (bitmap->width() == width && bitmap->height() == height) {
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
                     if (0 != xOffset || 0 != yOffset) {
@@ -201,6 +201,19 @@ public:
         fBitmapDecoder = bitmapDecoder;
     }
 
+    /**
+     *  Provide a function to install a pixel ref on an SkBitmap from encoded data without copying
+     *  it, which is used instead of the bitmap decoder. The buffer must hold the bytes of data
+     *  starting at offset (not necessarily at the same address); each encoded SkBitmap is handed
+     *  the subset of data it was read from.
+     */
+    void setLazyBitmapDecoder(SkPicture::InstallLazyPixelRefProc bitmapDecoder,
+                              SkData* data, size_t offset) {
+        fLazyBitmapDecoder = bitmapDecoder;
+        SkRefCnt_SafeAssign(fLazyBitmapData, data);
+        fLazyBitmapDataOffset = offset;
+    }
+
     // Default impelementations don't check anything.
     virtual bool validate(bool isValid) { return true; }
     virtual bool isValid() const { return true; }
@@ -227,6 +240,10 @@ private:
 
     SkPicture::InstallPixelRefProc fBitmapDecoder;
 
+    SkPicture::InstallLazyPixelRefProc fLazyBitmapDecoder;
+    SkData* fLazyBitmapData;
+    size_t  fLazyBitmapDataOffset;
+
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     // Debugging counter to keep track of how many bitmaps we
     // have decoded.
@@ -10,6 +10,7 @@
 
 #include "SkChunkAlloc.h"
 #include "SkRecords.h"
+#include "SkTDynamicHash.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 
@@ -38,6 +39,9 @@ public:
         for (unsigned i = 0; i < this->count(); i++) {
             this->mutate<void>(i, destroyer);
         }
+        for (PaintTable::Iter iter(&fPaints); !iter.done(); ++iter) {
+            (*iter).~SkPaint();
+        }
     }
 
     // Returns the number of canvas commands in this SkRecord.
@@ -72,6 +76,20 @@ public:
         return (T*)fAlloc.allocThrow(SkAlignPtr(sizeof(T) * count));
     }
 
+    // Return a copy of paint owned by this SkRecord, to be freed when the SkRecord is destroyed.
+    // Equal paints (by SkPaint::operator==) share a single copy.  Throws on failure.
+    const SkPaint* internPaint(const SkPaint& paint) {
+        if (const SkPaint* interned = fPaints.find(paint)) {
+            return interned;
+        }
+        SkPaint* interned = SkNEW_PLACEMENT_ARGS(this->alloc<SkPaint>(), SkPaint, (paint));
+        fPaints.add(interned);
+        return interned;
+    }
+
+    // Returns the number of distinct paints interned by internPaint().
+    int paintCount() const { return fPaints.count(); }
+
     // Add a new command of type T to the end of this SkRecord.
     // You are expected to placement new an object of type T onto this pointer.
     template <typename T>
@@ -179,6 +197,13 @@ private:
     template <typename T>
     SK_WHEN(!SkTIsEmpty<T>, T*) allocCommand() { return this->alloc<T>(); }
 
+    // Hashes SkPaints by value for fPaints.  The SkPaints themselves live in fAlloc.
+    struct PaintTraits {
+        static const SkPaint& GetKey(const SkPaint& paint) { return paint; }
+        static uint32_t Hash(const SkPaint& paint) { return paint.getHash(); }
+    };
+    typedef SkTDynamicHash<SkPaint, SkPaint, PaintTraits> PaintTable;
+
     // An untyped pointer to some bytes in fAlloc.  This is the interface for polymorphic dispatch:
     // visit() and mutate() work with the parallel fTypes array to do the work of a vtable.
     struct Record {
@@ -225,8 +250,11 @@ private:
     //
     // fRecords and fTypes need to be data structures that can append fixed length data, and need to
     // support efficient random access and forward iteration.  (They don't need to be contiguous.)
+    //
+    // fPaints indexes the paints interned into fAlloc by value, so we can find them again.
 
     SkChunkAlloc fAlloc;
+    PaintTable fPaints;
     SkAutoTMalloc<Record> fRecords;
     SkAutoTMalloc<Type8> fTypes;
     // fCount and fReserved measure both fRecords and fTypes, which always grow in lock step.
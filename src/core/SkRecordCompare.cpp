@@ -0,0 +1,604 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRecordCompare.h"
+
+#include "SkChecksum.h"
+#include "SkPatchUtils.h"
+#include "SkRecordDraw.h"
+#include "SkTSort.h"
+#include "SkTDArray.h"
+
+namespace {
+
+// One argument of a canvas call, or part of one, along with how to hash and compare it.
+struct Arg {
+    enum Kind {
+        kBytes_Kind,     // fBytes bytes at fPtr
+        kIdentity_Kind,  // the pointer fPtr itself
+        kPaint_Kind,
+        kPath_Kind,
+        kRRect_Kind,
+        kRegion_Kind,
+        kMatrix_Kind,
+        kBitmap_Kind,
+    };
+
+    Kind        fKind;
+    const void* fPtr;
+    size_t      fBytes;
+};
+
+// Murmur3 wants whole, aligned words, so this feeds it those and mixes any others in by hand.
+uint32_t hash_bytes(const void* data, size_t bytes) {
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    uint32_t hash = 0;
+    if (SkIsAlign4(reinterpret_cast<uintptr_t>(ptr))) {
+        const size_t words = bytes & ~3;
+        hash = SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(ptr), words);
+        ptr += words;
+        bytes -= words;
+    }
+    for (size_t i = 0; i < bytes; i++) {
+        hash = hash * 31 + ptr[i];
+    }
+    return SkChecksum::Mix(hash);
+}
+
+uint32_t hash_arg(const Arg& arg) {
+    switch (arg.fKind) {
+        case Arg::kBytes_Kind:
+            return hash_bytes(arg.fPtr, arg.fBytes);
+        case Arg::kIdentity_Kind:
+            return hash_bytes(&arg.fPtr, sizeof(arg.fPtr));
+        case Arg::kPaint_Kind:
+            return static_cast<const SkPaint*>(arg.fPtr)->getHash();
+        case Arg::kPath_Kind: {
+            // SkPath has no hash, so we use a few things that equal paths must share.
+            const SkPath& path = *static_cast<const SkPath*>(arg.fPtr);
+            const SkRect bounds = path.getBounds();
+            const int32_t counts[] = { path.countPoints(), path.countVerbs(), path.getFillType() };
+            return hash_bytes(&bounds, sizeof(bounds)) ^ hash_bytes(counts, sizeof(counts));
+        }
+        case Arg::kRRect_Kind: {
+            const SkRect& rect = static_cast<const SkRRect*>(arg.fPtr)->rect();
+            return hash_bytes(&rect, sizeof(rect));
+        }
+        case Arg::kRegion_Kind: {
+            const SkIRect& bounds = static_cast<const SkRegion*>(arg.fPtr)->getBounds();
+            return hash_bytes(&bounds, sizeof(bounds));
+        }
+        case Arg::kMatrix_Kind: {
+            const SkMatrix& matrix = *static_cast<const SkMatrix*>(arg.fPtr);
+            SkScalar values[9];
+            for (int i = 0; i < 9; i++) {
+                values[i] = matrix[i];
+            }
+            return hash_bytes(values, sizeof(values));
+        }
+        case Arg::kBitmap_Kind: {
+            const SkBitmap& bitmap = *static_cast<const SkBitmap*>(arg.fPtr);
+            const uint32_t values[] = { bitmap.getGenerationID(),
+                                        SkToU32(bitmap.width()), SkToU32(bitmap.height()) };
+            return hash_bytes(values, sizeof(values));
+        }
+    }
+    SkDEBUGFAIL("Unreachable");
+    return 0;
+}
+
+bool args_equal(const Arg& a, const Arg& b) {
+    if (a.fKind != b.fKind) {
+        return false;
+    }
+    switch (a.fKind) {
+        case Arg::kBytes_Kind:
+            return a.fBytes == b.fBytes && 0 == memcmp(a.fPtr, b.fPtr, a.fBytes);
+        case Arg::kIdentity_Kind:
+            return a.fPtr == b.fPtr;
+        case Arg::kPaint_Kind:
+            return *static_cast<const SkPaint*>(a.fPtr) == *static_cast<const SkPaint*>(b.fPtr);
+        case Arg::kPath_Kind:
+            return *static_cast<const SkPath*>(a.fPtr) == *static_cast<const SkPath*>(b.fPtr);
+        case Arg::kRRect_Kind:
+            return *static_cast<const SkRRect*>(a.fPtr) == *static_cast<const SkRRect*>(b.fPtr);
+        case Arg::kRegion_Kind:
+            return *static_cast<const SkRegion*>(a.fPtr) == *static_cast<const SkRegion*>(b.fPtr);
+        case Arg::kMatrix_Kind:
+            return *static_cast<const SkMatrix*>(a.fPtr) == *static_cast<const SkMatrix*>(b.fPtr);
+        case Arg::kBitmap_Kind: {
+            const SkBitmap& x = *static_cast<const SkBitmap*>(a.fPtr);
+            const SkBitmap& y = *static_cast<const SkBitmap*>(b.fPtr);
+            return x.getGenerationID() == y.getGenerationID() &&
+                   x.pixelRefOrigin() == y.pixelRefOrigin() &&
+                   x.info() == y.info();
+        }
+    }
+    SkDEBUGFAIL("Unreachable");
+    return false;
+}
+
+// Lists the arguments of a canvas call as Args, which point into the call's record.
+class ListArgs : SkNoncopyable {
+public:
+    explicit ListArgs(SkTDArray<Arg>* args) : fArgs(args) {}
+
+    void operator()(const SkRecords::NoOp&) {}
+    void operator()(const SkRecords::Restore& r) { this->pod(r.devBounds); this->matrix(r.matrix); }
+    void operator()(const SkRecords::Save&) {}
+    void operator()(const SkRecords::SaveLayer& r) {
+        this->optionalPod(r.bounds);
+        this->optionalPaint(r.paint);
+        this->pod(r.flags);
+    }
+    void operator()(const SkRecords::PushCull& r) { this->pod(r.rect); }
+    void operator()(const SkRecords::PopCull&) {}
+    void operator()(const SkRecords::SetMatrix& r) { this->matrix(r.matrix); }
+    void operator()(const SkRecords::ClipPath& r) {
+        this->pod(r.devBounds);
+        this->add(Arg::kPath_Kind, &r.path);
+        this->pod(r.op);
+        this->pod(r.doAA);
+    }
+    void operator()(const SkRecords::ClipRRect& r) {
+        this->pod(r.devBounds);
+        this->add(Arg::kRRect_Kind, &r.rrect);
+        this->pod(r.op);
+        this->pod(r.doAA);
+    }
+    void operator()(const SkRecords::ClipRect& r) {
+        this->pod(r.devBounds);
+        this->pod(r.rect);
+        this->pod(r.op);
+        this->pod(r.doAA);
+    }
+    void operator()(const SkRecords::ClipRegion& r) {
+        this->pod(r.devBounds);
+        this->add(Arg::kRegion_Kind, &r.region);
+        this->pod(r.op);
+    }
+    void operator()(const SkRecords::Clear& r) { this->pod(r.color); }
+    void operator()(const SkRecords::BeginCommentGroup& r) { this->string(r.description); }
+    void operator()(const SkRecords::AddComment& r) {
+        this->string(r.key);
+        this->string(r.value);
+    }
+    void operator()(const SkRecords::EndCommentGroup&) {}
+    void operator()(const SkRecords::DrawBitmap& r) {
+        this->optionalPaint(r.paint);
+        this->bitmap(r.bitmap);
+        this->pod(r.left);
+        this->pod(r.top);
+    }
+    void operator()(const SkRecords::DrawBitmapMatrix& r) {
+        this->optionalPaint(r.paint);
+        this->bitmap(r.bitmap);
+        this->matrix(r.matrix);
+    }
+    void operator()(const SkRecords::DrawBitmapNine& r) {
+        this->optionalPaint(r.paint);
+        this->bitmap(r.bitmap);
+        this->pod(r.center);
+        this->pod(r.dst);
+    }
+    void operator()(const SkRecords::DrawBitmapRectToRect& r) {
+        this->optionalPaint(r.paint);
+        this->bitmap(r.bitmap);
+        this->optionalPod(r.src);
+        this->pod(r.dst);
+        this->pod(r.flags);
+    }
+    void operator()(const SkRecords::DrawDRRect& r) {
+        this->paint(r.paint);
+        this->add(Arg::kRRect_Kind, &r.outer);
+        this->add(Arg::kRRect_Kind, &r.inner);
+    }
+    void operator()(const SkRecords::DrawOval& r) { this->paint(r.paint); this->pod(r.oval); }
+    void operator()(const SkRecords::DrawPaint& r) { this->paint(r.paint); }
+    void operator()(const SkRecords::DrawPath& r) {
+        this->paint(r.paint);
+        this->add(Arg::kPath_Kind, &r.path);
+    }
+    void operator()(const SkRecords::DrawPatch& r) {
+        this->paint(r.paint);
+        this->array(r.cubics, SkPatchUtils::kNumCtrlPts);
+        this->optionalArray(r.colors, 4);
+        this->optionalArray(r.texCoords, 4);
+        this->identity(r.xmode);
+    }
+    void operator()(const SkRecords::DrawPicture& r) {
+        this->optionalPaint(r.paint);
+        this->identity(r.picture);
+        this->optionalMatrix(r.matrix);
+    }
+    void operator()(const SkRecords::DrawPoints& r) {
+        this->paint(r.paint);
+        this->pod(r.mode);
+        this->array(r.pts, r.count);
+    }
+    void operator()(const SkRecords::DrawPosText& r) {
+        this->paint(r.paint);
+        this->text(r.text, r.byteLength);
+        this->array(r.pos, r.paint->countText(r.text, r.byteLength));
+    }
+    void operator()(const SkRecords::DrawPosTextH& r) {
+        this->paint(r.paint);
+        this->text(r.text, r.byteLength);
+        this->array(r.xpos, r.paint->countText(r.text, r.byteLength));
+        this->pod(r.y);
+    }
+    void operator()(const SkRecords::DrawText& r) {
+        this->paint(r.paint);
+        this->text(r.text, r.byteLength);
+        this->pod(r.x);
+        this->pod(r.y);
+    }
+    void operator()(const SkRecords::DrawTextOnPath& r) {
+        this->paint(r.paint);
+        this->text(r.text, r.byteLength);
+        this->add(Arg::kPath_Kind, &r.path);
+        this->optionalMatrix(r.matrix);
+    }
+    void operator()(const SkRecords::DrawRRect& r) {
+        this->paint(r.paint);
+        this->add(Arg::kRRect_Kind, &r.rrect);
+    }
+    void operator()(const SkRecords::DrawRect& r) { this->paint(r.paint); this->pod(r.rect); }
+    void operator()(const SkRecords::DrawSprite& r) {
+        this->optionalPaint(r.paint);
+        this->bitmap(r.bitmap);
+        this->pod(r.left);
+        this->pod(r.top);
+    }
+    void operator()(const SkRecords::DrawTextBlob& r) {
+        this->paint(r.paint);
+        this->identity(r.blob);
+        this->pod(r.x);
+        this->pod(r.y);
+    }
+    void operator()(const SkRecords::DrawData& r) { this->text(r.data, r.length); }
+    void operator()(const SkRecords::DrawVertices& r) {
+        this->paint(r.paint);
+        this->pod(r.vmode);
+        this->array(r.vertices, r.vertexCount);
+        this->optionalArray(r.texs, r.vertexCount);
+        this->optionalArray(r.colors, r.vertexCount);
+        this->identity(r.xmode.get());
+        this->optionalArray(r.indices, r.indexCount);
+    }
+
+private:
+    void add(Arg::Kind kind, const void* ptr, size_t bytes = 0) {
+        Arg* arg = fArgs->append();
+        arg->fKind = kind;
+        arg->fPtr = ptr;
+        arg->fBytes = bytes;
+    }
+
+    template <typename T>
+    void pod(const T& value) { this->add(Arg::kBytes_Kind, &value, sizeof(T)); }
+
+    template <typename T>
+    void array(const T* values, size_t count) {
+        this->add(Arg::kBytes_Kind, values, count * sizeof(T));
+    }
+
+    template <typename T>
+    void array(const SkRecords::PODArray<T>& values, size_t count) {
+        this->array(static_cast<const T*>(values), count);
+    }
+
+    void identity(const void* ptr) { this->add(Arg::kIdentity_Kind, ptr); }
+
+    // Optional arguments are listed as whether they're set, then their values if they are.
+    void flag(bool set) { this->identity(set ? &kSet : NULL); }
+
+    template <typename T>
+    void optionalArray(const SkRecords::PODArray<T>& values, size_t count) {
+        this->flag(NULL != values);
+        if (values) {
+            this->array(values, count);
+        }
+    }
+
+    template <typename T>
+    void optionalPod(const SkRecords::Optional<T>& value) {
+        this->flag(NULL != value);
+        if (value) {
+            this->pod(*value);
+        }
+    }
+
+    void text(const char* text, size_t byteLength) {
+        this->add(Arg::kBytes_Kind, text, byteLength);
+    }
+
+    void string(const char* str) { this->text(str, strlen(str)); }
+
+    void paint(const SkPaint& paint) { this->add(Arg::kPaint_Kind, &paint); }
+
+    void optionalPaint(const SkRecords::Optional<SkPaint>& paint) {
+        this->flag(NULL != paint);
+        if (paint) {
+            this->paint(*paint);
+        }
+    }
+
+    void matrix(const SkMatrix& matrix) { this->add(Arg::kMatrix_Kind, &matrix); }
+
+    void optionalMatrix(const SkRecords::Optional<SkMatrix>& matrix) {
+        this->flag(NULL != matrix);
+        if (matrix) {
+            this->matrix(*matrix);
+        }
+    }
+
+    void bitmap(const SkBitmap& bitmap) { this->add(Arg::kBitmap_Kind, &bitmap); }
+
+    static const char kSet;
+
+    SkTDArray<Arg>* fArgs;
+};
+
+const char ListArgs::kSet = 0;
+
+// Reads the type of a record.
+struct TypeOf {
+    template <typename T>
+    SkRecords::Type operator()(const T&) { return T::kType; }
+};
+
+SkRecords::Type type_of(const SkRecord& record, unsigned i) {
+    TypeOf typeOf;
+    return record.visit<SkRecords::Type>(i, typeOf);
+}
+
+// Lists the arguments of the i-th call into args, and returns its type.
+SkRecords::Type list_args(const SkRecord& record, unsigned i, SkTDArray<Arg>* args) {
+    args->rewind();
+    ListArgs list(args);
+    record.visit<void>(i, list);
+    return type_of(record, i);
+}
+
+uint32_t hash_call(SkRecords::Type type, const SkTDArray<Arg>& args) {
+    uint32_t hash = type;
+    for (int i = 0; i < args.count(); i++) {
+        hash = hash * 31 + hash_arg(args[i]);
+    }
+    return hash;
+}
+
+bool calls_equal(SkRecords::Type typeA, const SkTDArray<Arg>& argsA,
+                 SkRecords::Type typeB, const SkTDArray<Arg>& argsB) {
+    if (typeA != typeB || argsA.count() != argsB.count()) {
+        return false;
+    }
+    for (int i = 0; i < argsA.count(); i++) {
+        if (!args_equal(argsA[i], argsB[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Steps through the calls of an SkRecord, skipping NoOps.
+class Cursor : SkNoncopyable {
+public:
+    explicit Cursor(const SkRecord& record) : fRecord(record), fIndex(0) { this->skipNoOps(); }
+
+    bool done() const { return fIndex >= fRecord.count(); }
+
+    // Lists the current call's type and arguments, then moves on to the next call.
+    SkRecords::Type next(SkTDArray<Arg>* args) {
+        SkASSERT(!this->done());
+        const SkRecords::Type type = list_args(fRecord, fIndex, args);
+        fIndex++;
+        this->skipNoOps();
+        return type;
+    }
+
+private:
+    void skipNoOps() {
+        while (!this->done() && SkRecords::NoOp_Type == type_of(fRecord, fIndex)) {
+            fIndex++;
+        }
+    }
+
+    const SkRecord& fRecord;
+    unsigned fIndex;
+};
+
+// Keeps the bounds SkRecordFillBounds() finds for each op, instead of indexing them.
+class OpBounds : public SkBBoxHierarchy {
+public:
+    explicit OpBounds(const SkRecord& record) : fBounds(record.count()) {
+        for (unsigned i = 0; i < record.count(); i++) {
+            fBounds[i].setEmpty();
+        }
+        SkRecordFillBounds(record, this);
+    }
+
+    virtual void insert(unsigned opIndex, const SkRect& bounds, bool) SK_OVERRIDE {
+        fBounds[opIndex] = bounds;
+    }
+
+    virtual void search(const SkRect&, SkTDArray<unsigned>*) const SK_OVERRIDE {
+        SkDEBUGFAIL("OpBounds can't search.");
+    }
+
+    const SkRect& operator[](unsigned i) const { return fBounds[i]; }
+
+private:
+    SkAutoTMalloc<SkRect> fBounds;
+};
+
+// The calls of an SkRecord other than NoOps, with their bounds, for matching against another's.
+class Calls : SkNoncopyable {
+public:
+    explicit Calls(const SkRecord& record) : fRecord(record), fBounds(record) {
+        SkTDArray<Arg> args;
+        for (unsigned i = 0; i < record.count(); i++) {
+            const SkRecords::Type type = list_args(record, i, &args);
+            if (SkRecords::NoOp_Type != type) {
+                Call* call = fCalls.append();
+                call->fIndex = i;
+                call->fHash = hash_call(type, args) * 31 +
+                              hash_bytes(&fBounds[i], sizeof(SkRect));
+            }
+        }
+    }
+
+    int count() const { return fCalls.count(); }
+    uint32_t hash(int i) const { return fCalls[i].fHash; }
+    const SkRect& bounds(int i) const { return fBounds[fCalls[i].fIndex]; }
+
+    // Returns true if a's i-th call and b's j-th call are equal and have equal bounds.
+    static bool Match(const Calls& a, int i, const Calls& b, int j) {
+        if (a.hash(i) != b.hash(j) || a.bounds(i) != b.bounds(j)) {
+            return false;
+        }
+        SkTDArray<Arg> argsA, argsB;
+        const SkRecords::Type typeA = list_args(a.fRecord, a.fCalls[i].fIndex, &argsA);
+        const SkRecords::Type typeB = list_args(b.fRecord, b.fCalls[j].fIndex, &argsB);
+        return calls_equal(typeA, argsA, typeB, argsB);
+    }
+
+private:
+    struct Call {
+        unsigned fIndex;  // in fRecord
+        uint32_t fHash;   // of the call and its bounds
+    };
+
+    const SkRecord& fRecord;
+    OpBounds fBounds;
+    SkTDArray<Call> fCalls;
+};
+
+// For finding the calls of one record with a given hash, in order.
+struct Candidate {
+    uint32_t fHash;
+    int fCall;
+
+    bool operator<(const Candidate& other) const {
+        return fHash < other.fHash || (fHash == other.fHash && fCall < other.fCall);
+    }
+};
+
+// Adds the bounds of calls start through stop - 1 that weren't matched to rects.
+void add_damage(const Calls& calls, int start, int stop, const SkAutoTMalloc<bool>& matched,
+                const SkIRect& clip, SkTDArray<SkIRect>* rects) {
+    for (int i = start; i < stop; i++) {
+        if (!matched[i]) {
+            SkIRect rect;
+            calls.bounds(i).roundOut(&rect);
+            if (rect.intersect(clip)) {
+                *rects->append() = rect;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+uint32_t SkRecordHash(const SkRecord& record) {
+    SkTDArray<Arg> args;
+    uint32_t hash = 0;
+    for (Cursor cursor(record); !cursor.done();) {
+        const SkRecords::Type type = cursor.next(&args);
+        hash = hash * 31 + hash_call(type, args);
+    }
+    return SkChecksum::Mix(hash);
+}
+
+bool SkRecordEqual(const SkRecord& a, const SkRecord& b) {
+    SkTDArray<Arg> argsA, argsB;
+    Cursor cursorA(a), cursorB(b);
+    while (!cursorA.done() && !cursorB.done()) {
+        const SkRecords::Type typeA = cursorA.next(&argsA);
+        const SkRecords::Type typeB = cursorB.next(&argsB);
+        if (!calls_equal(typeA, argsA, typeB, argsB)) {
+            return false;
+        }
+    }
+    return cursorA.done() && cursorB.done();
+}
+
+void SkRecordComputeDamage(const SkRecord& before, const SkRecord& after, const SkIRect& clip,
+                           SkRegion* damage) {
+    SkASSERT(damage);
+    const Calls a(before), b(after);
+
+    // Most frames change little, so first match the calls before and after the changes.
+    int startA = 0, startB = 0, stopA = a.count(), stopB = b.count();
+    while (startA < stopA && startB < stopB && Calls::Match(a, startA, b, startB)) {
+        startA++;
+        startB++;
+    }
+    while (startA < stopA && startB < stopB && Calls::Match(a, stopA - 1, b, stopB - 1)) {
+        stopA--;
+        stopB--;
+    }
+
+    SkAutoTMalloc<bool> matchedA(a.count()), matchedB(b.count());
+    sk_bzero(matchedA.get(), a.count() * sizeof(bool));
+    sk_bzero(matchedB.get(), b.count() * sizeof(bool));
+
+    // Then greedily match what's left in order: each call in a takes the first equal call in b
+    // after the last one taken.  Any order-keeping match is correct, if not always the smallest.
+    SkTDArray<Candidate> candidates;
+    for (int j = startB; j < stopB; j++) {
+        Candidate* candidate = candidates.append();
+        candidate->fHash = b.hash(j);
+        candidate->fCall = j;
+    }
+    if (candidates.count() > 1) {
+        SkTQSort(candidates.begin(), candidates.end() - 1);
+    }
+    // For each run of candidates with the same hash, the first that may still be taken.
+    SkAutoTMalloc<int> firstFree(candidates.count());
+    for (int k = 0; k < candidates.count(); k++) {
+        firstFree[k] = k;
+    }
+
+    int lastTaken = startB - 1;
+    for (int i = startA; i < stopA; i++) {
+        // Find the run of candidates with a's hash.
+        int lo = 0, hi = candidates.count();
+        while (lo < hi) {
+            const int mid = (lo + hi) / 2;
+            if (candidates[mid].fHash < a.hash(i)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        const int run = lo;
+        if (run == candidates.count() || candidates[run].fHash != a.hash(i)) {
+            continue;
+        }
+        for (int k = firstFree[run]; k < candidates.count() && candidates[k].fHash == a.hash(i);
+             k++) {
+            const int j = candidates[k].fCall;
+            if (j <= lastTaken) {
+                // Every later call in a must match after lastTaken too, so skip this for good.
+                firstFree[run] = k + 1;
+            } else if (Calls::Match(a, i, b, j)) {
+                matchedA[i] = matchedB[j] = true;
+                lastTaken = j;
+                firstFree[run] = k + 1;
+                break;
+            }
+        }
+    }
+
+    // What's left unmatched on either side may draw differently.
+    SkTDArray<SkIRect> rects;
+    add_damage(a, startA, stopA, matchedA, clip, &rects);
+    add_damage(b, startB, stopB, matchedB, clip, &rects);
+    damage->setRects(rects.begin(), rects.count());
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordCompare_DEFINED
+#define SkRecordCompare_DEFINED
+
+#include "SkRecord.h"
+#include "SkRegion.h"
+
+// Two SkRecords are equal when they hold the same canvas calls, in order, with equal arguments.
+// NoOps are skipped.  Paints compare with SkPaint::operator==, so their effects by identity, and
+// so do nested pictures, text blobs and xfermodes.  Bitmaps compare by pixels' generation ID.
+// Either way, equal records draw the same, though records that draw the same may not be equal.
+
+// Hash the calls in an SkRecord.  Equal records have equal hashes.
+uint32_t SkRecordHash(const SkRecord&);
+
+// Returns true if the two SkRecords are equal, as above.
+bool SkRecordEqual(const SkRecord&, const SkRecord&);
+
+// Set damage to the pixels within clip that may draw differently if after is drawn in place of
+// before.  These are the bounds, as SkRecordFillBounds() finds them, of the calls in each record
+// that aren't matched, in order, by an equal call with equal bounds in the other.
+void SkRecordComputeDamage(const SkRecord& before, const SkRecord& after, const SkIRect& clip,
+                           SkRegion* damage);
+
+#endif//SkRecordCompare_DEFINED
@@ -351,13 +351,13 @@ private:
         return Bounds::MakeXYWH(op.left, op.top, bm.width(), bm.height());  // Ignores the matrix.
     }
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint.get()); }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint.get()); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint.get());
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint.get());
     }
 
     Bounds bounds(const DrawBitmapRectToRect& op) const {
@@ -379,28 +379,29 @@ private:
     }
 
     Bounds bounds(const DrawPath& op) const {
-        return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+        return op.path.isInverseFillType()
+            ? fCurrentClipBounds
+            : this->adjustAndMap(op.path.getBounds(), op.paint.get());
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawPicture& op) const {
@@ -412,7 +413,7 @@ private:
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -420,10 +421,10 @@ private:
         SkRect dst;
         dst.set(op.pos, N);
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -435,7 +436,7 @@ private:
         }
         SkRect dst = { left, op.y, right, op.y };
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
@@ -450,7 +451,7 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawTextBlob& op) const {
@@ -460,7 +461,7 @@ private:
         if (dst.isEmpty()) {
             return fCurrentClipBounds;
         }
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     static void AdjustTextForFontMetrics(SkRect* rect, const SkPaint& paint) {
@@ -62,7 +62,7 @@ public:
     void operator()(const Clear& c) {
         SkPaint p;
         p.setColor(c.color);
-        DrawRect drawRect(p, fClearRect);
+        DrawRect drawRect(&p, fClearRect);
         this->INHERITED::operator()(drawRect);
     }
 
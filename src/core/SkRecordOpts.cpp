@@ -9,18 +9,40 @@
 
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
+#include "SkXfermode.h"
 
 using namespace SkRecords;
 
-void SkRecordOptimize(SkRecord* record) {
+void SkRecordOptimize(SkRecord* record, uint32_t passes) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
     // and the bounding box hierarchy will do the work of skipping no-op
     // Save-NoDraw-Restore sequences better than we can here.
-    //SkRecordNoopSaveRestores(record);
-
-    SkRecordNoopSaveLayerDrawRestores(record);
+    if (passes & kNoopSaveRestores_SkRecordOptimizePass) {
+        SkRecordNoopSaveRestores(record);
+    }
+    if (passes & kNoopSaveLayerDrawRestores_SkRecordOptimizePass) {
+        SkRecordNoopSaveLayerDrawRestores(record);
+    }
+    // Fewer SetMatrix and ClipRect commands leave longer runs of draws for the passes after.
+    if (passes & kNoopRedundantSetMatrices_SkRecordOptimizePass) {
+        SkRecordNoopRedundantSetMatrices(record);
+    }
+    if (passes & kNoopRedundantClipRects_SkRecordOptimizePass) {
+        SkRecordNoopRedundantClipRects(record);
+    }
+    // Merged rects may cover more than either alone.
+    if (passes & kMergeDrawRects_SkRecordOptimizePass) {
+        SkRecordMergeDrawRects(record);
+    }
+    if (passes & kNoopOccludedDraws_SkRecordOptimizePass) {
+        SkRecordNoopOccludedDraws(record);
+    }
+    if (passes & kMergeDrawPosTexts_SkRecordOptimizePass) {
+        SkRecordMergeDrawPosTexts(record);
+    }
 }
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -84,6 +106,31 @@ void SkRecordNoopSaveRestores(SkRecord* record) {
     while (apply(&onlyDraws, record) || apply(&noDraws, record));
 }
 
+// Replaces the paint of a drawing command.  Shared paints are re-interned rather than modified in
+// place, as other commands may be pointing at the same SkPaint.
+class PaintReplacer {
+    SK_CREATE_MEMBER_DETECTOR(paint);
+public:
+    PaintReplacer(SkRecord* record, const SkPaint& paint) : fRecord(record), fPaint(paint) {}
+
+    template <typename T>
+    SK_WHEN(HasMember_paint<T>, void) operator()(T* draw) { this->replace(&draw->paint); }
+
+    template <typename T>
+    SK_WHEN(!HasMember_paint<T>, void) operator()(T*) { SkDEBUGFAIL("No paint to replace."); }
+
+private:
+    void replace(SharedPaint* paint) { *paint = fRecord->internPaint(fPaint); }
+    void replace(Optional<SkPaint>* paint) {
+        SkPaint* dst = *paint;
+        SkASSERT(dst);
+        *dst = fPaint;
+    }
+
+    SkRecord* fRecord;
+    const SkPaint& fPaint;
+};
+
 // For some SaveLayer-[drawing command]-Restore patterns, merge the SaveLayer's alpha into the
 // draw, and no-op the SaveLayer and Restore.
 struct SaveLayerDrawRestoreNooper {
@@ -102,7 +149,7 @@ struct SaveLayerDrawRestoreNooper {
             return KillSaveLayerAndRestore(record, begin);
         }
 
-        SkPaint* drawPaint = pattern->second<SkPaint>();
+        const SkPaint* drawPaint = pattern->second<const SkPaint>();
         if (drawPaint == NULL) {
             // We can just give the draw the SaveLayer's paint.
             // TODO(mtklein): figure out how to do this clearly
@@ -118,7 +165,10 @@ struct SaveLayerDrawRestoreNooper {
             return false;
         }
 
-        drawPaint->setColor(SkColorSetA(drawColor, SkColorGetA(layerColor)));
+        SkPaint newDrawPaint(*drawPaint);
+        newDrawPaint.setColor(SkColorSetA(drawColor, SkColorGetA(layerColor)));
+        PaintReplacer replacer(record, newDrawPaint);
+        record->mutate<void>(begin+1, replacer);
         return KillSaveLayerAndRestore(record, begin);
     }
 
@@ -151,3 +201,499 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
     apply(&pass, record);
 }
 
+
+// Tracks the matrix and what we know about the clip as we walk forward through an SkRecord.  When
+// clipKnown(), the clip lies within clip(): every pixel it holds has its center in clip() as the
+// record's commands map it.  When !clipSoft(), the record has not antialiased the clip's edges.
+class ClipTracker {
+public:
+    ClipTracker() {
+        fMatrix.reset();
+        State* state = fStates.append();
+        state->fKnown = false;
+        state->fSoft = false;
+    }
+
+    const SkMatrix& matrix() const { return fMatrix; }
+    bool clipKnown() const { return fStates.top().fKnown; }
+    const SkRect& clip() const { return fStates.top().fClip; }
+    bool clipSoft() const { return fStates.top().fSoft; }
+
+    // Maps src by the matrix to dst, returning false if it's not a rectangle there.
+    bool mapRect(const SkRect& src, SkRect* dst) const {
+        if (!fMatrix.rectStaysRect()) {
+            return false;
+        }
+        fMatrix.mapRect(dst, src);
+        return true;
+    }
+
+    // Call for each command after deciding what to do with it.
+    void operator()(const Save&) { this->push(); }
+    void operator()(const SaveLayer&) { this->push(); }
+    void operator()(const Restore& r) {
+        if (fStates.count() > 1) {
+            fStates.pop();
+        }
+        fMatrix = r.matrix;
+    }
+    void operator()(const SetMatrix& r) { fMatrix = r.matrix; }
+    void operator()(const ClipRect& r) {
+        State& state = fStates.top();
+        SkRect rect;
+        if (!r.doAA && this->mapRect(r.rect, &rect)) {
+            if (SkRegion::kIntersect_Op == r.op) {
+                if (!state.fKnown) {
+                    state.fClip = rect;
+                } else if (!state.fClip.intersect(rect)) {
+                    state.fClip.setEmpty();
+                }
+                state.fKnown = true;
+                return;
+            }
+            if (SkRegion::kReplace_Op == r.op) {
+                state.fClip = rect;
+                state.fKnown = true;
+                state.fSoft = false;
+                return;
+            }
+        }
+        this->clip(r.op, r.doAA);
+    }
+    void operator()(const ClipRRect& r) { this->clip(r.op, r.doAA); }
+    void operator()(const ClipPath& r) { this->clip(r.op, r.doAA); }
+    void operator()(const ClipRegion& r) { this->clip(r.op, false); }
+    template <typename T> void operator()(const T&) {}
+
+    // Intersect and difference can only shrink the clip.  The rest may grow it.
+    static bool Shrinks(SkRegion::Op op) {
+        return SkRegion::kIntersect_Op == op || SkRegion::kDifference_Op == op;
+    }
+
+private:
+    struct State {
+        SkRect fClip;
+        bool fKnown;
+        bool fSoft;
+    };
+
+    void push() { *fStates.append() = fStates.top(); }
+
+    void clip(SkRegion::Op op, bool doAA) {
+        State& state = fStates.top();
+        if (SkRegion::kReplace_Op == op) {
+            state.fKnown = false;
+            state.fSoft = doAA;
+        } else {
+            state.fKnown = state.fKnown && Shrinks(op);
+            state.fSoft = state.fSoft || doAA;
+        }
+    }
+
+    SkMatrix fMatrix;
+    SkTDArray<State> fStates;
+};
+
+// Visits each command of record with Pass, which returns true to no-op it, and otherwise updates
+// the ClipTracker Pass was built with.
+template <typename Pass>
+static void track_and_noop(Pass* pass, ClipTracker* tracker, SkRecord* record) {
+    for (unsigned i = 0; i < record->count(); i++) {
+        if (record->visit<bool>(i, *pass)) {
+            record->replace<NoOp>(i);
+        } else {
+            record->visit<void>(i, *tracker);
+        }
+    }
+}
+
+// No-ops a SetMatrix followed only by NoOps and another SetMatrix or a Restore, which both
+// replace the matrix before anything uses it.
+struct SetMatrixSetMatrixNooper {
+    typedef Pattern3<Is<SetMatrix>, Star<Is<NoOp> >, Or<Is<SetMatrix>, Is<Restore> > > Pattern;
+
+    bool onMatch(SkRecord* record, Pattern* pattern, unsigned begin, unsigned end) {
+        record->replace<NoOp>(begin);
+        return true;
+    }
+};
+// Finds SetMatrix commands setting the matrix already in effect.
+struct UnchangedSetMatrixFinder {
+    explicit UnchangedSetMatrixFinder(const ClipTracker& tracker) : fTracker(tracker) {}
+
+    bool operator()(const SetMatrix& r) { return r.matrix == fTracker.matrix(); }
+    template <typename T> bool operator()(const T&) { return false; }
+
+    const ClipTracker& fTracker;
+};
+void SkRecordNoopRedundantSetMatrices(SkRecord* record) {
+    SetMatrixSetMatrixNooper pass;
+    while (apply(&pass, record));
+
+    ClipTracker tracker;
+    UnchangedSetMatrixFinder finder(tracker);
+    track_and_noop(&finder, &tracker, record);
+}
+
+// Finds hard-edged, intersecting ClipRects containing the hard-edged clip they intersect.  Both
+// pick out the pixels with centers inside, so the ClipRect leaves every pixel of the clip in it.
+struct RedundantClipRectFinder {
+    explicit RedundantClipRectFinder(const ClipTracker& tracker) : fTracker(tracker) {}
+
+    bool operator()(const ClipRect& r) {
+        SkRect rect;
+        return SkRegion::kIntersect_Op == r.op && !r.doAA && fTracker.clipKnown() &&
+               fTracker.mapRect(r.rect, &rect) && rect.contains(fTracker.clip());
+    }
+    template <typename T> bool operator()(const T&) { return false; }
+
+    const ClipTracker& fTracker;
+};
+void SkRecordNoopRedundantClipRects(SkRecord* record) {
+    ClipTracker tracker;
+    RedundantClipRectFinder finder(tracker);
+    track_and_noop(&finder, &tracker, record);
+}
+
+// Merges two DrawRects with the same paint, with only NoOps between, when they share a whole edge.
+// Hard-edged rects sharing an edge cover exactly the pixels their union does, each once, so
+// per-pixel effects like shaders and xfermodes draw the same either way.
+struct DrawRectMerger {
+    typedef Pattern3<Is<DrawRect>, Star<Is<NoOp> >, Is<DrawRect> > Pattern;
+
+    bool onMatch(SkRecord* record, Pattern* pattern, unsigned begin, unsigned end) {
+        const DrawRect* first = pattern->first<DrawRect>();
+        DrawRect* last = pattern->third<DrawRect>();
+        if (first->paint.get() != last->paint.get() || !CanMerge(first->paint)) {
+            return false;
+        }
+
+        const SkRect& a = first->rect;
+        const SkRect& b = last->rect;
+        if (a.isEmpty() || b.isEmpty()) {
+            return false;
+        }
+        const bool sameRows = a.fTop  == b.fTop  && a.fBottom == b.fBottom,
+                   sameCols = a.fLeft == b.fLeft && a.fRight  == b.fRight;
+        if (!(sameRows && (a.fRight  == b.fLeft || b.fRight  == a.fLeft)) &&
+            !(sameCols && (a.fBottom == b.fTop  || b.fBottom == a.fTop))) {
+            return false;
+        }
+
+        last->rect.join(a);
+        record->replace<NoOp>(begin);
+        return true;
+    }
+
+    // Effects that depend on the whole shape drawn, or antialiasing its edges, rule this out.
+    static bool CanMerge(const SkPaint& paint) {
+        return SkPaint::kFill_Style == paint.getStyle() &&
+               !paint.isAntiAlias() &&
+               NULL == paint.getPathEffect() &&
+               NULL == paint.getMaskFilter() &&
+               NULL == paint.getRasterizer() &&
+               NULL == paint.getLooper() &&
+               NULL == paint.getImageFilter();
+    }
+};
+void SkRecordMergeDrawRects(SkRecord* record) {
+    DrawRectMerger pass;
+    // Each run merges every other pair in a row of rects, so this takes a few runs.
+    while (apply(&pass, record));
+}
+
+// How SkRecordNoopOccludedDraws treats each command.
+enum OcclusionKind {
+    kKeep_OcclusionKind,       // Draws nothing and changes no state: never no-oped.
+    kDraw_OcclusionKind,       // Draws within the clip.
+    kState_OcclusionKind,      // Changes only state that the next Restore undoes.
+    kSave_OcclusionKind,
+    kSaveLayer_OcclusionKind,
+    kRestore_OcclusionKind,
+    kShrinkClip_OcclusionKind,
+    kGrowClip_OcclusionKind,   // May grow the clip past what it was at the last Save.
+    kClear_OcclusionKind,      // Draws everywhere, ignoring the clip.
+};
+class OcclusionClassifier {
+    SK_CREATE_MEMBER_DETECTOR(paint);
+public:
+    template <typename T>
+    SK_WHEN(HasMember_paint<T>, OcclusionKind) operator()(const T&) {
+        return kDraw_OcclusionKind;
+    }
+    template <typename T>
+    SK_WHEN(!HasMember_paint<T>, OcclusionKind) operator()(const T&) {
+        return kKeep_OcclusionKind;
+    }
+
+    OcclusionKind operator()(const Save&) { return kSave_OcclusionKind; }
+    OcclusionKind operator()(const SaveLayer&) { return kSaveLayer_OcclusionKind; }
+    OcclusionKind operator()(const Restore&) { return kRestore_OcclusionKind; }
+    OcclusionKind operator()(const SetMatrix&) { return kState_OcclusionKind; }
+    OcclusionKind operator()(const ClipPath& r) { return Clip(r.op); }
+    OcclusionKind operator()(const ClipRRect& r) { return Clip(r.op); }
+    OcclusionKind operator()(const ClipRect& r) { return Clip(r.op); }
+    OcclusionKind operator()(const ClipRegion& r) { return Clip(r.op); }
+    OcclusionKind operator()(const Clear&) { return kClear_OcclusionKind; }
+
+private:
+    static OcclusionKind Clip(SkRegion::Op op) {
+        return ClipTracker::Shrinks(op) ? kShrinkClip_OcclusionKind : kGrowClip_OcclusionKind;
+    }
+};
+
+// Finds draws that replace every pixel of their clip with an opaque color.
+struct OccluderFinder {
+    explicit OccluderFinder(const ClipTracker& tracker) : fTracker(tracker) {}
+
+    bool operator()(const DrawPaint& r) {
+        return !fTracker.clipSoft() && IsOpaque(r.paint);
+    }
+    bool operator()(const DrawRect& r) {
+        // A hard-edged rect covers the pixels with centers inside it, so covers the clip if it
+        // contains the clip.
+        SkRect rect;
+        return !fTracker.clipSoft() && fTracker.clipKnown() &&
+               SkPaint::kFill_Style == r.paint->getStyle() && !r.paint->isAntiAlias() &&
+               IsOpaque(r.paint) &&
+               fTracker.mapRect(r.rect, &rect) && rect.contains(fTracker.clip());
+    }
+    template <typename T> bool operator()(const T&) { return false; }
+
+    static bool IsOpaque(const SkPaint& paint) {
+        return SK_AlphaOPAQUE == paint.getAlpha() &&
+               (NULL == paint.getShader() || paint.getShader()->isOpaque()) &&
+               (SkXfermode::IsMode(paint.getXfermode(), SkXfermode::kSrcOver_Mode) ||
+                SkXfermode::IsMode(paint.getXfermode(), SkXfermode::kSrc_Mode)) &&
+               NULL == paint.getColorFilter() &&
+               NULL == paint.getPathEffect() &&
+               NULL == paint.getMaskFilter() &&
+               NULL == paint.getRasterizer() &&
+               NULL == paint.getLooper() &&
+               NULL == paint.getImageFilter();
+    }
+
+    const ClipTracker& fTracker;
+};
+
+// Walks forward through the record, keeping for each open Save or SaveLayer the draws and closed
+// blocks since its last clip, all drawn within the clip now in effect.  An occluder no-ops those
+// of its own level and, through the Saves opened since without clipping, of the levels above.
+class OccludedDrawsNooper {
+public:
+    explicit OccludedDrawsNooper(SkRecord* record) : fRecord(record) {
+        this->push(0, true/*layer*/);
+    }
+
+    void run() {
+        ClipTracker tracker;
+        OccluderFinder occluder(tracker);
+        OcclusionClassifier classify;
+        for (unsigned i = 0; i < fRecord->count(); i++) {
+            switch (fRecord->visit<OcclusionKind>(i, classify)) {
+                case kKeep_OcclusionKind:
+                case kState_OcclusionKind:
+                    break;
+                case kDraw_OcclusionKind:
+                    if (fRecord->visit<bool>(i, occluder)) {
+                        this->noopOccluded();
+                    }
+                    this->pend(i, i);
+                    break;
+                case kSave_OcclusionKind:
+                    this->push(i, false/*layer*/);
+                    break;
+                case kSaveLayer_OcclusionKind:
+                    this->push(i, true/*layer*/);
+                    break;
+                case kRestore_OcclusionKind:
+                    this->pop(i);
+                    break;
+                case kShrinkClip_OcclusionKind:
+                    this->clip();
+                    break;
+                case kGrowClip_OcclusionKind:
+                    this->clip();
+                    this->escape();
+                    break;
+                case kClear_OcclusionKind:
+                    this->escape();
+                    break;
+            }
+            fRecord->visit<void>(i, tracker);
+        }
+    }
+
+private:
+    struct Level {
+        unsigned fSave;       // Index of the Save or SaveLayer opening this level.
+        int fPendingStart;    // This level's pending spans are fPending[fPendingStart...].
+        bool fLayer;          // Opened by SaveLayer, or the record's own top level.
+        bool fClipped;        // Clipped since opening, so drawing within less than the level above.
+        bool fEscaped;        // Drew or clipped beyond the clip at its Save.
+    };
+    // A span of commands [fBegin, fEnd] that draw only within the clip of the level it's pending on.
+    struct Span {
+        unsigned fBegin, fEnd;
+    };
+
+    void push(unsigned save, bool layer) {
+        Level* level = fLevels.append();
+        level->fSave = save;
+        level->fPendingStart = fPending.count();
+        level->fLayer = layer;
+        level->fClipped = false;
+        level->fEscaped = false;
+    }
+
+    void pend(unsigned begin, unsigned end) {
+        Span* span = fPending.append();
+        span->fBegin = begin;
+        span->fEnd = end;
+    }
+
+    void pop(unsigned restore) {
+        if (fLevels.count() < 2) {
+            return;  // Unbalanced.
+        }
+        const Level level = fLevels.top();
+        fLevels.pop();
+        fPending.setCount(level.fPendingStart);
+        // What's drawn in a layer lands within the clip at its SaveLayer.
+        if (level.fEscaped && !level.fLayer) {
+            this->escape();
+        } else {
+            this->pend(level.fSave, restore);
+        }
+    }
+
+    // Earlier draws at this level were in a larger clip than later ones.
+    void clip() {
+        Level& level = fLevels.top();
+        fPending.setCount(level.fPendingStart);
+        level.fClipped = true;
+    }
+
+    // This level, and those above it up to the nearest layer, can't be no-oped whole.
+    void escape() {
+        for (int i = fLevels.count() - 1; i >= 0; i--) {
+            fLevels[i].fEscaped = true;
+            if (fLevels[i].fLayer) {
+                break;
+            }
+        }
+    }
+
+    void noopOccluded() {
+        int top = fLevels.count() - 1;
+        while (!fLevels[top].fLayer && !fLevels[top].fClipped) {
+            top--;
+        }
+        const int start = fLevels[top].fPendingStart;
+        for (int i = start; i < fPending.count(); i++) {
+            this->noop(fPending[i]);
+        }
+        fPending.setCount(start);
+        for (int i = top + 1; i < fLevels.count(); i++) {
+            fLevels[i].fPendingStart = start;
+        }
+    }
+
+    void noop(const Span& span) {
+        OcclusionClassifier classify;
+        for (unsigned i = span.fBegin; i <= span.fEnd; i++) {
+            if (kKeep_OcclusionKind != fRecord->visit<OcclusionKind>(i, classify)) {
+                fRecord->replace<NoOp>(i);
+            }
+        }
+    }
+
+    SkRecord* fRecord;
+    SkTDArray<Level> fLevels;
+    SkTDArray<Span> fPending;
+};
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    OccludedDrawsNooper(record).run();
+}
+
+// Merges two DrawPosTexts or DrawPosTextHs with the same paint, with only NoOps between.
+// Each glyph draws separately either way, so this draws the same as long as nothing draws the
+// text as a whole.
+static bool can_merge_text(const SkPaint& paint) {
+    return NULL == paint.getLooper() &&
+           NULL == paint.getImageFilter() &&
+           NULL == paint.getMaskFilter() &&
+           NULL == paint.getPathEffect() &&
+           NULL == paint.getRasterizer();
+}
+
+template <typename T>
+static char* concat_text(SkRecord* record, const T& first, const T& last) {
+    char* text = record->alloc<char>(first.byteLength + last.byteLength);
+    memcpy(text, first.text, first.byteLength);
+    memcpy(text + first.byteLength, last.text, last.byteLength);
+    return text;
+}
+
+template <typename T>
+static T* concat_positions(SkRecord* record, const T* first, int firstCount,
+                                             const T* last, int lastCount) {
+    T* positions = record->alloc<T>(firstCount + lastCount);
+    memcpy(positions, first, firstCount * sizeof(T));
+    memcpy(positions + firstCount, last, lastCount * sizeof(T));
+    return positions;
+}
+
+struct DrawPosTextMerger {
+    typedef Pattern3<Is<DrawPosText>, Star<Is<NoOp> >, Is<DrawPosText> > Pattern;
+
+    bool onMatch(SkRecord* record, Pattern* pattern, unsigned begin, unsigned end) {
+        const DrawPosText* first = pattern->first<DrawPosText>();
+        DrawPosText* last = pattern->third<DrawPosText>();
+        const SkPaint& paint = first->paint;
+        if (first->paint.get() != last->paint.get() || !can_merge_text(paint)) {
+            return false;
+        }
+
+        last->pos = concat_positions<SkPoint>(record,
+                                              first->pos, paint.countText(first->text,
+                                                                          first->byteLength),
+                                              last->pos, paint.countText(last->text,
+                                                                         last->byteLength));
+        last->text = concat_text(record, *first, *last);
+        last->byteLength += first->byteLength;
+        record->replace<NoOp>(begin);
+        return true;
+    }
+};
+
+struct DrawPosTextHMerger {
+    typedef Pattern3<Is<DrawPosTextH>, Star<Is<NoOp> >, Is<DrawPosTextH> > Pattern;
+
+    bool onMatch(SkRecord* record, Pattern* pattern, unsigned begin, unsigned end) {
+        const DrawPosTextH* first = pattern->first<DrawPosTextH>();
+        DrawPosTextH* last = pattern->third<DrawPosTextH>();
+        const SkPaint& paint = first->paint;
+        if (first->paint.get() != last->paint.get() || first->y != last->y ||
+            !can_merge_text(paint)) {
+            return false;
+        }
+
+        last->xpos = concat_positions<SkScalar>(record,
+                                                first->xpos, paint.countText(first->text,
+                                                                             first->byteLength),
+                                                last->xpos, paint.countText(last->text,
+                                                                            last->byteLength));
+        last->text = concat_text(record, *first, *last);
+        last->byteLength += first->byteLength;
+        record->replace<NoOp>(begin);
+        return true;
+    }
+};
+
+void SkRecordMergeDrawPosTexts(SkRecord* record) {
+    DrawPosTextMerger pos;
+    DrawPosTextHMerger posH;
+    while (apply(&pos, record));
+    while (apply(&posH, record));
+}
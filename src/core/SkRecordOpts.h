@@ -10,8 +10,27 @@
 
 #include "SkRecord.h"
 
-// Run all optimizations in recommended order.
-void SkRecordOptimize(SkRecord*);
+// Each of the optimizations below, as a bit for SkRecordOptimize().
+enum SkRecordOptimizePass {
+    kNoopSaveRestores_SkRecordOptimizePass          = 1 << 0,
+    kNoopSaveLayerDrawRestores_SkRecordOptimizePass = 1 << 1,
+    kNoopRedundantSetMatrices_SkRecordOptimizePass  = 1 << 2,
+    kNoopRedundantClipRects_SkRecordOptimizePass    = 1 << 3,
+    kMergeDrawRects_SkRecordOptimizePass            = 1 << 4,
+    kNoopOccludedDraws_SkRecordOptimizePass         = 1 << 5,
+    kMergeDrawPosTexts_SkRecordOptimizePass         = 1 << 6,
+};
+
+// The passes SkRecordOptimize() runs by default: all those that never change what's drawn.
+static const uint32_t kDefault_SkRecordOptimizePasses =
+        kNoopSaveLayerDrawRestores_SkRecordOptimizePass |
+        kNoopRedundantSetMatrices_SkRecordOptimizePass  |
+        kNoopRedundantClipRects_SkRecordOptimizePass    |
+        kMergeDrawRects_SkRecordOptimizePass            |
+        kMergeDrawPosTexts_SkRecordOptimizePass;
+
+// Run the given optimizations in recommended order.
+void SkRecordOptimize(SkRecord*, uint32_t passes = kDefault_SkRecordOptimizePasses);
 
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
 void SkRecordNoopSaveRestores(SkRecord*);
@@ -20,4 +39,26 @@ void SkRecordNoopSaveRestores(SkRecord*);
 // draw, and no-op the SaveLayer and Restore.
 void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 
+// No-ops SetMatrix commands that are immediately replaced by another or undone by a Restore,
+// or that set the matrix already in effect.
+void SkRecordNoopRedundantSetMatrices(SkRecord*);
+
+// No-ops hard-edged, intersecting ClipRects that contain the hard-edged rectangular clip they
+// intersect, and so can't shrink the clip.
+void SkRecordNoopRedundantClipRects(SkRecord*);
+
+// Merges runs of DrawRects with the same paint into one, where they tile a larger rectangle
+// without overlapping.  Only hard-edged, filled rects without mask-changing effects are merged.
+void SkRecordMergeDrawRects(SkRecord*);
+
+// No-ops draws that a later opaque DrawRect or DrawPaint covers, along with any Save-Restore
+// blocks it covers entirely.  The occluder must fill its whole clip, which must be hard-edged.
+// This assumes the canvas we play back into has no antialiased clip: along a soft clip edge,
+// occluded draws would still have shown through the partially covering occluder.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawPosTexts, or DrawPosTextHs along the same baseline, with the same paint.
+// Paints with loopers, image filters, mask filters or path effects aren't merged.
+void SkRecordMergeDrawPosTexts(SkRecord*);
+
 #endif//SkRecordOpts_DEFINED
@@ -33,12 +33,13 @@ private:
 };
 
 // Matches any command that draws, and stores its paint.
+// Paints may be shared with other commands (see SharedPaint), so they're read-only here.
 class IsDraw {
     SK_CREATE_MEMBER_DETECTOR(paint);
 public:
     IsDraw() : fPaint(NULL) {}
 
-    typedef SkPaint type;
+    typedef const SkPaint type;
     type* get() { return fPaint; }
 
     template <typename T>
@@ -61,8 +62,8 @@ public:
 
 private:
     // Abstracts away whether the paint is always part of the command or optional.
-    template <typename T> static T* AsPtr(SkRecords::Optional<T>& x) { return x; }
-    template <typename T> static T* AsPtr(T& x) { return &x; }
+    static const SkPaint* AsPtr(SkRecords::Optional<SkPaint>& x) { return x; }
+    static const SkPaint* AsPtr(SkRecords::SharedPaint& x) { return x.get(); }
 
     type* fPaint;
 };
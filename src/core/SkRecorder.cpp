@@ -32,9 +32,12 @@ void SkRecorder::forgetRecord() {
 // non-trivial copy constructors, we skip the first copy (and its destruction) by wrapping the value
 // with delay_copy(), forcing the argument to be passed by const&.
 //
-// This is used below for SkBitmap, SkPaint, SkPath, and SkRegion, which all have non-trivial copy
+// This is used below for SkBitmap, SkPath, and SkRegion, which all have non-trivial copy
 // constructors and destructors.  You'll know you've got a good candidate T if you see ~T() show up
 // unexpectedly on a profile of record time.  Otherwise don't bother.
+//
+// SkPaints are a special case: most recordings reuse the same few paints over and over, so we
+// intern them into the SkRecord with internPaint() and have the records point to the shared copy.
 template <typename T>
 class Reference {
 public:
@@ -96,34 +99,34 @@ void SkRecorder::clear(SkColor color) {
 }
 
 void SkRecorder::drawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, delay_copy(paint));
+    APPEND(DrawPaint, fRecord->internPaint(paint));
 }
 
 void SkRecorder::drawPoints(PointMode mode,
                             size_t count,
                             const SkPoint pts[],
                             const SkPaint& paint) {
-    APPEND(DrawPoints, delay_copy(paint), mode, count, this->copy(pts, count));
+    APPEND(DrawPoints, fRecord->internPaint(paint), mode, count, this->copy(pts, count));
 }
 
 void SkRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
-    APPEND(DrawRect, delay_copy(paint), rect);
+    APPEND(DrawRect, fRecord->internPaint(paint), rect);
 }
 
 void SkRecorder::drawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, delay_copy(paint), oval);
+    APPEND(DrawOval, fRecord->internPaint(paint), oval);
 }
 
 void SkRecorder::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, delay_copy(paint), rrect);
+    APPEND(DrawRRect, fRecord->internPaint(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, delay_copy(paint), outer, inner);
+    APPEND(DrawDRRect, fRecord->internPaint(paint), outer, inner);
 }
 
 void SkRecorder::drawPath(const SkPath& path, const SkPaint& paint) {
-    APPEND(DrawPath, delay_copy(paint), delay_copy(path));
+    APPEND(DrawPath, fRecord->internPaint(paint), delay_copy(path));
 }
 
 void SkRecorder::drawBitmap(const SkBitmap& bitmap,
@@ -162,14 +165,18 @@ void SkRecorder::drawSprite(const SkBitmap& bitmap, int left, int top, const SkP
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           delay_copy(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
+           fRecord->internPaint(paint),
+           this->copy((const char*)text, byteLength),
+           byteLength,
+           x,
+           y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           delay_copy(paint),
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -179,7 +186,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           delay_copy(paint),
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(xpos, points),
@@ -189,7 +196,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           delay_copy(paint),
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            delay_copy(path),
@@ -198,7 +205,7 @@ void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkP
 
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
-    APPEND(DrawTextBlob, delay_copy(paint), blob, x, y);
+    APPEND(DrawTextBlob, fRecord->internPaint(paint), blob, x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
@@ -210,7 +217,7 @@ void SkRecorder::drawVertices(VertexMode vmode,
                               const SkPoint texs[], const SkColor colors[],
                               SkXfermode* xmode,
                               const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, delay_copy(paint),
+    APPEND(DrawVertices, fRecord->internPaint(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -223,7 +230,7 @@ void SkRecorder::drawVertices(VertexMode vmode,
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    APPEND(DrawPatch, delay_copy(paint),
+    APPEND(DrawPatch, fRecord->internPaint(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : NULL,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : NULL,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : NULL,
@@ -128,6 +128,8 @@ public:
     RefBox(T* obj) : fObj(SkSafeRef(obj)) {}
     ~RefBox() { SkSafeUnref(fObj); }
 
+    void reset(T* obj) { SkRefCnt_SafeAssign(fObj, obj); }
+
     ACT_AS_PTR(fObj);
 
 private:
@@ -196,6 +198,22 @@ private:
     SkBitmap fBitmap;
 };
 
+// A paint interned by SkRecord::internPaint().  Equal paints recorded into the same SkRecord share
+// a single copy owned by that SkRecord, so a SharedPaint is just a pointer to it.  Two SharedPaints
+// from the same SkRecord hold equal paints exactly when they point to the same SkPaint.
+class SharedPaint {
+public:
+    SharedPaint(const SkPaint* paint) : fPaint(paint) { SkASSERT(fPaint); }
+    // Default copy and assign.
+
+    operator const SkPaint& () const { return *fPaint; }
+    const SkPaint* operator->() const { return fPaint; }
+    const SkPaint* get() const { return fPaint; }
+
+private:
+    const SkPaint* fPaint;
+};
+
 RECORD0(NoOp);
 
 RECORD2(Restore, SkIRect, devBounds, SkMatrix, matrix);
@@ -218,7 +236,7 @@ RECORD1(BeginCommentGroup, PODArray<char>, description);
 RECORD2(AddComment, PODArray<char>, key, PODArray<char>, value);
 RECORD0(EndCommentGroup);
 
-// While not strictly required, if you have an SkPaint, it's fastest to put it first.
+// While not strictly required, if you have a paint, it's fastest to put it first.
 RECORD4(DrawBitmap, Optional<SkPaint>, paint,
                     ImmutableBitmap, bitmap,
                     SkScalar, left,
@@ -233,36 +251,36 @@ RECORD5(DrawBitmapRectToRect, Optional<SkPaint>, paint,
                               Optional<SkRect>, src,
                               SkRect, dst,
                               SkCanvas::DrawBitmapRectFlags, flags);
-RECORD3(DrawDRRect, SkPaint, paint, SkRRect, outer, SkRRect, inner);
-RECORD2(DrawOval, SkPaint, paint, SkRect, oval);
-RECORD1(DrawPaint, SkPaint, paint);
-RECORD2(DrawPath, SkPaint, paint, SkPath, path);
+RECORD3(DrawDRRect, SharedPaint, paint, SkRRect, outer, SkRRect, inner);
+RECORD2(DrawOval, SharedPaint, paint, SkRect, oval);
+RECORD1(DrawPaint, SharedPaint, paint);
+RECORD2(DrawPath, SharedPaint, paint, SkPath, path);
 RECORD3(DrawPicture, Optional<SkPaint>, paint,
                      RefBox<const SkPicture>, picture,
                      Optional<SkMatrix>, matrix);
-RECORD4(DrawPoints, SkPaint, paint, SkCanvas::PointMode, mode, size_t, count, SkPoint*, pts);
-RECORD4(DrawPosText, SkPaint, paint,
+RECORD4(DrawPoints, SharedPaint, paint, SkCanvas::PointMode, mode, size_t, count, SkPoint*, pts);
+RECORD4(DrawPosText, SharedPaint, paint,
                      PODArray<char>, text,
                      size_t, byteLength,
                      PODArray<SkPoint>, pos);
-RECORD5(DrawPosTextH, SkPaint, paint,
+RECORD5(DrawPosTextH, SharedPaint, paint,
                       PODArray<char>, text,
                       size_t, byteLength,
                       PODArray<SkScalar>, xpos,
                       SkScalar, y);
-RECORD2(DrawRRect, SkPaint, paint, SkRRect, rrect);
-RECORD2(DrawRect, SkPaint, paint, SkRect, rect);
+RECORD2(DrawRRect, SharedPaint, paint, SkRRect, rrect);
+RECORD2(DrawRect, SharedPaint, paint, SkRect, rect);
 RECORD4(DrawSprite, Optional<SkPaint>, paint, ImmutableBitmap, bitmap, int, left, int, top);
-RECORD5(DrawText, SkPaint, paint,
+RECORD5(DrawText, SharedPaint, paint,
                   PODArray<char>, text,
                   size_t, byteLength,
                   SkScalar, x,
                   SkScalar, y);
-RECORD4(DrawTextBlob, SkPaint, paint,
+RECORD4(DrawTextBlob, SharedPaint, paint,
                       RefBox<const SkTextBlob>, blob,
                       SkScalar, x,
                       SkScalar, y);
-RECORD5(DrawTextOnPath, SkPaint, paint,
+RECORD5(DrawTextOnPath, SharedPaint, paint,
                         PODArray<char>, text,
                         size_t, byteLength,
                         SkPath, path,
@@ -270,7 +288,7 @@ RECORD5(DrawTextOnPath, SkPaint, paint,
 
 RECORD2(DrawData, PODArray<char>, data, size_t, length);
 
-RECORD5(DrawPatch, SkPaint, paint,
+RECORD5(DrawPatch, SharedPaint, paint,
                    PODArray<SkPoint>, cubics,
                    PODArray<SkColor>, colors,
                    PODArray<SkPoint>, texCoords,
@@ -280,7 +298,7 @@ RECORD5(DrawPatch, SkPaint, paint,
 struct DrawVertices {
     static const Type kType = DrawVertices_Type;
 
-    DrawVertices(const SkPaint& paint,
+    DrawVertices(const SkPaint* paint,
                  SkCanvas::VertexMode vmode,
                  int vertexCount,
                  SkPoint* vertices,
@@ -299,7 +317,7 @@ struct DrawVertices {
         , indices(indices)
         , indexCount(indexCount) {}
 
-    SkPaint paint;
+    SharedPaint paint;
     SkCanvas::VertexMode vmode;
     int vertexCount;
     PODArray<SkPoint> vertices;
@@ -21,6 +21,11 @@
     #define SK_DEFAULT_IMAGE_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
+// Number of independently locked shards in the global cache.
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT    8
+#endif
+
 void SkResourceCache::Key::init(size_t length) {
     SkASSERT(SkAlign4(length) == length);
     // 2 is fCount32 and fHash
@@ -45,6 +50,7 @@ void SkResourceCache::init() {
     fCount = 0;
     fSingleAllocationByteLimit = 0;
     fAllocator = NULL;
+    fDiscardableCountLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
@@ -263,7 +269,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     int    countLimit;
 
     if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        countLimit = fDiscardableCountLimit;
         byteLimit = SK_MaxU32;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
@@ -418,8 +424,162 @@ size_t SkResourceCache::getSingleAllocationByteLimit() const {
 
 #include "SkThread.h"
 
+/**
+ *  The global cache: SK_RESOURCE_CACHE_SHARD_COUNT independent SkResourceCaches, each guarded
+ *  by its own mutex.  A Key always maps to the same shard (via its hash), so Find() and Add()
+ *  only ever lock that one shard.
+ *
+ *  Each shard owns 1/Nth of the total byte limit.  A shard may grow past its share while the
+ *  cache as a whole is under budget (so one large entry still fits), but once the total goes
+ *  over, the next add to a shard trims that shard back to its share.  In discardable mode the
+ *  entry count limit is split the same way.
+ */
+class SkShardedResourceCache : SkNoncopyable {
+public:
+    explicit SkShardedResourceCache(SkResourceCache::DiscardableFactory factory)
+        : fTotalByteLimit(0) {
+        for (int i = 0; i < kShardCount; ++i) {
+            fShards[i].fCache = SkNEW_ARGS(SkResourceCache, (factory));
+            fShards[i].fCache->fDiscardableCountLimit =
+                SkTMax(SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT / kShardCount, 2);
+            fShards[i].fBytesUsed = 0;
+        }
+    }
+
+    explicit SkShardedResourceCache(size_t byteLimit) : fTotalByteLimit(byteLimit) {
+        for (int i = 0; i < kShardCount; ++i) {
+            fShards[i].fCache = SkNEW_ARGS(SkResourceCache, (this->shareOf(byteLimit)));
+            fShards[i].fBytesUsed = 0;
+        }
+    }
+
+    ~SkShardedResourceCache() {
+        for (int i = 0; i < kShardCount; ++i) {
+            SkDELETE(fShards[i].fCache);
+        }
+    }
+
+    bool find(const SkResourceCache::Key& key, SkResourceCache::VisitorProc visitor,
+              void* context) {
+        Shard& shard = this->shardFor(key);
+        SkAutoMutexAcquire am(shard.fMutex);
+        bool found = shard.fCache->find(key, visitor, context);
+        shard.updateBytesUsed();    // a stale rec may have been purged
+        return found;
+    }
+
+    void add(SkResourceCache::Rec* rec) {
+        Shard& shard = this->shardFor(rec->getKey());
+        SkAutoMutexAcquire am(shard.fMutex);
+        SkResourceCache* cache = shard.fCache;
+        if (!cache->discardableFactory()) {
+            // Let this shard borrow whatever the other shards are not using right now.
+            size_t limit = sk_acquire_load(&fTotalByteLimit);
+            size_t share = this->shareOf(limit);
+            size_t used = this->getTotalBytesUsed() - shard.fBytesUsed;
+            size_t spare = limit > used ? limit - used : 0;
+            cache->fTotalByteLimit = SkTMax(share, spare);
+        }
+        cache->add(rec);
+        shard.updateBytesUsed();
+    }
+
+    // Sums each shard's last published usage without taking any locks, so it may be stale.
+    size_t getTotalBytesUsed() const {
+        size_t used = 0;
+        for (int i = 0; i < kShardCount; ++i) {
+            used += sk_acquire_load(&fShards[i].fBytesUsed);
+        }
+        return used;
+    }
+
+    size_t getTotalByteLimit() const {
+        return this->discardableFactory() ? 0 : sk_acquire_load(&fTotalByteLimit);
+    }
+
+    // Callers must serialize calls to setTotalByteLimit() and setSingleAllocationByteLimit().
+    size_t setTotalByteLimit(size_t newLimit) {
+        if (this->discardableFactory()) {
+            return 0;
+        }
+        size_t prevLimit = fTotalByteLimit;
+        sk_release_store(&fTotalByteLimit, newLimit);
+        for (int i = 0; i < kShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexAcquire am(shard.fMutex);
+            shard.fCache->setTotalByteLimit(this->shareOf(newLimit));
+            shard.updateBytesUsed();
+        }
+        return prevLimit;
+    }
+
+    size_t setSingleAllocationByteLimit(size_t newLimit) {
+        size_t oldLimit = 0;
+        for (int i = 0; i < kShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexAcquire am(shard.fMutex);
+            oldLimit = shard.fCache->setSingleAllocationByteLimit(newLimit);
+        }
+        return oldLimit;
+    }
+
+    size_t getSingleAllocationByteLimit() {
+        SkAutoMutexAcquire am(fShards[0].fMutex);
+        return fShards[0].fCache->getSingleAllocationByteLimit();
+    }
+
+    void purgeAll() {
+        for (int i = 0; i < kShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexAcquire am(shard.fMutex);
+            shard.fCache->purgeAll();
+            shard.updateBytesUsed();
+        }
+    }
+
+    // These never change after construction, so there is no need to lock.
+    SkResourceCache::DiscardableFactory discardableFactory() const {
+        return fShards[0].fCache->discardableFactory();
+    }
+    SkBitmap::Allocator* allocator() const { return fShards[0].fCache->allocator(); }
+
+    void dump() {
+        SkDebugf("SkResourceCache: %d shards\n", kShardCount);
+        for (int i = 0; i < kShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexAcquire am(shard.fMutex);
+            shard.fCache->dump();
+        }
+    }
+
+private:
+    static const int kShardCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+
+    struct Shard {
+        SkMutex          fMutex;
+        SkResourceCache* fCache;
+        size_t           fBytesUsed;    // Mirrors fCache->getTotalBytesUsed(), for lock-free reads.
+
+        // Must hold fMutex when calling.
+        void updateBytesUsed() { sk_release_store(&fBytesUsed, fCache->getTotalBytesUsed()); }
+
+        // Keep neighbouring shards' mutexes off of each other's cache lines.
+        char             fPad[64];
+    };
+
+    static size_t shareOf(size_t limit) { return limit / kShardCount; }
+
+    Shard& shardFor(const SkResourceCache::Key& key) {
+        // Key hashes are Murmur3, so the low bits are as good as any.
+        return fShards[key.hash() % kShardCount];
+    }
+
+    Shard  fShards[kShardCount];
+    size_t fTotalByteLimit;     // The global budget; each shard's own limit is derived from this.
+};
+
 SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = NULL;
+static SkShardedResourceCache* gResourceCache = NULL;
 static void cleanup_gResourceCache() {
     // We'll clean this up in our own tests, but disable for clients.
     // Chrome seems to have funky multi-process things going on in unit tests that
@@ -430,28 +590,30 @@ static void cleanup_gResourceCache() {
 #endif
 }
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (NULL == gResourceCache) {
+/** Thread-safe.  gMutex is only taken the first time, to create the cache. */
+static SkShardedResourceCache* get_cache() {
+    SkShardedResourceCache* cache = sk_acquire_load(&gResourceCache);
+    if (NULL == cache) {
+        SkAutoMutexAcquire am(gMutex);
+        if (NULL == gResourceCache) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
+            cache = SkNEW_ARGS(SkShardedResourceCache, (SkDiscardableMemory::Create));
 #else
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SK_DEFAULT_IMAGE_CACHE_LIMIT));
+            cache = SkNEW_ARGS(SkShardedResourceCache, (SK_DEFAULT_IMAGE_CACHE_LIMIT));
 #endif
-        atexit(cleanup_gResourceCache);
+            sk_release_store(&gResourceCache, cache);
+            atexit(cleanup_gResourceCache);
+        }
+        cache = gResourceCache;
     }
-    return gResourceCache;
+    return cache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
     return get_cache()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
     return get_cache()->getTotalByteLimit();
 }
 
@@ -461,17 +623,14 @@ size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
     return get_cache()->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
     return get_cache()->allocator();
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
     get_cache()->dump();
 }
 
@@ -481,22 +640,18 @@ size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
     return get_cache()->getSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    get_cache()->purgeAll();
 }
 
 bool SkResourceCache::Find(const Key& key, VisitorProc visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
     return get_cache()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
     get_cache()->add(rec);
 }
 
@@ -23,6 +23,9 @@ class SkMipMap;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  The global instance is split into shards, picked by Key::hash(), each with
+ *  its own mutex, LRU list and share of the byte budget, so that threads
+ *  working on different keys do not contend.
  */
 class SkResourceCache {
 public:
@@ -220,6 +223,7 @@ private:
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
+    int     fDiscardableCountLimit;
 
     void purgeAsNeeded(bool forcePurge = false);
 
@@ -231,6 +235,8 @@ private:
 
     void init();    // called by constructors
 
+    friend class SkShardedResourceCache;
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStreamingPictureRecorder.h"
+#include "SkPictureData.h"
+#include "SkPictureRecord.h"
+#include "SkStream.h"
+
+SkStreamingPictureRecorder::SkStreamingPictureRecorder()
+    : fStream(NULL)
+    , fEncoder(NULL)
+    , fHeaderOK(false) {}
+
+SkStreamingPictureRecorder::~SkStreamingPictureRecorder() {}
+
+SkCanvas* SkStreamingPictureRecorder::beginRecording(SkWStream* stream,
+                                                     SkScalar width, SkScalar height,
+                                                     SkPicture::EncodeBitmap encoder,
+                                                     size_t chunkSize) {
+    fStream = stream;
+    fEncoder = encoder;
+    fCullRect = SkRect::MakeWH(width, height);
+
+    // The same header SkPicture::serialize() writes, followed by "has playback data".
+    static const uint32_t kZero = 0;
+    SkPictInfo info;
+    SkPicture::CreateHeader(fCullRect, &info);
+    fHeaderOK = fStream->write(&info, sizeof(info)) && fStream->writeBool(true) &&
+                fStream->write(&kZero, SK_PICT_HEADER_PADDING);
+
+    fRecord.reset(SkNEW_ARGS(SkPictureRecord, (SkISize::Make(SkScalarCeilToInt(width),
+                                                             SkScalarCeilToInt(height)),
+                                               0/*flags*/)));
+    fRecord->setOpStream(fStream, chunkSize);
+    fRecord->beginRecording();
+    return this->getRecordingCanvas();
+}
+
+SkCanvas* SkStreamingPictureRecorder::getRecordingCanvas() {
+    return fRecord.get();
+}
+
+bool SkStreamingPictureRecorder::endRecording() {
+    SkASSERT(fRecord.get());
+    fRecord->endRecording();
+
+    // The ops not yet written go out as the last chunk, ahead of everything they refer to.
+    SkPictInfo info;
+    SkPicture::CreateHeader(fCullRect, &info);
+    {
+        SkPictureData data(*fRecord, info, false/*deepCopyOps*/);
+        data.serialize(fStream, fEncoder);
+    }
+    const bool ok = fHeaderOK && fRecord->opStreamOK();
+    fRecord.reset(NULL);
+    return ok;
+}
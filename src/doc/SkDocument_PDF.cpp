@@ -8,16 +8,20 @@
 #include "SkDocument.h"
 #include "SkPDFDocument.h"
 #include "SkPDFDevice.h"
+#include "SkPDFStreamingDocument.h"
 
 class SkDocument_PDF : public SkDocument {
 public:
     SkDocument_PDF(SkWStream* stream, void (*doneProc)(SkWStream*,bool),
                    SkPicture::EncodeBitmap encoder,
-                   SkScalar rasterDpi)
+                   SkScalar rasterDpi,
+                   bool streaming = false)
             : SkDocument(stream, doneProc)
             , fEncoder(encoder)
             , fRasterDpi(rasterDpi) {
-        fDoc = SkNEW(SkPDFDocument);
+        // Only one of fDoc and fStreamingDoc is used.
+        fDoc = streaming ? NULL : SkNEW(SkPDFDocument);
+        fStreamingDoc = streaming ? SkNEW_ARGS(SkPDFStreamingDocument, (stream)) : NULL;
         fCanvas = NULL;
         fDevice = NULL;
     }
@@ -52,7 +56,11 @@ protected:
         SkASSERT(fDevice);
 
         fCanvas->flush();
-        fDoc->appendPage(fDevice);
+        if (fStreamingDoc) {
+            fStreamingDoc->appendPage(fDevice);
+        } else {
+            fDoc->appendPage(fDevice);
+        }
 
         fCanvas->unref();
         fDevice->unref();
@@ -65,19 +73,24 @@ protected:
         SkASSERT(NULL == fCanvas);
         SkASSERT(NULL == fDevice);
 
-        bool success = fDoc->emitPDF(stream);
+        bool success = fStreamingDoc ? fStreamingDoc->close() : fDoc->emitPDF(stream);
         SkDELETE(fDoc);
         fDoc = NULL;
+        SkDELETE(fStreamingDoc);
+        fStreamingDoc = NULL;
         return success;
     }
 
     virtual void onAbort() SK_OVERRIDE {
         SkDELETE(fDoc);
         fDoc = NULL;
+        SkDELETE(fStreamingDoc);
+        fStreamingDoc = NULL;
     }
 
 private:
     SkPDFDocument*  fDoc;
+    SkPDFStreamingDocument* fStreamingDoc;
     SkPDFDevice*    fDevice;
     SkCanvas*       fCanvas;
     SkPicture::EncodeBitmap fEncoder;
@@ -92,6 +105,12 @@ SkDocument* SkDocument::CreatePDF(SkWStream* stream, void (*done)(SkWStream*,boo
     return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, done, enc, dpi)) : NULL;
 }
 
+SkDocument* SkDocument::CreateStreamingPDF(SkWStream* stream, void (*done)(SkWStream*,bool),
+                                           SkPicture::EncodeBitmap enc,
+                                           SkScalar dpi) {
+    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, done, enc, dpi, true)) : NULL;
+}
+
 static void delete_wstream(SkWStream* stream, bool aborted) {
     SkDELETE(stream);
 }
@@ -12,6 +12,7 @@
 #include "SkWriteBuffer.h"
 #include "SkGpuBlurUtils.h"
 #include "SkBlurImage_opts.h"
+#include "SkTaskGroup.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #endif
@@ -75,16 +76,23 @@ enum BlurDirection {
  *
  * For example, the 6 passes of the X-and-Y blur case are rewritten as
  * follows. Instead of 3 passes in X and 3 passes in Y, we perform
- * 2 passes in X, 1 pass in X transposed to Y on write, 2 passes in X,
- * then 1 pass in X transposed to Y on write.
+ * 3 passes in X and transpose, then 3 passes in X and transpose back.
  *
- * +----+       +----+       +----+        +---+       +---+       +---+        +----+
- * + AB + ----> | AB | ----> | AB | -----> | A | ----> | A | ----> | A | -----> | AB |
- * +----+ blurX +----+ blurX +----+ blurXY | B | blurX | B | blurX | B | blurXY +----+
- *                                         +---+       +---+       +---+
+ * +----+       +----+       +----+       +----+           +---+       +---+       +---+
+ * + AB + ----> | AB | ----> | AB | ----> | AB | --------> | A | ----> | A | ----> | A | ...
+ * +----+ blurX +----+ blurX +----+ blurX +----+ transpose | B | blurX | B | blurX | B |
+ *                                                         +---+       +---+       +---+
  *
- * In this way, two of the y-blurs become x-blurs applied to transposed
- * images, and all memory reads are contiguous.
+ * In this way, the y-blurs become x-blurs applied to the transposed image,
+ * and all blur reads are contiguous.
+ *
+ * Rows never affect each other in an x-blur, so the image is cut into bands
+ * of rows that are each taken through all three passes at once, in scratch
+ * memory small enough to stay in L2 cache between passes. The band is then
+ * written out, transposed a block of rows at a time so that writes are
+ * contiguous too. Bands are independent of each other, so they are spread
+ * across the SkTaskGroup threads. Each pass is a running sum, so the cost is
+ * the same for any sigma.
  */
 
 template<BlurDirection srcDirection, BlurDirection dstDirection>
@@ -141,6 +149,109 @@ static void boxBlur(const SkPMColor* src, int srcStride, SkPMColor* dst, int ker
     }
 }
 
+// Rows are blurred in bands of about this many pixels, so that a band and its scratch copies
+// stay in L2 cache from one pass to the next.
+static const int kBandPixels = 16 * 1024;
+
+static int band_rows(int width) {
+    return SkPin32(kBandPixels / width, 8, 64);
+}
+
+// Copies count rows of width pixels into columns of dst, so that src[y][x] lands in dst[x][y].
+static void transpose_rows(const SkPMColor* src, int srcStride, int width, int count,
+                           SkPMColor* dst, int dstStride) {
+    for (int x = 0; x < width; ++x) {
+        const SkPMColor* sptr = src + x;
+        for (int y = 0; y < count; ++y) {
+            dst[y] = *sptr;
+            sptr += srcStride;
+        }
+        dst += dstStride;
+    }
+}
+
+namespace {
+
+// The three box passes that approximate a Gaussian. See getBox3Params().
+struct Box3 {
+    int fKernelSize, fKernelSize3, fLowOffset, fHighOffset;
+};
+
+// Blurs each band of rows with three box passes and writes it to dst, transposed or not.
+class BlurBands {
+public:
+    BlurBands(SkBoxBlurProc boxBlurX, const Box3& box, const SkPMColor* src, int srcStride,
+              int width, int height, SkPMColor* dst, bool transpose)
+        : fBoxBlurX(boxBlurX)
+        , fBox(box)
+        , fSrc(src)
+        , fSrcStride(srcStride)
+        , fWidth(width)
+        , fHeight(height)
+        , fBandRows(band_rows(width))
+        , fDst(dst)
+        , fTranspose(transpose) {}
+
+    int bands() const { return (fHeight + fBandRows - 1) / fBandRows; }
+
+    void operator()(int band) {
+        const int top = band * fBandRows;
+        const int rows = SkMin32(fBandRows, fHeight - top);
+        const Box3& b = fBox;
+        SkAutoTMalloc<SkPMColor> scratch(2 * rows * fWidth);
+        SkPMColor* t = scratch.get();
+        SkPMColor* d = t + rows * fWidth;
+
+        fBoxBlurX(fSrc + top * fSrcStride, fSrcStride, t, b.fKernelSize,
+                  b.fLowOffset, b.fHighOffset, fWidth, rows);
+        fBoxBlurX(t, fWidth, d, b.fKernelSize, b.fHighOffset, b.fLowOffset, fWidth, rows);
+        if (fTranspose) {
+            fBoxBlurX(d, fWidth, t, b.fKernelSize3, b.fHighOffset, b.fHighOffset, fWidth, rows);
+            transpose_rows(t, fWidth, fWidth, rows, fDst + top, fHeight);
+        } else {
+            fBoxBlurX(d, fWidth, fDst + top * fWidth, b.fKernelSize3,
+                      b.fHighOffset, b.fHighOffset, fWidth, rows);
+        }
+    }
+
+private:
+    SkBoxBlurProc    fBoxBlurX;
+    const Box3&      fBox;
+    const SkPMColor* fSrc;
+    int              fSrcStride;
+    int              fWidth, fHeight, fBandRows;
+    SkPMColor*       fDst;
+    bool             fTranspose;
+};
+
+// Transposes each band of rows into dst.
+class TransposeBands {
+public:
+    TransposeBands(const SkPMColor* src, int srcStride, int width, int height, SkPMColor* dst)
+        : fSrc(src)
+        , fSrcStride(srcStride)
+        , fWidth(width)
+        , fHeight(height)
+        , fBandRows(band_rows(width))
+        , fDst(dst) {}
+
+    int bands() const { return (fHeight + fBandRows - 1) / fBandRows; }
+
+    void operator()(int band) {
+        const int top = band * fBandRows;
+        transpose_rows(fSrc + top * fSrcStride, fSrcStride, fWidth,
+                       SkMin32(fBandRows, fHeight - top), fDst + top, fHeight);
+    }
+
+private:
+    const SkPMColor* fSrc;
+    int              fSrcStride;
+    int              fWidth, fHeight, fBandRows;
+    SkPMColor*       fDst;
+};
+
+}  // namespace
+
 static void getBox3Params(SkScalar s, int *kernelSize, int* kernelSize3, int *lowOffset,
                           int *highOffset)
 {
@@ -187,10 +298,13 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
 
     SkVector sigma = mapSigma(fSigma, ctx.ctm());
 
-    int kernelSizeX, kernelSizeX3, lowOffsetX, highOffsetX;
-    int kernelSizeY, kernelSizeY3, lowOffsetY, highOffsetY;
-    getBox3Params(sigma.x(), &kernelSizeX, &kernelSizeX3, &lowOffsetX, &highOffsetX);
-    getBox3Params(sigma.y(), &kernelSizeY, &kernelSizeY3, &lowOffsetY, &highOffsetY);
+    Box3 boxX, boxY;
+    getBox3Params(sigma.x(), &boxX.fKernelSize, &boxX.fKernelSize3, &boxX.fLowOffset,
+                  &boxX.fHighOffset);
+    getBox3Params(sigma.y(), &boxY.fKernelSize, &boxY.fKernelSize3, &boxY.fLowOffset,
+                  &boxY.fHighOffset);
+    const int kernelSizeX = boxX.fKernelSize;
+    const int kernelSizeY = boxY.fKernelSize;
 
     if (kernelSizeX < 0 || kernelSizeY < 0) {
         return false;
@@ -203,8 +317,9 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
         return true;
     }
 
+    // Only needed to hold the transposed image between blurring in x and in y.
     SkBitmap temp;
-    if (!temp.tryAllocPixels(dst->info())) {
+    if (kernelSizeY > 0 && !temp.tryAllocPixels(dst->info())) {
         return false;
     }
 
@@ -212,33 +327,28 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
     offset->fY = srcBounds.fTop;
     srcBounds.offset(-srcOffset);
     const SkPMColor* s = src.getAddr32(srcBounds.left(), srcBounds.top());
-    SkPMColor* t = temp.getAddr32(0, 0);
+    SkPMColor* t = kernelSizeY > 0 ? temp.getAddr32(0, 0) : NULL;
     SkPMColor* d = dst->getAddr32(0, 0);
     int w = dstBounds.width(), h = dstBounds.height();
     int sw = src.rowBytesAsPixels();
     SkBoxBlurProc boxBlurX, boxBlurY, boxBlurXY, boxBlurYX;
     if (!SkBoxBlurGetPlatformProcs(&boxBlurX, &boxBlurY, &boxBlurXY, &boxBlurYX)) {
         boxBlurX = boxBlur<kX, kX>;
-        boxBlurY = boxBlur<kY, kY>;
-        boxBlurXY = boxBlur<kX, kY>;
-        boxBlurYX = boxBlur<kY, kX>;
     }
 
     if (kernelSizeX > 0 && kernelSizeY > 0) {
-        boxBlurX(s,  sw, t, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
-        boxBlurX(t,  w,  d, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
-        boxBlurXY(d, w,  t, kernelSizeX3, highOffsetX, highOffsetX, w, h);
-        boxBlurX(t,  h,  d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
-        boxBlurX(d,  h,  t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
-        boxBlurXY(t, h,  d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
+        BlurBands blurX(boxBlurX, boxX, s, sw, w, h, t, true);
+        sk_parallel_for(blurX.bands(), 1, blurX);
+        BlurBands blurY(boxBlurX, boxY, t, h, h, w, d, true);
+        sk_parallel_for(blurY.bands(), 1, blurY);
     } else if (kernelSizeX > 0) {
-        boxBlurX(s,  sw, d, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
-        boxBlurX(d,  w,  t, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
-        boxBlurX(t,  w,  d, kernelSizeX3, highOffsetX, highOffsetX, w, h);
+        BlurBands blurX(boxBlurX, boxX, s, sw, w, h, d, false);
+        sk_parallel_for(blurX.bands(), 1, blurX);
     } else if (kernelSizeY > 0) {
-        boxBlurYX(s, sw, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
-        boxBlurX(d,  h,  t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
-        boxBlurXY(t, h,  d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
+        TransposeBands transpose(s, sw, w, h, t);
+        sk_parallel_for(transpose.bands(), 1, transpose);
+        BlurBands blurY(boxBlurX, boxY, t, h, h, w, d, true);
+        sk_parallel_for(blurY.bands(), 1, blurY);
     }
     return true;
 }
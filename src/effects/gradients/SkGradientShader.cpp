@@ -11,6 +11,7 @@
 #include "SkTwoPointRadialGradient.h"
 #include "SkTwoPointConicalGradient.h"
 #include "SkSweepGradient.h"
+#include "SkResourceCache.h"
 
 void SkGradientShaderBase::Descriptor::flatten(SkWriteBuffer& buffer) const {
     buffer.writeColorArray(fColors, fCount);
@@ -374,13 +375,35 @@ SkGradientShaderBase::GradientShaderBaseContext::GradientShaderBaseContext(
     }
 }
 
+static SkGradientSpanProcs gPlatformSpanProcs;
+
+static void init_platform_span_procs() {
+    SkGradientGetPlatformProcs(&gPlatformSpanProcs);
+}
+
+const SkGradientSpanProcs& SkGradientShaderBase::PlatformSpanProcs() {
+    SK_DECLARE_STATIC_ONCE(once);
+    SkOnce(&once, init_platform_span_procs);
+    return gPlatformSpanProcs;
+}
+
 SkGradientShaderBase::GradientShaderCache::GradientShaderCache(
         U8CPU alpha, const SkGradientShaderBase& shader)
     : fCacheAlpha(alpha)
-    , fShader(shader)
+    , fColorCount(shader.fColorCount)
+    , fColors(shader.fColorCount)
+    , fGradFlags(shader.fGradFlags)
     , fCache16Inited(false)
     , fCache32Inited(false)
 {
+    memcpy(fColors.get(), shader.fOrigColors, fColorCount * sizeof(SkColor));
+    if (fColorCount > 2) {
+        fPos.reset(fColorCount);
+        for (int i = 0; i < fColorCount; i++) {
+            fPos[i] = shader.fRecs[i].fPos;
+        }
+    }
+
     // Only initialize the cache in getCache16/32.
     fCache16 = NULL;
     fCache32 = NULL;
@@ -596,19 +619,19 @@ void SkGradientShaderBase::GradientShaderCache::initCache16(GradientShaderCache*
     SkASSERT(NULL == cache->fCache16Storage);
     cache->fCache16Storage = (uint16_t*)sk_malloc_throw(allocSize);
     cache->fCache16 = cache->fCache16Storage;
-    if (cache->fShader.fColorCount == 2) {
-        Build16bitCache(cache->fCache16, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache16Count);
+    if (cache->fColorCount == 2) {
+        Build16bitCache(cache->fCache16, cache->fColors[0],
+                        cache->fColors[1], kCache16Count);
     } else {
-        Rec* rec = cache->fShader.fRecs;
+        const SkFixed* pos = cache->fPos.get();
         int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache16Shift;
+        for (int i = 1; i < cache->fColorCount; i++) {
+            int nextIndex = SkFixedToFFFF(pos[i]) >> kCache16Shift;
             SkASSERT(nextIndex < kCache16Count);
 
             if (nextIndex > prevIndex)
-                Build16bitCache(cache->fCache16 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1);
+                Build16bitCache(cache->fCache16 + prevIndex, cache->fColors[i-1],
+                                cache->fColors[i], nextIndex - prevIndex + 1);
             prevIndex = nextIndex;
         }
     }
@@ -628,34 +651,101 @@ void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache*
     SkASSERT(NULL == cache->fCache32PixelRef);
     cache->fCache32PixelRef = SkMallocPixelRef::NewAllocate(info, 0, NULL);
     cache->fCache32 = (SkPMColor*)cache->fCache32PixelRef->getAddr();
-    if (cache->fShader.fColorCount == 2) {
-        Build32bitCache(cache->fCache32, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache32Count, cache->fCacheAlpha,
-                        cache->fShader.fGradFlags);
+    if (cache->fColorCount == 2) {
+        Build32bitCache(cache->fCache32, cache->fColors[0],
+                        cache->fColors[1], kCache32Count, cache->fCacheAlpha,
+                        cache->fGradFlags);
     } else {
-        Rec* rec = cache->fShader.fRecs;
+        const SkFixed* pos = cache->fPos.get();
         int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
+        for (int i = 1; i < cache->fColorCount; i++) {
+            int nextIndex = SkFixedToFFFF(pos[i]) >> kCache32Shift;
             SkASSERT(nextIndex < kCache32Count);
 
             if (nextIndex > prevIndex)
-                Build32bitCache(cache->fCache32 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1,
-                                cache->fCacheAlpha, cache->fShader.fGradFlags);
+                Build32bitCache(cache->fCache32 + prevIndex, cache->fColors[i-1],
+                                cache->fColors[i], nextIndex - prevIndex + 1,
+                                cache->fCacheAlpha, cache->fGradFlags);
             prevIndex = nextIndex;
         }
     }
 }
 
+namespace {
+
+// Starts every GradientShaderCacheRec key, so that no other SkResourceCache client's key can
+// match one just by having the same length.
+static const uint32_t kGradientShaderCacheKeyTag = SkSetFourByteTag('g', 'r', 'a', 'd');
+
+// Holds a GradientShaderCache in SkResourceCache.  The key is the tag, then everything the cache's
+// tables are built from: [tag, alpha, flags, count, colors[], positions[]].  The tile mode is not
+// part of it, as the tables only cover 0..1.
+struct GradientShaderCacheRec : public SkResourceCache::Rec {
+    typedef SkGradientShaderBase::GradientShaderCache GradientShaderCache;
+
+    GradientShaderCacheRec(const Key& key, size_t keySize, GradientShaderCache* cache)
+        : fKeyStorage(keySize)
+        , fKeySize(keySize)
+        , fCache(SkRef(cache))
+    {
+        memcpy(fKeyStorage.get(), &key, keySize);
+    }
+
+    SkAutoMalloc                      fKeyStorage;
+    size_t                            fKeySize;
+    SkAutoTUnref<GradientShaderCache> fCache;
+
+    virtual const Key& getKey() const SK_OVERRIDE {
+        return *reinterpret_cast<const Key*>(fKeyStorage.get());
+    }
+    // Counts both tables, whether or not they have been built yet.
+    virtual size_t bytesUsed() const SK_OVERRIDE {
+        return sizeof(*this) + fKeySize + sizeof(GradientShaderCache) +
+               4 * SkGradientShaderBase::kCache32Count * sizeof(SkPMColor) +
+               2 * SkGradientShaderBase::kCache16Count * sizeof(uint16_t);
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextCache) {
+        const GradientShaderCacheRec& rec = static_cast<const GradientShaderCacheRec&>(baseRec);
+        *(GradientShaderCache**)contextCache = SkRef(rec.fCache.get());
+        return true;
+    }
+};
+
+}  // namespace
+
 /*
  *  The gradient holds a cache for the most recent value of alpha. Successive
- *  callers with the same alpha value will share the same cache.
+ *  callers with the same alpha value will share the same cache, as will other
+ *  gradients with the same colors, positions and flags.
  */
 SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::refCache(U8CPU alpha) const {
     SkAutoMutexAcquire ama(fCacheMutex);
     if (!fCache || fCache->getAlpha() != alpha) {
-        fCache.reset(SkNEW_ARGS(GradientShaderCache, (alpha, *this)));
+        const int posCount = fColorCount > 2 ? fColorCount : 0;
+        const size_t contentSize = (4 + fColorCount + posCount) * sizeof(uint32_t);
+        const size_t keySize = sizeof(SkResourceCache::Key) + contentSize;
+        SkAutoSTMalloc<32, uint32_t> keyStorage(keySize / sizeof(uint32_t));
+        SkResourceCache::Key* key = reinterpret_cast<SkResourceCache::Key*>(keyStorage.get());
+
+        uint32_t* content = static_cast<uint32_t*>(key->writableContents());
+        *content++ = kGradientShaderCacheKeyTag;
+        *content++ = alpha;
+        *content++ = fGradFlags;
+        *content++ = fColorCount;
+        memcpy(content, fOrigColors, fColorCount * sizeof(SkColor));
+        content += fColorCount;
+        for (int i = 0; i < posCount; i++) {
+            *content++ = fRecs[i].fPos;
+        }
+        key->init(contentSize);
+
+        GradientShaderCache* cache;
+        if (!SkResourceCache::Find(*key, GradientShaderCacheRec::Visitor, &cache)) {
+            cache = SkNEW_ARGS(GradientShaderCache, (alpha, *this));
+            SkResourceCache::Add(SkNEW_ARGS(GradientShaderCacheRec, (*key, keySize, cache)));
+        }
+        fCache.reset(cache);
     }
     // Increment the ref counter inside the mutex to ensure the returned pointer is still valid.
     // Otherwise, the pointer may have been overwritten on a different thread before the object's
@@ -755,6 +845,66 @@ void SkGradientShaderBase::commonAsAGradient(GradientInfo* info, bool flipGrad)
     }
 }
 
+static inline unsigned float_to_byte(float x) {
+    return (unsigned)(x + 0.5f);
+}
+
+SkPMColor SkGradientShaderBase::interpolateColor(SkScalar t, U8CPU alpha) const {
+    if (kRepeat_TileMode == fTileMode) {
+        t -= SkScalarFloorToScalar(t);
+    } else if (kMirror_TileMode == fTileMode) {
+        t -= 2 * SkScalarFloorToScalar(SkScalarHalf(t));
+        if (t > SK_Scalar1) {
+            t = 2 - t;
+        }
+    }
+    // Also catches the rounding of the tiling above, and sends NaN to an end.
+    t = SkScalarPin(t, 0, SK_Scalar1);
+
+    // Find the interval t lies in, using the same positions the cache is built from.
+    int i = 0;
+    SkScalar p0 = 0;
+    SkScalar p1 = SK_Scalar1;
+    if (fColorCount > 2) {
+        while (i < fColorCount - 2 && t > SkFixedToScalar(fRecs[i + 1].fPos)) {
+            i += 1;
+        }
+        p0 = SkFixedToScalar(fRecs[i].fPos);
+        p1 = SkFixedToScalar(fRecs[i + 1].fPos);
+    }
+    const float w = p1 > p0 ? (t - p0) / (p1 - p0) : 0;
+
+    const SkColor c0 = fOrigColors[i];
+    const SkColor c1 = fOrigColors[i + 1];
+    float a0 = SkColorGetA(c0), r0 = SkColorGetR(c0), g0 = SkColorGetG(c0), b0 = SkColorGetB(c0);
+    float a1 = SkColorGetA(c1), r1 = SkColorGetR(c1), g1 = SkColorGetG(c1), b1 = SkColorGetB(c1);
+
+    const bool interpInPremul = SkToBool(fGradFlags &
+                                         SkGradientShader::kInterpolateColorsInPremul_Flag);
+    if (interpInPremul) {
+        r0 *= a0 / 255; g0 *= a0 / 255; b0 *= a0 / 255;
+        r1 *= a1 / 255; g1 *= a1 / 255; b1 *= a1 / 255;
+    }
+    float a = a0 + (a1 - a0) * w;
+    float r = r0 + (r1 - r0) * w;
+    float g = g0 + (g1 - g0) * w;
+    float b = b0 + (b1 - b0) * w;
+
+    const float scale = alpha / 255.0f;
+    a *= scale;
+    if (interpInPremul) {
+        r *= scale; g *= scale; b *= scale;
+    } else {
+        r *= a / 255; g *= a / 255; b *= a / 255;
+    }
+
+    // Float rounding can leave a component a hair above alpha.
+    const unsigned aa = float_to_byte(a);
+    return SkPackARGB32(aa, SkTMin(float_to_byte(r), aa),
+                            SkTMin(float_to_byte(g), aa),
+                            SkTMin(float_to_byte(b), aa));
+}
+
 #ifndef SK_IGNORE_TO_STRING
 void SkGradientShaderBase::toString(SkString* str) const {
 
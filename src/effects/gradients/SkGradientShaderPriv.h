@@ -9,6 +9,7 @@
 #define SkGradientShaderPriv_DEFINED
 
 #include "SkGradientBitmapCache.h"
+#include "SkGradient_opts.h"
 #include "SkGradientShader.h"
 #include "SkClampRange.h"
 #include "SkColorPriv.h"
@@ -124,7 +125,9 @@ public:
     SkGradientShaderBase(const Descriptor& desc);
     virtual ~SkGradientShaderBase();
 
-    // The cache is initialized on-demand when getCache16/32 is called.
+    // The cache is initialized on-demand when getCache16/32 is called.  It keeps its own copy of
+    // the colors and positions it is built from, so that it can outlive the shader: gradients
+    // with the same colors, positions and flags share one through SkResourceCache.
     class GradientShaderCache : public SkRefCnt {
     public:
         GradientShaderCache(U8CPU alpha, const SkGradientShaderBase& shader);
@@ -148,7 +151,12 @@ public:
                                               // Larger than 8bits so we can store uninitialized
                                               // value.
 
-        const SkGradientShaderBase& fShader;
+        // Copied from the shader: its fOrigColors, its fRecs[].fPos if it has more than two
+        // colors, and its fGradFlags.
+        const int                   fColorCount;
+        SkAutoSTMalloc<4, SkColor>  fColors;
+        SkAutoSTMalloc<4, SkFixed>  fPos;
+        const uint32_t              fGradFlags;
 
         // Make sure we only initialize the caches once.
         bool    fCache16Inited, fCache32Inited;
@@ -218,6 +226,9 @@ public:
 
     uint32_t getGradFlags() const { return fGradFlags; }
 
+    // The SIMD span procs for this CPU, looked up once.  Any of them may be NULL.
+    static const SkGradientSpanProcs& PlatformSpanProcs();
+
 protected:
     SkGradientShaderBase(SkReadBuffer& );
     virtual void flatten(SkWriteBuffer&) const SK_OVERRIDE;
@@ -237,6 +248,10 @@ protected:
 
     void commonAsAGradient(GradientInfo*, bool flipGrad = false) const;
 
+    // For kHighQualityInterpolation_Flag: tiles t by fTileMode and interpolates the original
+    // colors at it in floating point, then scales by alpha.  Not dithered.
+    SkPMColor interpolateColor(SkScalar t, U8CPU alpha) const;
+
     virtual bool onAsLuminanceColor(SkColor*) const SK_OVERRIDE;
 
     /*
@@ -272,6 +287,8 @@ private:
 
     void initCommon();
 
+    friend class GradientShaderCacheTester;  // for unit testing
+
     typedef SkShader INHERITED;
 };
 
@@ -166,18 +166,27 @@ void shadeSpan_linear_clamp(TileProc proc, SkFixed dx, SkFixed fx,
         dstC += count;
     }
     if ((count = range.fCount1) > 0) {
-        int unroll = count >> 3;
         fx = range.fFx1;
-        for (int i = 0; i < unroll; i++) {
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-        }
-        if ((count &= 7) > 0) {
-            do {
-                NO_CHECK_ITER;
-            } while (--count != 0);
+        SkLinearGradientSpanProc simdProc = SkGradientShaderBase::PlatformSpanProcs().fLinearClamp;
+        if (simdProc) {
+            simdProc(fx, dx, dstC, cache, toggle, count);
+            dstC += count;
+            if (count & 1) {
+                toggle = next_dither_toggle(toggle);
+            }
+        } else {
+            int unroll = count >> 3;
+            for (int i = 0; i < unroll; i++) {
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+            }
+            if ((count &= 7) > 0) {
+                do {
+                    NO_CHECK_ITER;
+                } while (--count != 0);
+            }
         }
     }
     if ((count = range.fCount2) > 0) {
@@ -192,6 +201,11 @@ void shadeSpan_linear_mirror(TileProc proc, SkFixed dx, SkFixed fx,
                              SkPMColor* SK_RESTRICT dstC,
                              const SkPMColor* SK_RESTRICT cache,
                              int toggle, int count) {
+    SkLinearGradientSpanProc simdProc = SkGradientShaderBase::PlatformSpanProcs().fLinearMirror;
+    if (simdProc) {
+        simdProc(fx, dx, dstC, cache, toggle, count);
+        return;
+    }
     do {
         unsigned fi = mirror_8bits(fx >> 8);
         SkASSERT(fi <= 0xFF);
@@ -205,6 +219,11 @@ void shadeSpan_linear_repeat(TileProc proc, SkFixed dx, SkFixed fx,
         SkPMColor* SK_RESTRICT dstC,
         const SkPMColor* SK_RESTRICT cache,
         int toggle, int count) {
+    SkLinearGradientSpanProc simdProc = SkGradientShaderBase::PlatformSpanProcs().fLinearRepeat;
+    if (simdProc) {
+        simdProc(fx, dx, dstC, cache, toggle, count);
+        return;
+    }
     do {
         unsigned fi = repeat_8bits(fx >> 8);
         SkASSERT(fi <= 0xFF);
@@ -225,6 +244,20 @@ void SkLinearGradient::LinearGradientContext::shadeSpan(int x, int y, SkPMColor*
     SkPoint             srcPt;
     SkMatrix::MapXYProc dstProc = fDstToIndexProc;
     TileProc            proc = linearGradient.fTileProc;
+
+    if (linearGradient.fGradFlags & SkGradientShader::kHighQualityInterpolation_Flag) {
+        const unsigned alpha = this->getPaintAlpha();
+        SkScalar dstX = SkIntToScalar(x) + SK_ScalarHalf;
+        const SkScalar dstY = SkIntToScalar(y) + SK_ScalarHalf;
+        do {
+            dstProc(fDstToIndex, dstX, dstY, &srcPt);
+            *dstC++ = linearGradient.interpolateColor(srcPt.fX, alpha);
+            dstX += SK_Scalar1;
+        } while (--count != 0);
+        return;
+    }
+
+    // Only the cached paths below need the table, so HQ interpolation never builds it.
     const SkPMColor* SK_RESTRICT cache = fCache->getCache32();
     int                 toggle = init_dither_toggle(x, y);
 
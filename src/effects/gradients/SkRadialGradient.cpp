@@ -335,12 +335,15 @@ void shadeSpan_radial_clamp(SkScalar sfx, SkScalar sdx,
     SkFixed dx = SkScalarToFixed(sdx) >> 1;
     SkFixed fy = SkScalarToFixed(sfy) >> 1;
     SkFixed dy = SkScalarToFixed(sdy) >> 1;
+    SkRadialClampSpanProc simdProc = SkGradientShaderBase::PlatformSpanProcs().fRadialClamp;
     if ((count > 4) && radial_completely_pinned(fx, dx, fy, dy)) {
         unsigned fi = SkGradientShaderBase::kCache32Count - 1;
         sk_memset32_dither(dstC,
             cache[toggle + fi],
             cache[next_dither_toggle(toggle) + fi],
             count);
+    } else if (simdProc) {
+        simdProc(fx, dx, fy, dy, sqrt_table, dstC, cache, toggle, count);
     } else if ((count > 4) &&
                no_need_for_radial_pin(fx, dx, fy, dy, count)) {
         unsigned fi;
@@ -404,12 +407,22 @@ void shadeSpan_radial(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
 void shadeSpan_radial_mirror(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                              SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
                              int count, int toggle) {
+    SkRadialGradientSpanProc simdProc = SkGradientShaderBase::PlatformSpanProcs().fRadialMirror;
+    if (simdProc) {
+        simdProc(fx, dx, fy, dy, dstC, cache, toggle, count);
+        return;
+    }
     shadeSpan_radial<mirror_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle);
 }
 
 void shadeSpan_radial_repeat(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                              SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
                              int count, int toggle) {
+    SkRadialGradientSpanProc simdProc = SkGradientShaderBase::PlatformSpanProcs().fRadialRepeat;
+    if (simdProc) {
+        simdProc(fx, dx, fy, dy, dstC, cache, toggle, count);
+        return;
+    }
     shadeSpan_radial<repeat_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle);
 }
 
@@ -424,6 +437,20 @@ void SkRadialGradient::RadialGradientContext::shadeSpan(int x, int y,
     SkPoint             srcPt;
     SkMatrix::MapXYProc dstProc = fDstToIndexProc;
     TileProc            proc = radialGradient.fTileProc;
+
+    if (radialGradient.fGradFlags & SkGradientShader::kHighQualityInterpolation_Flag) {
+        const unsigned alpha = this->getPaintAlpha();
+        SkScalar dstX = SkIntToScalar(x) + SK_ScalarHalf;
+        const SkScalar dstY = SkIntToScalar(y) + SK_ScalarHalf;
+        do {
+            dstProc(fDstToIndex, dstX, dstY, &srcPt);
+            *dstC++ = radialGradient.interpolateColor(srcPt.length(), alpha);
+            dstX += SK_Scalar1;
+        } while (--count != 0);
+        return;
+    }
+
+    // Only the cached paths below need the table, so HQ interpolation never builds it.
     const SkPMColor* SK_RESTRICT cache = fCache->getCache32();
     int toggle = init_dither_toggle(x, y);
 
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapFilter_opts_AVX2.h"
+
+/* With the exception of the compilers that don't support it, we always build the
+ * AVX2 functions and enable the caller to determine AVX2 support.  However for
+ * compilers that do not support AVX2 we provide a stub implementation.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+#include <immintrin.h>
+
+typedef SkConvolutionFilter1D::ConvolutionFixed ConvolutionFixed;
+
+namespace {
+
+// Loads eight filter taps c0..c7, and spreads them into the pairs _mm256_madd_epi16() wants:
+// lo holds c0 c1 in each 32-bit lane of its low half and c4 c5 in its high half; hi holds
+// c2 c3 and c6 c7.  This reads all eight taps, so the filter values must be padded.
+inline void load_coefficients(const ConvolutionFixed* filterValues, __m256i* lo, __m256i* hi) {
+    const __m256i coeff = _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(filterValues)));
+    *lo = _mm256_permutevar8x32_epi32(coeff, _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2));
+    *hi = _mm256_permutevar8x32_epi32(coeff, _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3));
+}
+
+// Loads the first count (< 8) pixels at src, without touching any memory past them.
+inline __m256i load_pixels(const unsigned char* src, int count) {
+    const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(count),
+                                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    return _mm256_maskload_epi32(reinterpret_cast<const int*>(src), mask);
+}
+
+// Multiplies eight pixels by the eight taps from load_coefficients(), adding the products into
+// accum.  Each half of accum holds 32-bit sums for each of the four channels.
+inline void accumulate8(__m256i src8, __m256i coeffLo, __m256i coeffHi, __m256i* accum) {
+    // Interleave each pair of neighbouring pixels channel by channel, so that pixels 0 and 1
+    // become b0 b1 g0 g1 r0 r1 a0 a1 (and likewise for 2 and 3, 4 and 5, 6 and 7).
+    const __m256i kPairs = _mm256_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15,
+                                            0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i paired = _mm256_shuffle_epi8(src8, kPairs);
+
+    // [16] pixels 0 and 1 (and 4 and 5), then pixels 2 and 3 (and 6 and 7).
+    const __m256i lo = _mm256_unpacklo_epi8(paired, zero);
+    const __m256i hi = _mm256_unpackhi_epi8(paired, zero);
+
+    // [32] p0*c0 + p1*c1 for each channel, etc.
+    *accum = _mm256_add_epi32(*accum, _mm256_madd_epi16(lo, coeffLo));
+    *accum = _mm256_add_epi32(*accum, _mm256_madd_epi16(hi, coeffHi));
+}
+
+// Convolves the filterLength pixels at src with filterValues into a single pixel's sums.
+inline __m256i convolve_pixel(const unsigned char* src,
+                              const ConvolutionFixed* filterValues,
+                              int filterLength) {
+    __m256i accum = _mm256_setzero_si256();
+    __m256i coeffLo, coeffHi;
+    for (int filterX = 0; filterX < filterLength >> 3; filterX++) {
+        load_coefficients(filterValues, &coeffLo, &coeffHi);
+        accumulate8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+                    coeffLo, coeffHi, &accum);
+        src += 32;
+        filterValues += 8;
+    }
+    const int r = filterLength & 7;
+    if (r) {
+        // The extra taps we load may be anything, but they'll be multiplied by zero pixels.
+        load_coefficients(filterValues, &coeffLo, &coeffHi);
+        accumulate8(load_pixels(src, r), coeffLo, coeffHi, &accum);
+    }
+    return accum;
+}
+
+// Adds the two halves of accum, and stores them as one pixel just like the SSE2 code does.
+inline void store_pixel(__m256i accum, unsigned char* outRow) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(accum),
+                                _mm256_extracti128_si256(accum, 1));
+    sum = _mm_srai_epi32(sum, SkConvolutionFilter1D::kShiftBits);
+    sum = _mm_packs_epi32(sum, zero);
+    sum = _mm_packus_epi16(sum, zero);
+    *(reinterpret_cast<int*>(outRow)) = _mm_cvtsi128_si32(sum);
+}
+
+}  // namespace
+
+// Convolves horizontally along a single row, one output pixel and up to eight taps at a time.
+// Unlike the SSE2 version this never reads past the last pixel a filter covers.
+static void convolveHorizontally_AVX2(const unsigned char* srcData,
+                                      const SkConvolutionFilter1D& filter,
+                                      unsigned char* outRow,
+                                      bool /*hasAlpha*/) {
+    const int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        store_pixel(convolve_pixel(&srcData[filterOffset << 2], filterValues, filterLength),
+                    outRow);
+        outRow += 4;
+    }
+}
+
+// Convolves horizontally along four rows.  Same as convolveHorizontally_AVX2, but shares the
+// work of loading the filter taps between the rows.
+static void convolve4RowsHorizontally_AVX2(const unsigned char* srcData[4],
+                                           const SkConvolutionFilter1D& filter,
+                                           unsigned char* outRow[4]) {
+    const int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+
+        __m256i accum0 = _mm256_setzero_si256(),
+                accum1 = _mm256_setzero_si256(),
+                accum2 = _mm256_setzero_si256(),
+                accum3 = _mm256_setzero_si256();
+        __m256i coeffLo, coeffHi;
+
+        int start = filterOffset << 2;
+        for (int filterX = 0; filterX < filterLength >> 3; filterX++) {
+            load_coefficients(filterValues, &coeffLo, &coeffHi);
+#define ITERATION(src, accum) \
+            accumulate8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), \
+                        coeffLo, coeffHi, &accum)
+            ITERATION(srcData[0] + start, accum0);
+            ITERATION(srcData[1] + start, accum1);
+            ITERATION(srcData[2] + start, accum2);
+            ITERATION(srcData[3] + start, accum3);
+#undef ITERATION
+            start += 32;
+            filterValues += 8;
+        }
+
+        const int r = filterLength & 7;
+        if (r) {
+            load_coefficients(filterValues, &coeffLo, &coeffHi);
+            accumulate8(load_pixels(srcData[0] + start, r), coeffLo, coeffHi, &accum0);
+            accumulate8(load_pixels(srcData[1] + start, r), coeffLo, coeffHi, &accum1);
+            accumulate8(load_pixels(srcData[2] + start, r), coeffLo, coeffHi, &accum2);
+            accumulate8(load_pixels(srcData[3] + start, r), coeffLo, coeffHi, &accum3);
+        }
+
+        store_pixel(accum0, outRow[0]);
+        store_pixel(accum1, outRow[1]);
+        store_pixel(accum2, outRow[2]);
+        store_pixel(accum3, outRow[3]);
+        outRow[0] += 4;
+        outRow[1] += 4;
+        outRow[2] += 4;
+        outRow[3] += 4;
+    }
+}
+
+// Vertically convolves the eight pixels starting at column x of the rows, two rows at a time.
+template <bool hasAlpha>
+static __m256i convolve8Vertically(const ConvolutionFixed* filterValues,
+                                   int filterLength,
+                                   unsigned char* const* sourceDataRows,
+                                   int x) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    // Accumulated result for pixels 0 and 4, 1 and 5, 2 and 6, 3 and 7.
+    // 32 bits per channel.
+    __m256i accum0 = zero, accum1 = zero, accum2 = zero, accum3 = zero;
+
+    for (int filterY = 0; filterY < filterLength; filterY += 2) {
+        // [16] cj cj+1 cj cj+1 ... for rows j and j+1.  A missing last row gets a zero tap.
+        const bool pair = filterY + 1 < filterLength;
+        const __m256i coeff = _mm256_unpacklo_epi16(
+                _mm256_set1_epi16(filterValues[filterY]),
+                _mm256_set1_epi16(pair ? filterValues[filterY + 1] : 0));
+
+        // [8] a7 b7 g7 r7 ... a0 b0 g0 r0 from each row.
+        const __m256i src0 = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(&sourceDataRows[filterY][x << 2]));
+        const __m256i src1 = pair ? _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(&sourceDataRows[filterY + 1][x << 2])) : zero;
+
+        // Interleave the two rows byte by byte, so each 16-bit pair lines up with coeff.
+        // lo: pixels 0 and 1 (4 and 5), hi: pixels 2 and 3 (6 and 7).
+        const __m256i lo = _mm256_unpacklo_epi8(src0, src1);
+        const __m256i hi = _mm256_unpackhi_epi8(src0, src1);
+
+        accum0 = _mm256_add_epi32(accum0,
+                                  _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), coeff));
+        accum1 = _mm256_add_epi32(accum1,
+                                  _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), coeff));
+        accum2 = _mm256_add_epi32(accum2,
+                                  _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), coeff));
+        accum3 = _mm256_add_epi32(accum3,
+                                  _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), coeff));
+    }
+
+    // Shift right for fixed point implementation.
+    accum0 = _mm256_srai_epi32(accum0, SkConvolutionFilter1D::kShiftBits);
+    accum1 = _mm256_srai_epi32(accum1, SkConvolutionFilter1D::kShiftBits);
+    accum2 = _mm256_srai_epi32(accum2, SkConvolutionFilter1D::kShiftBits);
+    accum3 = _mm256_srai_epi32(accum3, SkConvolutionFilter1D::kShiftBits);
+
+    // Pack to 16 then 8 bits per channel with saturation.  Packing works within each 128-bit
+    // half, so the pixels come out in order: [8] p7 p6 p5 p4 | p3 p2 p1 p0.
+    accum0 = _mm256_packs_epi32(accum0, accum1);
+    accum2 = _mm256_packs_epi32(accum2, accum3);
+    accum0 = _mm256_packus_epi16(accum0, accum2);
+
+    if (hasAlpha) {
+        // Make sure the value of alpha channel is always larger than maximum
+        // value of color channels.
+        __m256i a = _mm256_srli_epi32(accum0, 8);
+        __m256i b = _mm256_max_epu8(a, accum0);  // Max of r and g.
+        a = _mm256_srli_epi32(accum0, 16);
+        b = _mm256_max_epu8(a, b);               // Max of r and g and b.
+        b = _mm256_slli_epi32(b, 24);
+        accum0 = _mm256_max_epu8(b, accum0);
+    } else {
+        // Set value of alpha channels to 0xFF.
+        accum0 = _mm256_or_si256(accum0, _mm256_set1_epi32(0xff000000));
+    }
+    return accum0;
+}
+
+// Does vertical convolution to produce one output row, eight pixels at a time.
+// Like the SSE2 version, this relies on the rows being padded to a multiple of 16 pixels,
+// as the last few pixels are convolved as a group of eight.
+template <bool hasAlpha>
+static void convolveVertically_AVX2(const ConvolutionFixed* filterValues,
+                                    int filterLength,
+                                    unsigned char* const* sourceDataRows,
+                                    int pixelWidth,
+                                    unsigned char* outRow) {
+    const int width = pixelWidth & ~7;
+    for (int outX = 0; outX < width; outX += 8) {
+        const __m256i pixels =
+            convolve8Vertically<hasAlpha>(filterValues, filterLength, sourceDataRows, outX);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(outRow), pixels);
+        outRow += 32;
+    }
+
+    if (pixelWidth & 7) {
+        int32_t pixels[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels),
+            convolve8Vertically<hasAlpha>(filterValues, filterLength, sourceDataRows, width));
+        memcpy(outRow, pixels, (pixelWidth & 7) * sizeof(int32_t));
+    }
+}
+
+static void convolveVertically_AVX2(const ConvolutionFixed* filterValues,
+                                    int filterLength,
+                                    unsigned char* const* sourceDataRows,
+                                    int pixelWidth,
+                                    unsigned char* outRow,
+                                    bool hasAlpha) {
+    if (hasAlpha) {
+        convolveVertically_AVX2<true>(filterValues, filterLength, sourceDataRows,
+                                      pixelWidth, outRow);
+    } else {
+        convolveVertically_AVX2<false>(filterValues, filterLength, sourceDataRows,
+                                       pixelWidth, outRow);
+    }
+}
+
+static void applySIMDPadding_AVX2(SkConvolutionFilter1D* filter) {
+    // load_coefficients() reads eight taps at a time, so it may read up to seven taps past the
+    // last filter.  Pad with zeros so those reads stay in bounds.
+    for (int i = 0; i < 8; ++i) {
+        filter->addFilterValue(static_cast<ConvolutionFixed>(0));
+    }
+}
+
+bool SkConvolutionGetPlatformProcs_AVX2(SkConvolutionProcs* procs) {
+    procs->fExtraHorizontalReads = 0;
+    procs->fConvolveVertically = &convolveVertically_AVX2;
+    procs->fConvolve4RowsHorizontally = &convolve4RowsHorizontally_AVX2;
+    procs->fConvolveHorizontally = &convolveHorizontally_AVX2;
+    procs->fApplySIMDPadding = &applySIMDPadding_AVX2;
+    return true;
+}
+
+#else  // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+bool SkConvolutionGetPlatformProcs_AVX2(SkConvolutionProcs*) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapFilter_opts_AVX2_DEFINED
+#define SkBitmapFilter_opts_AVX2_DEFINED
+
+#include "SkConvolver.h"
+
+// Replaces the convolution functions in procs with AVX2 versions, which work on eight pixels or
+// eight filter taps at a time.  Their results are identical to the SSE2 versions'.  Returns
+// false and leaves procs alone if the compiler couldn't build them.  The caller must check that
+// the CPU supports AVX2.
+bool SkConvolutionGetPlatformProcs_AVX2(SkConvolutionProcs* procs);
+
+#endif
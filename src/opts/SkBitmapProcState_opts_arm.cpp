@@ -233,3 +233,7 @@ void platformConvolutionProcs_arm(SkConvolutionProcs* procs) {
 void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs) {
     SK_ARM_NEON_WRAP(platformConvolutionProcs_arm)(procs);
 }
+
+void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs, int) {
+    PlatformConvolutionProcs(procs);
+}
@@ -395,3 +395,4 @@ void SkBitmapProcState::platformProcs() {
 }
 
 void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs*) {}
+void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs*, int) {}
@@ -26,3 +26,4 @@ void SkBitmapProcState::platformProcs() {}
 
 // empty implementation just uses default supplied function pointers
 void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs*) {}
+void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs*, int) {}
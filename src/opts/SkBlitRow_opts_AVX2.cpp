@@ -0,0 +1,337 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitRow_opts_AVX2.h"
+
+/* With the exception of the compilers that don't support it, we always build the
+ * AVX2 functions and enable the caller to determine AVX2 support.  However for
+ * compilers that do not support AVX2 we provide a stub implementation.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+#include <immintrin.h>
+#include "SkColorPriv.h"
+#include "SkUtils.h"
+
+// Each of these is a port of the SSE2 version in SkBlitRow_opts_SSE2.cpp to eight pixels at a
+// time; see there for a step-by-step commentary.  The 16-bit shuffles used to spread alpha work
+// within each 128-bit half, which is exactly what we want for four pixels per half.
+
+static void S32_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                     const SkPMColor* SK_RESTRICT src,
+                                     int count, U8CPU alpha) {
+    SkASSERT(alpha <= 255);
+    if (count <= 0) {
+        return;
+    }
+
+    uint32_t src_scale = SkAlpha255To256(alpha);
+    uint32_t dst_scale = 256 - src_scale;
+
+    if (count >= 8) {
+        SkASSERT(((size_t)dst & 0x03) == 0);
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = SkAlphaMulQ(*src, src_scale) + SkAlphaMulQ(*dst, dst_scale);
+            src++;
+            dst++;
+            count--;
+        }
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+        const __m256i ag_mask = _mm256_set1_epi32(0xFF00FF00);
+
+        // Move scale factors to upper byte of word
+        const __m256i src_scale_wide = _mm256_set1_epi16(src_scale << 8);
+        const __m256i dst_scale_wide = _mm256_set1_epi16(dst_scale << 8);
+        while (count >= 8) {
+            __m256i src_pixel = _mm256_loadu_si256(s);
+            __m256i dst_pixel = _mm256_load_si256(d);
+
+            __m256i src_rb = _mm256_and_si256(rb_mask, src_pixel);
+            src_rb = _mm256_mulhi_epu16(src_rb, src_scale_wide);
+            __m256i src_ag = _mm256_and_si256(ag_mask, src_pixel);
+            src_ag = _mm256_mulhi_epu16(src_ag, src_scale_wide);
+            src_ag = _mm256_and_si256(src_ag, ag_mask);
+
+            __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+            dst_rb = _mm256_mulhi_epu16(dst_rb, dst_scale_wide);
+            __m256i dst_ag = _mm256_and_si256(ag_mask, dst_pixel);
+            dst_ag = _mm256_mulhi_epu16(dst_ag, dst_scale_wide);
+            dst_ag = _mm256_and_si256(dst_ag, ag_mask);
+
+            src_pixel = _mm256_or_si256(src_rb, src_ag);
+            dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+
+            _mm256_store_si256(d, _mm256_add_epi8(src_pixel, dst_pixel));
+            s++;
+            d++;
+            count -= 8;
+        }
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+
+    while (count > 0) {
+        *dst = SkAlphaMulQ(*src, src_scale) + SkAlphaMulQ(*dst, dst_scale);
+        src++;
+        dst++;
+        count--;
+    }
+}
+
+static void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                       const SkPMColor* SK_RESTRICT src,
+                                       int count, U8CPU alpha) {
+    SkASSERT(alpha == 255);
+    if (count <= 0) {
+        return;
+    }
+
+    if (count >= 8) {
+        SkASSERT(((size_t)dst & 0x03) == 0);
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = SkPMSrcOver(*src, *dst);
+            src++;
+            dst++;
+            count--;
+        }
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+#ifdef SK_USE_ACCURATE_BLENDING
+        const __m256i c_128 = _mm256_set1_epi16(128);
+        const __m256i c_255 = _mm256_set1_epi16(255);
+        while (count >= 8) {
+            __m256i src_pixel = _mm256_loadu_si256(s);
+            __m256i dst_pixel = _mm256_load_si256(d);
+
+            __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+            __m256i dst_ag = _mm256_srli_epi16(dst_pixel, 8);
+
+            // 255 - src alpha, in both 16-bit halves of each pixel.
+            __m256i alpha = _mm256_srli_epi32(src_pixel, 24);
+            alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+            alpha = _mm256_sub_epi16(c_255, alpha);
+
+            dst_rb = _mm256_mullo_epi16(dst_rb, alpha);
+            dst_ag = _mm256_mullo_epi16(dst_ag, alpha);
+
+            // (x + (x >> 8) + 128) >> 8
+            __m256i dst_rb_low = _mm256_srli_epi16(dst_rb, 8);
+            __m256i dst_ag_low = _mm256_srli_epi16(dst_ag, 8);
+            dst_rb = _mm256_add_epi16(dst_rb, dst_rb_low);
+            dst_rb = _mm256_add_epi16(dst_rb, c_128);
+            dst_rb = _mm256_srli_epi16(dst_rb, 8);
+            dst_ag = _mm256_add_epi16(dst_ag, dst_ag_low);
+            dst_ag = _mm256_add_epi16(dst_ag, c_128);
+            dst_ag = _mm256_andnot_si256(rb_mask, dst_ag);
+
+            dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+            _mm256_store_si256(d, _mm256_add_epi8(src_pixel, dst_pixel));
+            s++;
+            d++;
+            count -= 8;
+        }
+#else
+        const __m256i c_256 = _mm256_set1_epi16(0x0100);
+        while (count >= 8) {
+            __m256i src_pixel = _mm256_loadu_si256(s);
+            __m256i dst_pixel = _mm256_load_si256(d);
+
+            __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+            __m256i dst_ag = _mm256_srli_epi16(dst_pixel, 8);
+
+            // 256 - src alpha, in both 16-bit halves of each pixel.
+            __m256i alpha = _mm256_srli_epi16(src_pixel, 8);
+            alpha = _mm256_shufflehi_epi16(alpha, 0xF5);
+            alpha = _mm256_shufflelo_epi16(alpha, 0xF5);
+            alpha = _mm256_sub_epi16(c_256, alpha);
+
+            dst_rb = _mm256_mullo_epi16(dst_rb, alpha);
+            dst_ag = _mm256_mullo_epi16(dst_ag, alpha);
+            dst_rb = _mm256_srli_epi16(dst_rb, 8);
+            dst_ag = _mm256_andnot_si256(rb_mask, dst_ag);
+
+            dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+            _mm256_store_si256(d, _mm256_add_epi8(src_pixel, dst_pixel));
+            s++;
+            d++;
+            count -= 8;
+        }
+#endif
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+
+    while (count > 0) {
+        *dst = SkPMSrcOver(*src, *dst);
+        src++;
+        dst++;
+        count--;
+    }
+}
+
+static void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                      const SkPMColor* SK_RESTRICT src,
+                                      int count, U8CPU alpha) {
+    SkASSERT(alpha <= 255);
+    if (count <= 0) {
+        return;
+    }
+
+    if (count >= 8) {
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = SkBlendARGB32(*src, *dst, alpha);
+            src++;
+            dst++;
+            count--;
+        }
+
+        uint32_t src_scale = SkAlpha255To256(alpha);
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        const __m256i src_scale_wide = _mm256_set1_epi16(src_scale << 8);
+        const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+        const __m256i c_256 = _mm256_set1_epi16(256);
+        while (count >= 8) {
+            __m256i src_pixel = _mm256_loadu_si256(s);
+            __m256i dst_pixel = _mm256_load_si256(d);
+
+            __m256i dst_rb = _mm256_and_si256(rb_mask, dst_pixel);
+            __m256i src_rb = _mm256_and_si256(rb_mask, src_pixel);
+            __m256i dst_ag = _mm256_srli_epi16(dst_pixel, 8);
+            __m256i src_ag = _mm256_srli_epi16(src_pixel, 8);
+
+            // 256 - src alpha * src_scale, in both 16-bit halves of each pixel.
+            __m256i dst_alpha = _mm256_shufflehi_epi16(src_ag, 0xF5);
+            dst_alpha = _mm256_shufflelo_epi16(dst_alpha, 0xF5);
+            dst_alpha = _mm256_mulhi_epu16(dst_alpha, src_scale_wide);
+            dst_alpha = _mm256_sub_epi16(c_256, dst_alpha);
+
+            dst_rb = _mm256_mullo_epi16(dst_rb, dst_alpha);
+            dst_ag = _mm256_mullo_epi16(dst_ag, dst_alpha);
+            src_rb = _mm256_mulhi_epu16(src_rb, src_scale_wide);
+            src_ag = _mm256_mulhi_epu16(src_ag, src_scale_wide);
+
+            dst_rb = _mm256_srli_epi16(dst_rb, 8);
+            dst_ag = _mm256_andnot_si256(rb_mask, dst_ag);
+            src_ag = _mm256_slli_epi16(src_ag, 8);
+
+            dst_pixel = _mm256_or_si256(dst_rb, dst_ag);
+            src_pixel = _mm256_or_si256(src_rb, src_ag);
+
+            _mm256_store_si256(d, _mm256_add_epi8(src_pixel, dst_pixel));
+            s++;
+            d++;
+            count -= 8;
+        }
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+
+    while (count > 0) {
+        *dst = SkBlendARGB32(*src, *dst, alpha);
+        src++;
+        dst++;
+        count--;
+    }
+}
+
+static void Color32_AVX2(SkPMColor dst[], const SkPMColor src[], int count,
+                         SkPMColor color) {
+    if (count <= 0) {
+        return;
+    }
+
+    if (0 == color) {
+        if (src != dst) {
+            memcpy(dst, src, count * sizeof(SkPMColor));
+        }
+        return;
+    }
+
+    unsigned colorA = SkGetPackedA32(color);
+    if (255 == colorA) {
+        sk_memset32(dst, color, count);
+        return;
+    }
+
+    unsigned scale = 256 - SkAlpha255To256(colorA);
+
+    if (count >= 8) {
+        SkASSERT(((size_t)dst & 0x03) == 0);
+        while (((size_t)dst & 0x1F) != 0) {
+            *dst = color + SkAlphaMulQ(*src, scale);
+            src++;
+            dst++;
+            count--;
+        }
+
+        const __m256i* s = reinterpret_cast<const __m256i*>(src);
+        __m256i* d = reinterpret_cast<__m256i*>(dst);
+        const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+        const __m256i src_scale_wide = _mm256_set1_epi16(scale);
+        const __m256i color_wide = _mm256_set1_epi32(color);
+        while (count >= 8) {
+            __m256i src_pixel = _mm256_loadu_si256(s);
+
+            __m256i src_rb = _mm256_and_si256(rb_mask, src_pixel);
+            __m256i src_ag = _mm256_srli_epi16(src_pixel, 8);
+            src_rb = _mm256_mullo_epi16(src_rb, src_scale_wide);
+            src_ag = _mm256_mullo_epi16(src_ag, src_scale_wide);
+            src_rb = _mm256_srli_epi16(src_rb, 8);
+            src_ag = _mm256_andnot_si256(rb_mask, src_ag);
+            src_pixel = _mm256_or_si256(src_rb, src_ag);
+
+            _mm256_store_si256(d, _mm256_add_epi8(color_wide, src_pixel));
+            s++;
+            d++;
+            count -= 8;
+        }
+        src = reinterpret_cast<const SkPMColor*>(s);
+        dst = reinterpret_cast<SkPMColor*>(d);
+    }
+
+    while (count > 0) {
+        *dst = color + SkAlphaMulQ(*src, scale);
+        src += 1;
+        dst += 1;
+        count--;
+    }
+}
+
+static SkBlitRow::Proc32 platform_32_procs_AVX2[] = {
+    NULL,                               // S32_Opaque,
+    S32_Blend_BlitRow32_AVX2,           // S32_Blend,
+    S32A_Opaque_BlitRow32_AVX2,         // S32A_Opaque
+    S32A_Blend_BlitRow32_AVX2,          // S32A_Blend,
+};
+
+SkBlitRow::Proc32 SkBlitRowGetPlatformProcs32_AVX2(unsigned flags) {
+    SkASSERT(flags < SK_ARRAY_COUNT(platform_32_procs_AVX2));
+    return platform_32_procs_AVX2[flags];
+}
+
+SkBlitRow::ColorProc SkBlitRowGetPlatformColorProc_AVX2() {
+    return Color32_AVX2;
+}
+
+#else  // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+SkBlitRow::Proc32 SkBlitRowGetPlatformProcs32_AVX2(unsigned) {
+    return NULL;
+}
+
+SkBlitRow::ColorProc SkBlitRowGetPlatformColorProc_AVX2() {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlitRow_opts_AVX2_DEFINED
+#define SkBlitRow_opts_AVX2_DEFINED
+
+#include "SkBlitRow.h"
+
+// These return AVX2 versions of the 32-bit blit row procs, which work on eight pixels at a time
+// and give the same results as the SSE2 versions.  They return NULL if there is no AVX2 version
+// for flags or the compiler couldn't build one.  The caller must check that the CPU supports AVX2.
+SkBlitRow::Proc32 SkBlitRowGetPlatformProcs32_AVX2(unsigned flags);
+SkBlitRow::ColorProc SkBlitRowGetPlatformColorProc_AVX2();
+
+#endif
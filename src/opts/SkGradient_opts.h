@@ -0,0 +1,49 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_DEFINED
+#define SkGradient_opts_DEFINED
+
+#include "SkColor.h"
+#include "SkFixed.h"
+#include "SkScalar.h"
+
+// Span procs for the inner loops of SkLinearGradient and SkRadialGradient.  Each writes count
+// colors from the 32-bit gradient cache to dst, reading pixel i from dither row toggle for even i
+// and toggle ^ kDitherStride32 for odd i, exactly as the portable loops do.
+
+// Pixel i uses index ((fx + i * dx) >> 8), tiled to 0..255.  For the clamp proc the caller has
+// already split off the pinned ends of the span, so every index lies in 0..255 untiled.
+typedef void (*SkLinearGradientSpanProc)(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                         const SkPMColor cache[], int toggle, int count);
+
+// Pixel i is at (fx + i * dx, fy + i * dy), in SkFixed halved so that the unit circle is 0x7FFF.
+// Its squared distance, pinned and shifted down to 11 bits, indexes sqrtTable for the cache index.
+typedef void (*SkRadialClampSpanProc)(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                                      const uint8_t sqrtTable[], SkPMColor dst[],
+                                      const SkPMColor cache[], int toggle, int count);
+
+// Pixel i is at (fx + i * dx, fy + i * dy), in unit circle space; its distance from the center
+// is tiled to pick the cache index.  Positions accumulate dx and dy one pixel at a time, exactly
+// as the portable loop's do, so the results are identical to it.
+typedef void (*SkRadialGradientSpanProc)(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                                         SkPMColor dst[], const SkPMColor cache[],
+                                         int toggle, int count);
+
+struct SkGradientSpanProcs {
+    SkLinearGradientSpanProc fLinearClamp;
+    SkLinearGradientSpanProc fLinearRepeat;
+    SkLinearGradientSpanProc fLinearMirror;
+    SkRadialClampSpanProc    fRadialClamp;
+    SkRadialGradientSpanProc fRadialRepeat;
+    SkRadialGradientSpanProc fRadialMirror;
+};
+
+// Fills in the procs there is a faster version of for this CPU, and sets the rest to NULL.
+void SkGradientGetPlatformProcs(SkGradientSpanProcs* procs);
+
+#endif
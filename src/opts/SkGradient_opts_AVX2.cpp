@@ -0,0 +1,168 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradient_opts_AVX2.h"
+
+/* With the exception of the compilers that don't support it, we always build the
+ * AVX2 functions and enable the caller to determine AVX2 support.  However for
+ * compilers that do not support AVX2 we provide a stub implementation.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+#include <immintrin.h>
+
+namespace {
+
+// SkGradientShaderBase::kDitherStride32: the distance between the cache's dither rows.
+const int kDitherStride = 256;
+
+// The dither rows of eight consecutive pixels, starting with an even one.
+inline __m256i dither_rows(int toggle) {
+    const int odd = toggle ^ kDitherStride;
+    return _mm256_setr_epi32(toggle, odd, toggle, odd, toggle, odd, toggle, odd);
+}
+
+// Writes cache[index] for the first n lanes of index.  Lanes past n may hold indices outside the
+// cache, so a short tail gathers and stores under a mask.
+inline void lookup(const SkPMColor cache[], __m256i index, SkPMColor dst[], int n) {
+    const int* table = reinterpret_cast<const int*>(cache);
+    if (8 == n) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                            _mm256_i32gather_epi32(table, index, 4));
+    } else {
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        const __m256i colors = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), table,
+                                                           index, mask, 4);
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(dst), mask, colors);
+    }
+}
+
+// Linear.  See SkGradient_opts_SSE2.cpp.
+
+struct ClampTile8 {
+    static __m256i Apply(__m256i x) { return x; }
+};
+
+struct RepeatTile8 {
+    static __m256i Apply(__m256i x) { return _mm256_and_si256(x, _mm256_set1_epi32(0xFF)); }
+};
+
+struct MirrorTile8 {
+    static __m256i Apply(__m256i x) {
+        const __m256i odd = _mm256_srai_epi32(_mm256_slli_epi32(x, 23), 31);
+        return _mm256_and_si256(_mm256_xor_si256(x, odd), _mm256_set1_epi32(0xFF));
+    }
+};
+
+template <typename Tile8>
+void linear_span_AVX2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                      const SkPMColor cache[], int toggle, int count) {
+    __m256i x = _mm256_add_epi32(_mm256_set1_epi32(fx),
+                                 _mm256_mullo_epi32(_mm256_set1_epi32(dx),
+                                                    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+    const __m256i step = _mm256_set1_epi32(8 * static_cast<uint32_t>(dx));
+    const __m256i rows = dither_rows(toggle);
+
+    while (count > 0) {
+        const __m256i index = _mm256_add_epi32(Tile8::Apply(_mm256_srai_epi32(x, 8)), rows);
+        const int n = SkMin32(count, 8);
+        lookup(cache, index, dst, n);
+        x = _mm256_add_epi32(x, step);
+        dst += n;
+        count -= n;
+    }
+}
+
+void linear_clamp_AVX2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                       const SkPMColor cache[], int toggle, int count) {
+    linear_span_AVX2<ClampTile8>(fx, dx, dst, cache, toggle, count);
+}
+
+void linear_repeat_AVX2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                        const SkPMColor cache[], int toggle, int count) {
+    linear_span_AVX2<RepeatTile8>(fx, dx, dst, cache, toggle, count);
+}
+
+void linear_mirror_AVX2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                        const SkPMColor cache[], int toggle, int count) {
+    linear_span_AVX2<MirrorTile8>(fx, dx, dst, cache, toggle, count);
+}
+
+// Radial.
+
+struct RepeatTile16 {
+    static __m256i Apply(__m256i x) { return _mm256_and_si256(x, _mm256_set1_epi32(0xFFFF)); }
+};
+
+struct MirrorTile16 {
+    static __m256i Apply(__m256i x) {
+        const __m256i odd = _mm256_srai_epi32(_mm256_slli_epi32(x, 15), 31);
+        return _mm256_and_si256(_mm256_xor_si256(x, odd), _mm256_set1_epi32(0xFFFF));
+    }
+};
+
+template <typename Tile16>
+void radial_span_AVX2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                      SkPMColor dst[], const SkPMColor cache[], int toggle, int count) {
+    const __m256i rows = dither_rows(toggle);
+    // As in radial_span_SSE2, positions accumulate one dx at a time, like the portable loop's.
+    const __m256 lanes = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 vdx = _mm256_set1_ps(dx), vdy = _mm256_set1_ps(dy);
+    __m256 x = _mm256_set1_ps(fx), y = _mm256_set1_ps(fy);
+    for (int i = 1; i < 8; ++i) {
+        const __m256 later = _mm256_cmp_ps(lanes, _mm256_set1_ps((float)i), _CMP_GE_OQ);
+        x = _mm256_add_ps(x, _mm256_and_ps(vdx, later));
+        y = _mm256_add_ps(y, _mm256_and_ps(vdy, later));
+    }
+
+    while (count > 0) {
+        const __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x),
+                                                         _mm256_mul_ps(y, y)));
+        const __m256i fixedDist = _mm256_cvttps_epi32(_mm256_mul_ps(dist,
+                                                                    _mm256_set1_ps(SK_Fixed1)));
+        const __m256i index = _mm256_add_epi32(_mm256_srli_epi32(Tile16::Apply(fixedDist), 8),
+                                               rows);
+        const int n = SkMin32(count, 8);
+        lookup(cache, index, dst, n);
+        for (int i = 0; i < 8; ++i) {
+            x = _mm256_add_ps(x, vdx);
+            y = _mm256_add_ps(y, vdy);
+        }
+        dst += n;
+        count -= n;
+    }
+}
+
+void radial_repeat_AVX2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                        SkPMColor dst[], const SkPMColor cache[], int toggle, int count) {
+    radial_span_AVX2<RepeatTile16>(fx, dx, fy, dy, dst, cache, toggle, count);
+}
+
+void radial_mirror_AVX2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                        SkPMColor dst[], const SkPMColor cache[], int toggle, int count) {
+    radial_span_AVX2<MirrorTile16>(fx, dx, fy, dy, dst, cache, toggle, count);
+}
+
+}  // namespace
+
+bool SkGradientGetPlatformProcs_AVX2(SkGradientSpanProcs* procs) {
+    procs->fLinearClamp = &linear_clamp_AVX2;
+    procs->fLinearRepeat = &linear_repeat_AVX2;
+    procs->fLinearMirror = &linear_mirror_AVX2;
+    procs->fRadialRepeat = &radial_repeat_AVX2;
+    procs->fRadialMirror = &radial_mirror_AVX2;
+    return true;
+}
+
+#else  // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+bool SkGradientGetPlatformProcs_AVX2(SkGradientSpanProcs*) {
+    return false;
+}
+
+#endif
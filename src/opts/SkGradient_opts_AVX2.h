@@ -0,0 +1,20 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_AVX2_DEFINED
+#define SkGradient_opts_AVX2_DEFINED
+
+#include "SkGradient_opts.h"
+
+// Replaces the linear and the float radial span procs with AVX2 versions, which work out eight
+// indices at a time and gather their colors from the cache.  Their results are identical to the
+// SSE2 versions'.  The radial clamp proc reads a byte table, which can't be gathered from, so the
+// SSE2 version stays in place for it.  Returns false and leaves procs alone if the compiler
+// couldn't build them.  The caller must check that the CPU supports AVX2.
+bool SkGradientGetPlatformProcs_AVX2(SkGradientSpanProcs* procs);
+
+#endif
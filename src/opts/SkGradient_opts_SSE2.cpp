@@ -0,0 +1,180 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkGradient_opts_SSE2.h"
+
+/* SSE2 versions of the gradient span loops, which work out four cache indices at a time.
+ * The portable versions are in src/effects/gradients/SkLinearGradient.cpp and
+ * SkRadialGradient.cpp.  SSE2 has no gather, so the cache reads themselves are scalar.
+ */
+
+// SkGradientShaderBase::kDitherStride32: the distance between the cache's dither rows.
+static const int kDitherStride = 256;
+
+// The dither rows of four consecutive pixels, starting with an even one.
+static inline __m128i dither_rows(int toggle) {
+    return _mm_setr_epi32(toggle, toggle ^ kDitherStride, toggle, toggle ^ kDitherStride);
+}
+
+// Writes cache[index] for the first n lanes of index.
+static inline void lookup(const SkPMColor cache[], __m128i index, SkPMColor dst[], int n) {
+    if (4 == n) {
+        dst[0] = cache[_mm_cvtsi128_si32(index)];
+        dst[1] = cache[_mm_cvtsi128_si32(_mm_srli_si128(index, 4))];
+        dst[2] = cache[_mm_cvtsi128_si32(_mm_srli_si128(index, 8))];
+        dst[3] = cache[_mm_cvtsi128_si32(_mm_srli_si128(index, 12))];
+    } else {
+        int32_t indices[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), index);
+        for (int i = 0; i < n; ++i) {
+            dst[i] = cache[indices[i]];
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Linear
+
+// Each Tile8 maps SkFixed >> 8 into 0..255, like repeat_8bits() and mirror_8bits().
+struct ClampTile8 {
+    static __m128i Apply(__m128i x) { return x; }
+};
+
+struct RepeatTile8 {
+    static __m128i Apply(__m128i x) { return _mm_and_si128(x, _mm_set1_epi32(0xFF)); }
+};
+
+struct MirrorTile8 {
+    static __m128i Apply(__m128i x) {
+        // Inverts x wherever its bit 8 is set.
+        const __m128i odd = _mm_srai_epi32(_mm_slli_epi32(x, 23), 31);
+        return _mm_and_si128(_mm_xor_si128(x, odd), _mm_set1_epi32(0xFF));
+    }
+};
+
+template <typename Tile8>
+static void linear_span_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                             const SkPMColor cache[], int toggle, int count) {
+    // Step in unsigned arithmetic, which wraps the way the portable loop's adds do.
+    const uint32_t ufx = fx, udx = dx;
+    __m128i x = _mm_setr_epi32(ufx, ufx + udx, ufx + 2 * udx, ufx + 3 * udx);
+    const __m128i step = _mm_set1_epi32(4 * udx);
+    const __m128i rows = dither_rows(toggle);
+
+    while (count > 0) {
+        const __m128i index = _mm_add_epi32(Tile8::Apply(_mm_srai_epi32(x, 8)), rows);
+        const int n = SkMin32(count, 4);
+        lookup(cache, index, dst, n);
+        x = _mm_add_epi32(x, step);
+        dst += n;
+        count -= n;
+    }
+}
+
+void SkLinearGradientClamp_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                const SkPMColor cache[], int toggle, int count) {
+    linear_span_SSE2<ClampTile8>(fx, dx, dst, cache, toggle, count);
+}
+
+void SkLinearGradientRepeat_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                 const SkPMColor cache[], int toggle, int count) {
+    linear_span_SSE2<RepeatTile8>(fx, dx, dst, cache, toggle, count);
+}
+
+void SkLinearGradientMirror_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                 const SkPMColor cache[], int toggle, int count) {
+    linear_span_SSE2<MirrorTile8>(fx, dx, dst, cache, toggle, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Radial
+
+void SkRadialGradientClamp_SSE2(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                                const uint8_t sqrtTable[], SkPMColor dst[],
+                                const SkPMColor cache[], int toggle, int count) {
+    const uint32_t ufx = fx, udx = dx, ufy = fy, udy = dy;
+    __m128i x = _mm_setr_epi32(ufx, ufx + udx, ufx + 2 * udx, ufx + 3 * udx);
+    __m128i y = _mm_setr_epi32(ufy, ufy + udy, ufy + 2 * udy, ufy + 3 * udy);
+    const __m128i stepX = _mm_set1_epi32(4 * udx);
+    const __m128i stepY = _mm_set1_epi32(4 * udy);
+    const int oddToggle = toggle ^ kDitherStride;
+
+    while (count > 0) {
+        // Packing to 16 bits saturates, which is the portable loop's pin to -0x8000..0x7FFF.
+        // The interleaved x, y pairs then square and sum in one madd.  The largest sum, 2^31,
+        // only overflows into the sign bit, so the logical shift still gets it right.
+        const __m128i xy = _mm_unpacklo_epi16(_mm_packs_epi32(x, x), _mm_packs_epi32(y, y));
+        __m128i index = _mm_srli_epi32(_mm_madd_epi16(xy, xy), 14 + 16 - 11);
+        // At most 2^12, so a 16-bit min is enough to pin to the 11-bit table.
+        index = _mm_min_epi16(index, _mm_set1_epi32(0x7FF));
+
+        int32_t indices[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), index);
+        const int n = SkMin32(count, 4);
+        for (int i = 0; i < n; ++i) {
+            dst[i] = cache[((i & 1) ? oddToggle : toggle) + sqrtTable[indices[i]]];
+        }
+        x = _mm_add_epi32(x, stepX);
+        y = _mm_add_epi32(y, stepY);
+        dst += n;
+        count -= n;
+    }
+}
+
+// Each Tile16 maps SkFixed into 0..0xFFFF, like repeat_tileproc() and mirror_tileproc().
+struct RepeatTile16 {
+    static __m128i Apply(__m128i x) { return _mm_and_si128(x, _mm_set1_epi32(0xFFFF)); }
+};
+
+struct MirrorTile16 {
+    static __m128i Apply(__m128i x) {
+        const __m128i odd = _mm_srai_epi32(_mm_slli_epi32(x, 15), 31);
+        return _mm_and_si128(_mm_xor_si128(x, odd), _mm_set1_epi32(0xFFFF));
+    }
+};
+
+template <typename Tile16>
+static void radial_span_SSE2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                             SkPMColor dst[], const SkPMColor cache[], int toggle, int count) {
+    const __m128i rows = dither_rows(toggle);
+    // The portable loop accumulates its position one dx at a time.  To round exactly as it does,
+    // lane i starts from fx with dx added i times, and each step adds dx four times.
+    const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+    const __m128 vdx = _mm_set1_ps(dx), vdy = _mm_set1_ps(dy);
+    __m128 x = _mm_set1_ps(fx), y = _mm_set1_ps(fy);
+    for (int i = 1; i < 4; ++i) {
+        const __m128 later = _mm_cmpge_ps(lanes, _mm_set1_ps((float)i));
+        x = _mm_add_ps(x, _mm_and_ps(vdx, later));
+        y = _mm_add_ps(y, _mm_and_ps(vdy, later));
+    }
+
+    while (count > 0) {
+        const __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        // Truncates, like SkFloatToFixed().
+        const __m128i fixedDist = _mm_cvttps_epi32(_mm_mul_ps(dist, _mm_set1_ps(SK_Fixed1)));
+        const __m128i index = _mm_add_epi32(_mm_srli_epi32(Tile16::Apply(fixedDist), 8), rows);
+        const int n = SkMin32(count, 4);
+        lookup(cache, index, dst, n);
+        for (int i = 0; i < 4; ++i) {
+            x = _mm_add_ps(x, vdx);
+            y = _mm_add_ps(y, vdy);
+        }
+        dst += n;
+        count -= n;
+    }
+}
+
+void SkRadialGradientRepeat_SSE2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                                 SkPMColor dst[], const SkPMColor cache[], int toggle, int count) {
+    radial_span_SSE2<RepeatTile16>(fx, dx, fy, dy, dst, cache, toggle, count);
+}
+
+void SkRadialGradientMirror_SSE2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                                 SkPMColor dst[], const SkPMColor cache[], int toggle, int count) {
+    radial_span_SSE2<MirrorTile16>(fx, dx, fy, dy, dst, cache, toggle, count);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_SSE2_DEFINED
+#define SkGradient_opts_SSE2_DEFINED
+
+#include "SkGradient_opts.h"
+
+void SkLinearGradientClamp_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                const SkPMColor cache[], int toggle, int count);
+void SkLinearGradientRepeat_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                 const SkPMColor cache[], int toggle, int count);
+void SkLinearGradientMirror_SSE2(SkFixed fx, SkFixed dx, SkPMColor dst[],
+                                 const SkPMColor cache[], int toggle, int count);
+
+void SkRadialGradientClamp_SSE2(SkFixed fx, SkFixed dx, SkFixed fy, SkFixed dy,
+                                const uint8_t sqrtTable[], SkPMColor dst[],
+                                const SkPMColor cache[], int toggle, int count);
+void SkRadialGradientRepeat_SSE2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                                 SkPMColor dst[], const SkPMColor cache[], int toggle, int count);
+void SkRadialGradientMirror_SSE2(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                                 SkPMColor dst[], const SkPMColor cache[], int toggle, int count);
+
+#endif
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkXfermode_opts_AVX2.h"
+
+/* With the exception of the compilers that don't support it, we always build the
+ * AVX2 functions and enable the caller to determine AVX2 support.  However for
+ * compilers that do not support AVX2 we provide a stub implementation.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+#include <immintrin.h>
+#include "SkColorPriv.h"
+#include "SkXfermode_opts_SSE2.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// 8 pixels AVX2 version functions.  These follow the SSE2 versions in
+// SkXfermode_opts_SSE2.cpp (and SkColor_opts_SSE2.h) operation for operation,
+// so they give the same results.
+////////////////////////////////////////////////////////////////////////////////
+
+static inline __m256i SkGetPackedA32_AVX2(const __m256i& src) {
+    return _mm256_srli_epi32(_mm256_slli_epi32(src, (24 - SK_A32_SHIFT)), 24);
+}
+
+static inline __m256i SkGetPackedR32_AVX2(const __m256i& src) {
+    return _mm256_srli_epi32(_mm256_slli_epi32(src, (24 - SK_R32_SHIFT)), 24);
+}
+
+static inline __m256i SkGetPackedG32_AVX2(const __m256i& src) {
+    return _mm256_srli_epi32(_mm256_slli_epi32(src, (24 - SK_G32_SHIFT)), 24);
+}
+
+static inline __m256i SkGetPackedB32_AVX2(const __m256i& src) {
+    return _mm256_srli_epi32(_mm256_slli_epi32(src, (24 - SK_B32_SHIFT)), 24);
+}
+
+static inline __m256i SkPackARGB32_AVX2(const __m256i& a, const __m256i& r,
+                                        const __m256i& g, const __m256i& b) {
+    __m256i c = _mm256_or_si256(_mm256_slli_epi32(a, SK_A32_SHIFT),
+                                _mm256_slli_epi32(r, SK_R32_SHIFT));
+    c = _mm256_or_si256(c, _mm256_slli_epi32(g, SK_G32_SHIFT));
+    return _mm256_or_si256(c, _mm256_slli_epi32(b, SK_B32_SHIFT));
+}
+
+static inline __m256i SkAlpha255To256_AVX2(const __m256i& alpha) {
+    return _mm256_add_epi32(alpha, _mm256_set1_epi32(1));
+}
+
+// See SkAlphaMulAlpha_SSE2().  a and b are 0..255, so the product fits in 16 bits.
+static inline __m256i SkAlphaMulAlpha_AVX2(const __m256i& a, const __m256i& b) {
+    __m256i prod = _mm256_mullo_epi16(a, b);
+    prod = _mm256_add_epi32(prod, _mm256_set1_epi32(128));
+    prod = _mm256_add_epi32(prod, _mm256_srli_epi32(prod, 8));
+    return _mm256_srli_epi32(prod, 8);
+}
+
+// See SkAlphaMulQ_SSE2().
+static inline __m256i SkAlphaMulQ_AVX2(const __m256i& c, const __m256i& scale) {
+    const __m256i mask = _mm256_set1_epi32(0xFF00FF);
+    __m256i s = _mm256_or_si256(_mm256_slli_epi32(scale, 16), scale);
+
+    __m256i rb = _mm256_and_si256(mask, c);
+    rb = _mm256_mullo_epi16(rb, s);
+    rb = _mm256_srli_epi16(rb, 8);
+
+    __m256i ag = _mm256_srli_epi16(c, 8);
+    ag = _mm256_and_si256(ag, mask);
+    ag = _mm256_mullo_epi16(ag, s);
+
+    rb = _mm256_and_si256(mask, rb);
+    ag = _mm256_andnot_si256(mask, ag);
+    return _mm256_or_si256(rb, ag);
+}
+
+// a and b are 0..255, so this is the same as saturated_add_SSE2().
+static inline __m256i saturated_add_AVX2(const __m256i& a, const __m256i& b) {
+    return _mm256_min_epi32(_mm256_add_epi32(a, b), _mm256_set1_epi32(255));
+}
+
+static inline __m256i srcover_byte_AVX2(const __m256i& a, const __m256i& b) {
+    // a + b - SkAlphaMulAlpha(a, b);
+    return _mm256_sub_epi32(_mm256_add_epi32(a, b), SkAlphaMulAlpha_AVX2(a, b));
+}
+
+static __m256i srcover_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(src));
+    return _mm256_add_epi32(src, SkAlphaMulQ_AVX2(dst, isa));
+}
+
+static __m256i dstover_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(dst));
+    return _mm256_add_epi32(dst, SkAlphaMulQ_AVX2(src, ida));
+}
+
+static __m256i srcin_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    return SkAlphaMulQ_AVX2(src, SkAlpha255To256_AVX2(da));
+}
+
+static __m256i dstin_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    return SkAlphaMulQ_AVX2(dst, SkAlpha255To256_AVX2(sa));
+}
+
+static __m256i srcout_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(dst));
+    return SkAlphaMulQ_AVX2(src, ida);
+}
+
+static __m256i dstout_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(256), SkGetPackedA32_AVX2(src));
+    return SkAlphaMulQ_AVX2(dst, isa);
+}
+
+// Returns SkAlphaMulAlpha(x, s) + SkAlphaMulAlpha(y, d) for each color channel, for the atop
+// and xor modes.
+static inline __m256i lerp_channels_AVX2(const __m256i& a,
+                                         const __m256i& x, const __m256i& s,
+                                         const __m256i& y, const __m256i& d) {
+    __m256i r = _mm256_add_epi32(SkAlphaMulAlpha_AVX2(x, SkGetPackedR32_AVX2(s)),
+                                 SkAlphaMulAlpha_AVX2(y, SkGetPackedR32_AVX2(d)));
+    __m256i g = _mm256_add_epi32(SkAlphaMulAlpha_AVX2(x, SkGetPackedG32_AVX2(s)),
+                                 SkAlphaMulAlpha_AVX2(y, SkGetPackedG32_AVX2(d)));
+    __m256i b = _mm256_add_epi32(SkAlphaMulAlpha_AVX2(x, SkGetPackedB32_AVX2(s)),
+                                 SkAlphaMulAlpha_AVX2(y, SkGetPackedB32_AVX2(d)));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+static __m256i srcatop_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+    return lerp_channels_AVX2(da, da, src, isa, dst);
+}
+
+static __m256i dstatop_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+    return lerp_channels_AVX2(sa, ida, src, sa, dst);
+}
+
+static __m256i xor_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i sa = SkGetPackedA32_AVX2(src);
+    __m256i da = SkGetPackedA32_AVX2(dst);
+    __m256i isa = _mm256_sub_epi32(_mm256_set1_epi32(255), sa);
+    __m256i ida = _mm256_sub_epi32(_mm256_set1_epi32(255), da);
+
+    __m256i a1 = _mm256_add_epi32(sa, da);
+    __m256i a2 = _mm256_slli_epi32(SkAlphaMulAlpha_AVX2(sa, da), 1);
+    __m256i a = _mm256_sub_epi32(a1, a2);
+
+    return lerp_channels_AVX2(a, ida, src, isa, dst);
+}
+
+static __m256i plus_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i b = saturated_add_AVX2(SkGetPackedB32_AVX2(src), SkGetPackedB32_AVX2(dst));
+    __m256i g = saturated_add_AVX2(SkGetPackedG32_AVX2(src), SkGetPackedG32_AVX2(dst));
+    __m256i r = saturated_add_AVX2(SkGetPackedR32_AVX2(src), SkGetPackedR32_AVX2(dst));
+    __m256i a = saturated_add_AVX2(SkGetPackedA32_AVX2(src), SkGetPackedA32_AVX2(dst));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+static __m256i modulate_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i a = SkAlphaMulAlpha_AVX2(SkGetPackedA32_AVX2(src), SkGetPackedA32_AVX2(dst));
+    __m256i r = SkAlphaMulAlpha_AVX2(SkGetPackedR32_AVX2(src), SkGetPackedR32_AVX2(dst));
+    __m256i g = SkAlphaMulAlpha_AVX2(SkGetPackedG32_AVX2(src), SkGetPackedG32_AVX2(dst));
+    __m256i b = SkAlphaMulAlpha_AVX2(SkGetPackedB32_AVX2(src), SkGetPackedB32_AVX2(dst));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+static __m256i screen_modeproc_AVX2(const __m256i& src, const __m256i& dst) {
+    __m256i a = srcover_byte_AVX2(SkGetPackedA32_AVX2(src), SkGetPackedA32_AVX2(dst));
+    __m256i r = srcover_byte_AVX2(SkGetPackedR32_AVX2(src), SkGetPackedR32_AVX2(dst));
+    __m256i g = srcover_byte_AVX2(SkGetPackedG32_AVX2(src), SkGetPackedG32_AVX2(dst));
+    __m256i b = srcover_byte_AVX2(SkGetPackedB32_AVX2(src), SkGetPackedB32_AVX2(dst));
+    return SkPackARGB32_AVX2(a, r, g, b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef __m256i (*SkXfermodeProcAVX2)(const __m256i& src, const __m256i& dst);
+
+// Defined in SkXfermode_opts_SSE2.cpp.
+typedef __m128i (*SkXfermodeProcSIMD)(const __m128i& src, const __m128i& dst);
+extern SkXfermodeProcSIMD gSSE2XfermodeProcs[];
+
+// Only xfer32() has an AVX2 loop.  xfer16() and rows with coverage go through the SSE2 code.
+class SkAVX2ProcCoeffXfermode : public SkSSE2ProcCoeffXfermode {
+public:
+    SkAVX2ProcCoeffXfermode(const ProcCoeff& rec, SkXfermode::Mode mode,
+                            void* procSSE2, SkXfermodeProcAVX2 procAVX2)
+        : INHERITED(rec, mode, procSSE2), fProcAVX2(procAVX2) {}
+
+    virtual void xfer32(SkPMColor dst[], const SkPMColor src[], int count,
+                        const SkAlpha aa[]) const SK_OVERRIDE {
+        SkASSERT(dst && src && count >= 0);
+
+        if (NULL == aa && count >= 8) {
+            SkXfermodeProc proc = this->getProc();
+            while (((size_t)dst & 0x1F) != 0) {
+                *dst = proc(*src, *dst);
+                dst++;
+                src++;
+                count--;
+            }
+
+            const __m256i* s = reinterpret_cast<const __m256i*>(src);
+            __m256i* d = reinterpret_cast<__m256i*>(dst);
+
+            while (count >= 8) {
+                __m256i src_pixel = _mm256_loadu_si256(s++);
+                __m256i dst_pixel = _mm256_load_si256(d);
+
+                dst_pixel = fProcAVX2(src_pixel, dst_pixel);
+                _mm256_store_si256(d++, dst_pixel);
+                count -= 8;
+            }
+
+            src = reinterpret_cast<const SkPMColor*>(s);
+            dst = reinterpret_cast<SkPMColor*>(d);
+        }
+
+        this->INHERITED::xfer32(dst, src, count, aa);
+    }
+
+private:
+    SkXfermodeProcAVX2 fProcAVX2;
+
+    typedef SkSSE2ProcCoeffXfermode INHERITED;
+};
+
+// 8 pixels modeprocs with AVX2
+static const SkXfermodeProcAVX2 gAVX2XfermodeProcs[] = {
+    NULL, // kClear_Mode
+    NULL, // kSrc_Mode
+    NULL, // kDst_Mode
+    srcover_modeproc_AVX2,
+    dstover_modeproc_AVX2,
+    srcin_modeproc_AVX2,
+    dstin_modeproc_AVX2,
+    srcout_modeproc_AVX2,
+    dstout_modeproc_AVX2,
+    srcatop_modeproc_AVX2,
+    dstatop_modeproc_AVX2,
+    xor_modeproc_AVX2,
+    plus_modeproc_AVX2,
+    modulate_modeproc_AVX2,
+    screen_modeproc_AVX2,
+};
+
+SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_AVX2(const ProcCoeff& rec,
+                                                         SkXfermode::Mode mode) {
+    if ((size_t)mode >= SK_ARRAY_COUNT(gAVX2XfermodeProcs) || NULL == gAVX2XfermodeProcs[mode]) {
+        return NULL;
+    }
+    void* procSSE2 = reinterpret_cast<void*>(gSSE2XfermodeProcs[mode]);
+    SkASSERT(procSSE2 != NULL);
+    return SkNEW_ARGS(SkAVX2ProcCoeffXfermode, (rec, mode, procSSE2, gAVX2XfermodeProcs[mode]));
+}
+
+#else  // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_AVX2(const ProcCoeff&, SkXfermode::Mode) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkXfermode_opts_AVX2_DEFINED
+#define SkXfermode_opts_AVX2_DEFINED
+
+#include "SkTypes.h"
+#include "SkXfermode_proccoeff.h"
+
+// Returns an xfermode whose xfer32() works on eight pixels at a time for the Porter-Duff modes
+// (plus Plus, Modulate and Screen), falling back to the SSE2 code for 565 and for the last few
+// pixels of a row.  Results match the SSE2 xfermode's.  Returns NULL for the other modes, or if
+// the compiler couldn't build the AVX2 code.  The caller must check that the CPU supports AVX2.
+SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_AVX2(const ProcCoeff& rec,
+                                                         SkXfermode::Mode mode);
+
+#endif // SkXfermode_opts_AVX2_DEFINED
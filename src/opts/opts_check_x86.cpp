@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapFilter_opts_AVX2.h"
 #include "SkBitmapFilter_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSSE3.h"
@@ -12,22 +13,31 @@
 #include "SkBlitMask.h"
 #include "SkBlitRect_opts_SSE2.h"
 #include "SkBlitRow.h"
+#include "SkBlitRow_opts_AVX2.h"
 #include "SkBlitRow_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE4.h"
 #include "SkBlurImage_opts_SSE2.h"
 #include "SkBlurImage_opts_SSE4.h"
+#include "SkGradient_opts.h"
+#include "SkGradient_opts_AVX2.h"
+#include "SkGradient_opts_SSE2.h"
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
 #include "SkRTConf.h"
 #include "SkUtils.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkXfermode.h"
+#include "SkXfermode_opts_AVX2.h"
 #include "SkXfermode_proccoeff.h"
 
 #if defined(_MSC_VER) && defined(_WIN64)
 #include <intrin.h>
 #endif
 
+#if defined(_MSC_VER)
+#include <immintrin.h>  // For _xgetbv().
+#endif
+
 /* This file must *not* be compiled with -msse or any other optional SIMD
    extension, otherwise gcc may generate SIMD instructions even for scalar ops
    (and thus give an invalid instruction on Pentium3 on the code below).
@@ -39,10 +49,11 @@
 #ifdef _MSC_VER
 static inline void getcpuid(int info_type, int info[4]) {
 #if defined(_WIN64)
-    __cpuid(info, info_type);
+    __cpuidex(info, info_type, 0);
 #else
     __asm {
         mov    eax, [info_type]
+        xor    ecx, ecx
         cpuid
         mov    edi, [info]
         mov    [edi], eax
@@ -57,7 +68,7 @@ static inline void getcpuid(int info_type, int info[4]) {
     asm volatile (
         "cpuid \n\t"
         : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #else
@@ -69,11 +80,46 @@ static inline void getcpuid(int info_type, int info[4]) {
         "movl %%ebx, %1   \n\t"
         "popl %%ebx       \n\t"
         : "=a"(info[0]), "=r"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #endif
 
+/* Read the XCR0 register, which says which register state the OS saves for us.
+ * Only call this if CPUID says the OS has enabled XSAVE (OSXSAVE).
+ */
+#ifdef _MSC_VER
+static inline uint64_t getxcr0() {
+    return _xgetbv(0);
+}
+#else
+static inline uint64_t getxcr0() {
+    uint32_t lo, hi;
+    // This is xgetbv, spelled out for assemblers that don't know it.
+    asm volatile (".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+}
+#endif
+
+/* AVX2 needs support from both the CPU and the OS, which must save the YMM registers. */
+static bool supports_avx2(const int cpu_info[4] /* from getcpuid(1, ...) */) {
+    const int kOSXSAVE = 1 << 27,
+              kAVX     = 1 << 28;
+    if ((cpu_info[2] & (kOSXSAVE | kAVX)) != (kOSXSAVE | kAVX)) {
+        return false;
+    }
+    if ((getxcr0() & 6) != 6) {  // XMM and YMM state.
+        return false;
+    }
+    int info[4] = { 0 };
+    getcpuid(0, info);
+    if (info[0] < 7) {
+        return false;
+    }
+    getcpuid(7, info);
+    return (info[1] & (1<<5)) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /* Fetch the SIMD level directly from the CPU, at run-time.
@@ -84,7 +130,7 @@ static int get_SIMD_level() {
 
     getcpuid(1, cpu_info);
     if ((cpu_info[2] & (1<<20)) != 0) {
-        return SK_CPU_SSE_LEVEL_SSE42;
+        return supports_avx2(cpu_info) ? SK_CPU_SSE_LEVEL_AVX2 : SK_CPU_SSE_LEVEL_SSE42;
     } else if ((cpu_info[2] & (1<<19)) != 0) {
         return SK_CPU_SSE_LEVEL_SSE41;
     } else if ((cpu_info[2] & (1<<9)) != 0) {
@@ -126,13 +172,21 @@ static inline bool supports_simd(int minLevel) {
 SK_CONF_DECLARE( bool, c_hqfilter_sse, "bitmap.filter.highQualitySSE", true, "Use SSE optimized version of high quality image filters");
 
 void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs) {
-    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+    PlatformConvolutionProcs(procs, SK_MaxS32);
+}
+
+void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs, int maxSSELevel) {
+    if (maxSSELevel >= SK_CPU_SSE_LEVEL_SSE2 && supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         procs->fExtraHorizontalReads = 3;
         procs->fConvolveVertically = &convolveVertically_SSE2;
         procs->fConvolve4RowsHorizontally = &convolve4RowsHorizontally_SSE2;
         procs->fConvolveHorizontally = &convolveHorizontally_SSE2;
         procs->fApplySIMDPadding = &applySIMDPadding_SSE2;
     }
+    if (maxSSELevel >= SK_CPU_SSE_LEVEL_AVX2 && supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        // Leaves the SSE2 procs in place if AVX2 wasn't compiled in.
+        SkConvolutionGetPlatformProcs_AVX2(procs);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -228,6 +282,13 @@ static SkBlitRow::Proc32 platform_32_procs_SSE4[] = {
 #endif
 
 SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        // NULL if there's no AVX2 proc for flags, or AVX2 wasn't compiled in.
+        SkBlitRow::Proc32 proc = SkBlitRowGetPlatformProcs32_AVX2(flags);
+        if (proc) {
+            return proc;
+        }
+    }
 #if defined(SK_ATT_ASM_SUPPORTED)
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE41)) {
         return platform_32_procs_SSE4[flags];
@@ -241,6 +302,12 @@ SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
 }
 
 SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        SkBlitRow::ColorProc proc = SkBlitRowGetPlatformColorProc_AVX2();
+        if (proc) {
+            return proc;
+        }
+    }
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return Color32_SSE2;
     } else {
@@ -371,6 +438,24 @@ bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void SkGradientGetPlatformProcs(SkGradientSpanProcs* procs) {
+    sk_bzero(procs, sizeof(*procs));
+    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+        procs->fLinearClamp = SkLinearGradientClamp_SSE2;
+        procs->fLinearRepeat = SkLinearGradientRepeat_SSE2;
+        procs->fLinearMirror = SkLinearGradientMirror_SSE2;
+        procs->fRadialClamp = SkRadialGradientClamp_SSE2;
+        procs->fRadialRepeat = SkRadialGradientRepeat_SSE2;
+        procs->fRadialMirror = SkRadialGradientMirror_SSE2;
+    }
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        // Leaves the SSE2 procs in place if AVX2 wasn't compiled in.
+        SkGradientGetPlatformProcs_AVX2(procs);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 extern SkProcCoeffXfermode* SkPlatformXfermodeFactory_impl_SSE2(const ProcCoeff& rec,
                                                                 SkXfermode::Mode mode);
 
@@ -387,6 +472,12 @@ SkProcCoeffXfermode* SkPlatformXfermodeFactory(const ProcCoeff& rec,
 
 SkProcCoeffXfermode* SkPlatformXfermodeFactory(const ProcCoeff& rec,
                                                SkXfermode::Mode mode) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        SkProcCoeffXfermode* xfermode = SkPlatformXfermodeFactory_impl_AVX2(rec, mode);
+        if (xfermode) {
+            return xfermode;
+        }
+    }
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return SkPlatformXfermodeFactory_impl_SSE2(rec, mode);
     } else {
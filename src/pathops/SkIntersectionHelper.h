@@ -67,6 +67,10 @@ public:
         return fContour->segments()[fIndex].bounds();
     }
 
+    int index() const {
+        return fIndex;
+    }
+
     void init(SkOpContour* contour) {
         fContour = contour;
         fIndex = 0;
@@ -117,9 +121,9 @@ public:
         return kLine_Segment;
     }
 
-    bool startAfter(const SkIntersectionHelper& after) {
-        fIndex = after.fIndex;
-        return advance();
+    void setIndex(int index) {
+        SkASSERT(index >= 0 && index < fLast);
+        fIndex = index;
     }
 
     SkScalar top() const {
@@ -1101,6 +1101,7 @@ bool SkOpAngle::tangentsDiverge(const SkOpAngle& rh, double s0xt0) const {
 
 SkOpAngleSet::SkOpAngleSet() 
     : fAngles(NULL)
+    , fAllocator(NULL)
 #if DEBUG_ANGLE
     , fCount(0)
 #endif
@@ -1112,10 +1113,14 @@ SkOpAngleSet::~SkOpAngleSet() {
 }
 
 SkOpAngle& SkOpAngleSet::push_back() {
-    if (!fAngles) {
-        fAngles = SkNEW_ARGS(SkChunkAlloc, (2));
+    SkChunkAlloc* allocator = fAllocator;
+    if (!allocator) {
+        if (!fAngles) {
+            fAngles = SkNEW_ARGS(SkChunkAlloc, (2));
+        }
+        allocator = fAngles;
     }
-    void* ptr = fAngles->allocThrow(sizeof(SkOpAngle));
+    void* ptr = allocator->allocThrow(sizeof(SkOpAngle));
     SkOpAngle* angle = (SkOpAngle*) ptr;
 #if DEBUG_ANGLE
     angle->setID(++fCount);
@@ -1124,6 +1129,7 @@ SkOpAngle& SkOpAngleSet::push_back() {
 }
 
 void SkOpAngleSet::reset() {
+    // angles from a shared allocator are freed when the operation ends
     if (fAngles) {
         fAngles->reset();
     }
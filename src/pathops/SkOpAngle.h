@@ -158,9 +158,13 @@ public:
     ~SkOpAngleSet();
     SkOpAngle& push_back();
     void reset();
+    void setAllocator(SkChunkAlloc* allocator) {
+        fAllocator = allocator;
+    }
 private:
     void dump() const;  // utility to be called by user from debugger
-    SkChunkAlloc* fAngles;
+    SkChunkAlloc* fAngles;  // owned; only used without the operation's allocator
+    SkChunkAlloc* fAllocator;  // shared by the operation's segments, which free nothing
 #if DEBUG_ANGLE
     int fCount;
 #endif
@@ -747,6 +747,46 @@ void SkOpContour::debugShowWindingValues(const SkTArray<SkOpContour*, true>& con
 }
 #endif
 
+// Consecutive segments of a contour are usually near one another, so runs of them make tight nodes.
+static const int kSegmentTreeFanout = 8;
+
+// Appends the indices of segments after 'after' whose bounds intersect 'bounds', in index order,
+// so callers visit the same pairs in the same order as they would testing every segment.
+void SkOpContour::findSegments(const SkPathOpsBounds& bounds, int after,
+        SkTArray<int, true>* found) const {
+    int level = fSegmentTreeLevels.count();
+    int end = level ? fSegmentTree.count() - fSegmentTreeLevels.back() : fSegments.count();
+    findSegments(level, 0, end, bounds, after, found);
+}
+
+void SkOpContour::findSegments(int level, int begin, int end, const SkPathOpsBounds& bounds,
+        int after, SkTArray<int, true>* found) const {
+    if (level == 0) {
+        for (int index = SkTMax(begin, after + 1); index < end; ++index) {
+            if (SkPathOpsBounds::Intersects(bounds, fSegments[index].bounds())) {
+                found->push_back(index);
+            }
+        }
+        return;
+    }
+    // a node's bounds hold its children's, and Intersects() is monotonic, so this rejects no
+    // segment that Intersects() would accept
+    const SkPathOpsBounds* nodes = &fSegmentTree[fSegmentTreeLevels[level - 1]];
+    int belowCount = level > 1 ? fSegmentTreeLevels[level - 1] - fSegmentTreeLevels[level - 2]
+            : fSegments.count();
+    int span = kSegmentTreeFanout;  // segments under each node
+    for (int below = 1; below < level; ++below) {
+        span *= kSegmentTreeFanout;
+    }
+    for (int index = SkTMax(begin, (after + 1) / span); index < end; ++index) {
+        if (SkPathOpsBounds::Intersects(bounds, nodes[index])) {
+            int child = index * kSegmentTreeFanout;
+            findSegments(level - 1, child, SkTMin(child + kSegmentTreeFanout, belowCount), bounds,
+                    after, found);
+        }
+    }
+}
+
 void SkOpContour::setBounds() {
     int count = fSegments.count();
     if (count == 0) {
@@ -760,3 +800,27 @@ void SkOpContour::setBounds() {
         fBounds.add(fSegments[index].bounds());
     }
 }
+
+void SkOpContour::setSegmentTree() {
+    SkASSERT(fSegmentTree.empty());
+    int belowStart = -1;  // the segments themselves
+    int belowCount = fSegments.count();
+    while (belowCount > kSegmentTreeFanout) {
+        int start = fSegmentTree.count();
+        int count = (belowCount + kSegmentTreeFanout - 1) / kSegmentTreeFanout;
+        fSegmentTree.push_back_n(count);
+        for (int index = 0; index < count; ++index) {
+            int child = index * kSegmentTreeFanout;
+            int childEnd = SkTMin(child + kSegmentTreeFanout, belowCount);
+            SkPathOpsBounds& bounds = fSegmentTree[start + index];
+            bounds = belowStart < 0 ? fSegments[child].bounds() : fSegmentTree[belowStart + child];
+            while (++child < childEnd) {
+                bounds.add(belowStart < 0 ? fSegments[child].bounds()
+                        : fSegmentTree[belowStart + child]);
+            }
+        }
+        fSegmentTreeLevels.push_back(start);
+        belowStart = start;
+        belowCount = count;
+    }
+}
@@ -28,7 +28,8 @@ struct SkCoincidence {
 
 class SkOpContour {
 public:
-    SkOpContour() {
+    SkOpContour()
+        : fAllocator(NULL) {
         reset();
 #if defined(SK_DEBUG) || !FORCE_RELEASE
         fID = sk_atomic_inc(&SkPathOpsDebug::gContourID);
@@ -55,12 +56,12 @@ public:
     }
 
     void addCubic(const SkPoint pts[4]) {
-        fSegments.push_back().addCubic(pts, fOperand, fXor);
+        appendSegment().addCubic(pts, fOperand, fXor);
         fContainsCurves = fContainsCubics = true;
     }
 
     int addLine(const SkPoint pts[2]) {
-        fSegments.push_back().addLine(pts, fOperand, fXor);
+        appendSegment().addLine(pts, fOperand, fXor);
         return fSegments.count();
     }
 
@@ -72,7 +73,7 @@ public:
                        const SkIntersections& ts, int ptIndex, bool swap);
 
     int addQuad(const SkPoint pts[3]) {
-        fSegments.push_back().addQuad(pts, fOperand, fXor);
+        appendSegment().addQuad(pts, fOperand, fXor);
         fContainsCurves = true;
         return fSegments.count();
     }
@@ -182,6 +183,7 @@ public:
 
     void complete() {
         setBounds();
+        setSegmentTree();
         fContainsIntercepts = false;
     }
 
@@ -207,6 +209,8 @@ public:
         return segment.pts()[SkPathOpsVerbToPoints(segment.verb())];
     }
 
+    void findSegments(const SkPathOpsBounds& bounds, int after, SkTArray<int, true>* found) const;
+
     void fixOtherTIndex() {
         int segmentCount = fSegments.count();
         for (int sIndex = 0; sIndex < segmentCount; ++sIndex) {
@@ -231,13 +235,15 @@ public:
 
     void reset() {
         fSegments.reset();
+        fSegmentTree.reset();
+        fSegmentTreeLevels.reset();
         fBounds.set(SK_ScalarMax, SK_ScalarMax, SK_ScalarMax, SK_ScalarMax);
         fContainsCurves = fContainsCubics = fContainsIntercepts = fDone = fMultiples = false;
     }
 
     void resolveNearCoincidence();
 
-    SkTArray<SkOpSegment>& segments() {
+    SkTArray<SkOpSegment, true>& segments() {
         return fSegments;
     }
 
@@ -245,6 +251,10 @@ public:
         fContainsIntercepts = true;
     }
 
+    void setAllocator(SkOpAllocator* allocator) {
+        fAllocator = allocator;
+    }
+
     void setOperand(bool isOp) {
         fOperand = isOp;
     }
@@ -294,7 +304,7 @@ public:
     }
 
 #if DEBUG_TEST
-    SkTArray<SkOpSegment>& debugSegments() {
+    SkTArray<SkOpSegment, true>& debugSegments() {
         return fSegments;
     }
 #endif
@@ -323,21 +333,37 @@ public:
     void dumpSpans() const;
 
 private:
+    SkOpSegment& appendSegment() {
+        SkOpSegment& segment = fSegments.push_back();
+        segment.setAllocator(fAllocator);
+        return segment;
+    }
+
     void alignPt(int index, SkPoint* point, int zeroPt) const;
     int alignT(bool swap, int tIndex, SkIntersections* ts) const;
     bool calcCommonCoincidentWinding(const SkCoincidence& );
     void checkCoincidentPair(const SkCoincidence& oneCoin, int oneIdx,
                              const SkCoincidence& twoCoin, int twoIdx, bool partial);
     void joinCoincidence(const SkTArray<SkCoincidence, true>& , bool partial);
+    void findSegments(int level, int begin, int end, const SkPathOpsBounds& bounds, int after,
+                      SkTArray<int, true>* found) const;
     void setBounds();
-
-    SkTArray<SkOpSegment> fSegments;
+    void setSegmentTree();
+
+    // segments are only appended while the contour is built, before anything points to them, so
+    // the array can grow by copying their bytes
+    SkTArray<SkOpSegment, true> fSegments;
+    // bounds of each run of kSegmentTreeFanout segments, then of each run of those, and so on
+    // until a level fits in one run; fSegmentTreeLevels holds where each level starts
+    SkTArray<SkPathOpsBounds, true> fSegmentTree;
+    SkTArray<int, true> fSegmentTreeLevels;
     SkTArray<SkOpSegment*, true> fSortedSegments;
     int fFirstSorted;
     SkTArray<SkCoincidence, true> fCoincidences;
     SkTArray<SkCoincidence, true> fPartialCoincidences;
     SkTArray<const SkOpContour*, true> fCrosses;
     SkPathOpsBounds fBounds;
+    SkOpAllocator* fAllocator;  // the operation's; holds segments' spans and angles
     bool fContainsIntercepts;  // FIXME: is this used by anybody?
     bool fContainsCubics;
     bool fContainsCurves;
@@ -174,6 +174,7 @@ bool SkOpEdgeBuilder::walk() {
                 }
                 if (!fCurrentContour) {
                     fCurrentContour = fContours.push_back_n(1);
+                    fCurrentContour->setAllocator(fAllocator);
                     fCurrentContour->setOperand(fOperand);
                     fCurrentContour->setXor(fXorMask[fOperand] == kEvenOdd_PathOpsMask);
                 }
@@ -13,16 +13,20 @@
 
 class SkOpEdgeBuilder {
 public:
-    SkOpEdgeBuilder(const SkPathWriter& path, SkTArray<SkOpContour>& contours)
+    SkOpEdgeBuilder(const SkPathWriter& path, SkTArray<SkOpContour, true>& contours,
+                    SkOpAllocator* allocator)
         : fPath(path.nativePath())
         , fContours(contours)
+        , fAllocator(allocator)
         , fAllowOpenContours(true) {
         init();
     }
 
-    SkOpEdgeBuilder(const SkPath& path, SkTArray<SkOpContour>& contours)
+    SkOpEdgeBuilder(const SkPath& path, SkTArray<SkOpContour, true>& contours,
+                    SkOpAllocator* allocator)
         : fPath(&path)
         , fContours(contours)
+        , fAllocator(allocator)
         , fAllowOpenContours(false) {
         init();
     }
@@ -51,7 +55,8 @@ private:
     SkTArray<SkPoint, true> fPathPts;
     SkTArray<uint8_t, true> fPathVerbs;
     SkOpContour* fCurrentContour;
-    SkTArray<SkOpContour>& fContours;
+    SkTArray<SkOpContour, true>& fContours;
+    SkOpAllocator* fAllocator;
     SkPathOpsMask fXorMask[2];
     int fSecondHalf;
     bool fOperand;
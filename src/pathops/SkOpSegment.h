@@ -179,6 +179,11 @@ public:
 
     bool reversePoints(const SkPoint& p1, const SkPoint& p2) const;
 
+    void setAllocator(SkOpAllocator* allocator) {
+        fTs.setAllocator(allocator);
+        fAngles.setAllocator(allocator);
+    }
+
     void setOppXor(bool isOppXor) {
         fOppXor = isOppXor;
     }
@@ -372,7 +377,7 @@ public:
 #if DEBUG_SHOW_WINDING
     int debugShowWindingValues(int slotCount, int ofInterest) const;
 #endif
-    const SkTDArray<SkOpSpan>& debugSpans() const;
+    const SkOpSpanArray& debugSpans() const;
     void debugValidate() const;
     // available to testing only
     const SkOpAngle* debugLastAngle() const;
@@ -531,8 +536,7 @@ private:
 
     const SkPoint* fPts;
     SkPathOpsBounds fBounds;
-    // FIXME: can't convert to SkTArray because it uses insert
-    SkTDArray<SkOpSpan> fTs;  // 2+ (always includes t=0 t=1) -- at least (number of spans) + 1
+    SkOpSpanArray fTs;  // 2+ (always includes t=0 t=1) -- at least (number of spans) + 1
     SkOpAngleSet fAngles;  // empty or 2+ -- (number of non-zero spans) * 2
     // OPTIMIZATION: could pack donespans, verb, operand, xor into 1 int-sized value
     int fDoneSpans;  // quick check that segment is finished
@@ -7,6 +7,7 @@
 #ifndef SkOpSpan_DEFINED
 #define SkOpSpan_DEFINED
 
+#include "SkChunkAlloc.h"
 #include "SkPoint.h"
 
 class SkOpAngle;
@@ -39,4 +40,158 @@ struct SkOpSpan {
     void dumpOne() const;
 };
 
+// The allocator an operation's spans and angles come from. Span arrays hand back their storage as
+// they outgrow it; it is kept by size, for the next array to grow into that size, since nothing
+// in the chunks is freed until the operation ends.
+class SkOpAllocator : public SkChunkAlloc {
+public:
+    explicit SkOpAllocator(size_t minSize)
+        : INHERITED(minSize) {
+        sk_bzero(fFreeSpans, sizeof(fFreeSpans));
+    }
+
+    // Returns room for 4 << sizeClass spans.
+    SkOpSpan* allocSpans(int sizeClass) {
+        SkASSERT(sizeClass >= 0 && sizeClass < kSizeClassCount);
+        FreeSpans* spans = fFreeSpans[sizeClass];
+        if (spans) {
+            fFreeSpans[sizeClass] = spans->fNext;
+            return reinterpret_cast<SkOpSpan*>(spans);
+        }
+        return (SkOpSpan*) this->allocThrow(SpanBytes(sizeClass));
+    }
+
+    void freeSpans(SkOpSpan* array, int sizeClass) {
+        SkASSERT(sizeClass >= 0 && sizeClass < kSizeClassCount);
+        FreeSpans* spans = reinterpret_cast<FreeSpans*>(array);
+        spans->fNext = fFreeSpans[sizeClass];
+        fFreeSpans[sizeClass] = spans;
+    }
+
+    static size_t SpanBytes(int sizeClass) {
+        return (size_t) (4 << sizeClass) * sizeof(SkOpSpan);
+    }
+
+    // 4 << 26 spans would take gigabytes
+    static const int kSizeClassCount = 27;
+
+private:
+    struct FreeSpans {
+        FreeSpans* fNext;
+    };
+
+    FreeSpans* fFreeSpans[kSizeClassCount];
+
+    typedef SkChunkAlloc INHERITED;
+};
+
+// Holds a segment's spans, sorted by t. Like SkTDArray, but the storage comes from the operation's
+// allocator. Growing doubles the storage and hands the old storage back to the allocator for other
+// segments to reuse. Without an allocator (as when testing a lone segment), storage is on the heap.
+class SkOpSpanArray {
+public:
+    SkOpSpanArray()
+        : fArray(NULL)
+        , fCount(0)
+        , fReserve(0)
+        , fSizeClass(-1)
+        , fAllocator(NULL) {
+    }
+
+    ~SkOpSpanArray() {
+        if (!fAllocator) {
+            sk_free(fArray);
+        }
+    }
+
+    SkOpSpan* append() {
+        return this->insert(fCount);
+    }
+
+    SkOpSpan* begin() {
+        return fArray;
+    }
+
+    const SkOpSpan* begin() const {
+        return fArray;
+    }
+
+    int count() const {
+        return fCount;
+    }
+
+    SkOpSpan* end() {
+        return fArray + fCount;
+    }
+
+    const SkOpSpan* end() const {
+        return fArray + fCount;
+    }
+
+    SkOpSpan* insert(int index) {
+        SkASSERT(index >= 0 && index <= fCount);
+        if (fCount == fReserve) {
+            this->grow();
+        }
+        SkOpSpan* span = fArray + index;
+        memmove(span + 1, span, (fCount - index) * sizeof(SkOpSpan));
+        ++fCount;
+        return span;
+    }
+
+    void reset() {
+        if (!fAllocator) {
+            sk_free(fArray);
+        } else if (fArray) {
+            fAllocator->freeSpans(fArray, fSizeClass);
+        }
+        fArray = NULL;
+        fCount = fReserve = 0;
+        fSizeClass = -1;
+    }
+
+    void setAllocator(SkOpAllocator* allocator) {
+        SkASSERT(!fArray);
+        fAllocator = allocator;
+    }
+
+    SkOpSpan& operator[](int index) {
+        SkASSERT(index < fCount);
+        return fArray[index];
+    }
+
+    const SkOpSpan& operator[](int index) const {
+        SkASSERT(index < fCount);
+        return fArray[index];
+    }
+
+private:
+    // Room for 4 spans, then 8, 16 ... so the storage given up on the way is less than the final.
+    void grow() {
+        int sizeClass = fSizeClass + 1;
+        if (!fAllocator) {
+            fArray = (SkOpSpan*) sk_realloc_throw(fArray, SkOpAllocator::SpanBytes(sizeClass));
+        } else {
+            SkOpSpan* array = fAllocator->allocSpans(sizeClass);
+            if (fArray) {
+                memcpy(array, fArray, fCount * sizeof(SkOpSpan));
+                fAllocator->freeSpans(fArray, fSizeClass);
+            }
+            fArray = array;
+        }
+        fSizeClass = sizeClass;
+        fReserve = 4 << sizeClass;
+    }
+
+    SkOpSpan* fArray;
+    int fCount;
+    int fReserve;
+    int fSizeClass;  // fReserve is 4 << fSizeClass; -1 before anything is allocated
+    SkOpAllocator* fAllocator;
+
+    // not copyable: segments move only by copying their bytes, as their arrays grow
+    SkOpSpanArray(const SkOpSpanArray&);
+    SkOpSpanArray& operator=(const SkOpSpanArray&);
+};
+
 #endif
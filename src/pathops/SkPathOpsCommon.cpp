@@ -476,7 +476,7 @@ static void sortSegments(SkTArray<SkOpContour*, true>* contourList) {
     }
 }
 
-void MakeContourList(SkTArray<SkOpContour>& contours, SkTArray<SkOpContour*, true>& list,
+void MakeContourList(SkTArray<SkOpContour, true>& contours, SkTArray<SkOpContour*, true>& list,
                      bool evenOdd, bool oppEvenOdd) {
     int count = contours.count();
     if (count == 0) {
@@ -510,8 +510,9 @@ void Assemble(const SkPathWriter& path, SkPathWriter* simple) {
 #if DEBUG_PATH_CONSTRUCTION
     SkDebugf("%s\n", __FUNCTION__);
 #endif
-    SkTArray<SkOpContour> contours;
-    SkOpEdgeBuilder builder(path, contours);
+    SkOpAllocator allocator(kOpAllocatorBlockSize);
+    SkTArray<SkOpContour, true> contours;
+    SkOpEdgeBuilder builder(path, contours, &allocator);
     builder.finish();
     int count = contours.count();
     int outer;
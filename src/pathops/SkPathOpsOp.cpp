@@ -266,10 +266,11 @@ bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
 #if DEBUG_SORT || DEBUG_SWAP_TOP
     SkPathOpsDebug::gSortCount = SkPathOpsDebug::gSortCountDefault;
 #endif
-    // turn path into list of segments
-    SkTArray<SkOpContour> contours;
+    // turn path into list of segments; their spans and angles are freed together on return
+    SkOpAllocator allocator(kOpAllocatorBlockSize);
+    SkTArray<SkOpContour, true> contours;
     // FIXME: add self-intersecting cubics' T values to segment
-    SkOpEdgeBuilder builder(*minuend, contours);
+    SkOpEdgeBuilder builder(*minuend, contours, &allocator);
     if (builder.unparseable()) {
         return false;
     }
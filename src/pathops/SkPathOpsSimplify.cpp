@@ -163,9 +163,10 @@ bool Simplify(const SkPath& path, SkPath* result) {
     SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
             : SkPath::kEvenOdd_FillType;
 
-    // turn path into list of segments
-    SkTArray<SkOpContour> contours;
-    SkOpEdgeBuilder builder(path, contours);
+    // turn path into list of segments; their spans and angles are freed together on return
+    SkOpAllocator allocator(kOpAllocatorBlockSize);
+    SkTArray<SkOpContour, true> contours;
+    SkOpEdgeBuilder builder(path, contours, &allocator);
     if (!builder.finish()) {
         return false;
     }
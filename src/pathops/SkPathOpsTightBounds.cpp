@@ -9,8 +9,9 @@
 
 bool TightBounds(const SkPath& path, SkRect* result) {
     // turn path into list of segments
-    SkTArray<SkOpContour> contours;
-    SkOpEdgeBuilder builder(path, contours);
+    SkOpAllocator allocator(kOpAllocatorBlockSize);
+    SkTArray<SkOpContour, true> contours;
+    SkOpEdgeBuilder builder(path, contours, &allocator);
     if (!builder.finish()) {
         return false;
     }
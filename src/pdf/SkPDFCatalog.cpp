@@ -7,9 +7,13 @@
  */
 
 
+#include "SkChecksum.h"
+#include "SkData.h"
 #include "SkPDFCatalog.h"
 #include "SkPDFTypes.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTSort.h"
 #include "SkTypes.h"
 
 SkPDFCatalog::SkPDFCatalog(SkPDFDocument::Flags flags)
@@ -28,7 +32,8 @@ SkPDFObject* SkPDFCatalog::addObject(SkPDFObject* obj, bool onFirstPage) {
     if (findObjectIndex(obj) != -1) {  // object already added
         return obj;
     }
-    SkASSERT(fNextFirstPageObjNum == 0);
+    // First page objects can't be added once object numbers are assigned.
+    SkASSERT(!onFirstPage || fNextFirstPageObjNum == 0);
     if (onFirstPage) {
         fFirstPageCount++;
     }
@@ -47,6 +52,160 @@ size_t SkPDFCatalog::setFileOffset(SkPDFObject* obj, off_t offset) {
     return getSubstituteObject(obj)->getOutputSize(this, true);
 }
 
+namespace {
+
+struct PrepareObject {
+    PrepareObject(SkPDFCatalog* catalog, const SkTDArray<SkPDFObject*>& objects)
+        : fCatalog(catalog), fObjects(objects) {}
+
+    void operator()(int i) { fObjects[i]->prepare(fCatalog); }
+
+    SkPDFCatalog* fCatalog;
+    const SkTDArray<SkPDFObject*>& fObjects;
+};
+
+}  // namespace
+
+void SkPDFCatalog::prepareObjects() {
+    SkTDArray<SkPDFObject*> objects;
+    objects.setReserve(fCatalog.count());
+    for (int i = 0; i < fCatalog.count(); i++) {
+        if (fCatalog[i].fObject) {  // NULL once retired.
+            objects.push(getSubstituteObject(fCatalog[i].fObject));
+        }
+    }
+    this->prepareObjects(objects);
+}
+
+void SkPDFCatalog::prepareObjects(const SkTDArray<SkPDFObject*>& objects) {
+    // Objects vary a lot in how much work they are, so we hand them out one at a time.
+    PrepareObject prepare(this, objects);
+    sk_parallel_for(objects.count(), 1, prepare);
+}
+
+void SkPDFCatalog::retireObject(SkPDFObject* obj, SkPDFObject* standIn) {
+    for (int i = 0; i < fMergeMap.count(); i++) {
+        if (fMergeMap[i].fDuplicate == obj) {
+            // It was never emitted, so there's nothing to keep.
+            SkASSERT(NULL == standIn);
+            fMergeMap.removeShuffle(i);
+            return;
+        }
+    }
+    int index = findObjectIndex(obj);
+    SkASSERT(index >= 0);
+    SkASSERT(fCatalog[index].fObject == obj);  // Not a substitute.
+    SkASSERT(fCatalog[index].fFileOffset > 0);
+    SkASSERT(NULL == standIn || -1 == findObjectIndex(standIn));
+    fCatalog[index].fObject = standIn;
+}
+
+namespace {
+
+struct Digest {
+    uint32_t fHash;
+    int fIndex;  // Of the object in the array being merged.
+};
+
+bool digest_less_than(const Digest& a, const Digest& b) {
+    // Ties keep their order, so objects are merged into the first of them.
+    return a.fHash < b.fHash || (a.fHash == b.fHash && a.fIndex < b.fIndex);
+}
+
+}  // namespace
+
+// Returns NULL if obj can't be merged.
+static SkData* copy_digest(SkPDFObject* obj, SkPDFCatalog* catalog) {
+    SkDynamicMemoryWStream digest;
+    if (!obj->emitDigest(&digest, catalog)) {
+        return NULL;
+    }
+    // SkChecksum wants whole words, so pad, then say how much was padding.
+    static const uint32_t kZero = 0;
+    const size_t size = digest.bytesWritten();
+    digest.write(&kZero, SkAlign4(size) - size);
+    digest.write32(SkToU32(size));
+    return digest.copyToData();
+}
+
+static uint32_t hash_digest(const SkData* digest) {
+    return SkChecksum::Murmur3(static_cast<const uint32_t*>(digest->data()),
+                               digest->size());
+}
+
+void SkPDFCatalog::mergeDuplicates(const SkTDArray<SkPDFObject*>& objects,
+                                   SkTSet<SkPDFObject*>* duplicates) {
+    SkTDArray<bool> merged;
+    merged.setCount(objects.count());
+    sk_bzero(merged.begin(), merged.bytes());
+
+    // Merging objects can make those that refer to them the same, so we go
+    // until there's nothing more to merge.  Only hashes are kept between
+    // the two times we write each digest, as streams' digests can be big.
+    for (;;) {
+        SkTDArray<Digest> digests;
+        for (int i = 0; i < objects.count(); i++) {
+            if (!merged[i]) {
+                SkAutoTUnref<SkData> digest(copy_digest(objects[i], this));
+                if (digest.get()) {
+                    Digest* d = digests.append();
+                    d->fHash = hash_digest(digest);
+                    d->fIndex = i;
+                }
+            }
+        }
+        if (digests.count() < 2) {
+            return;
+        }
+        SkTQSort(digests.begin(), digests.end() - 1, digest_less_than);
+
+        int mergedCount = 0;
+        for (int first = 0, end; first < digests.count(); first = end) {
+            for (end = first + 1; end < digests.count() &&
+                                  digests[end].fHash == digests[first].fHash; end++) {
+            }
+            if (end - first == 1) {
+                continue;
+            }
+            SkPDFObject* original = objects[digests[first].fIndex];
+            SkAutoTUnref<SkData> originalDigest(copy_digest(original, this));
+            for (int i = first + 1; i < end; i++) {
+                SkPDFObject* duplicate = objects[digests[i].fIndex];
+                SkAutoTUnref<SkData> digest(copy_digest(duplicate, this));
+                if (!digest.get() || !digest->equals(originalDigest)) {
+                    continue;  // Just a hash collision.
+                }
+                int index = findObjectIndex(duplicate);
+                SkASSERT(index >= 0 && fCatalog[index].fObject == duplicate);
+                SkASSERT(!fCatalog[index].fObjNumAssigned);
+                if (fCatalog[index].fOnFirstPage) {
+                    fFirstPageCount--;
+                }
+                fCatalog.remove(index);
+                MergeMapping mapping(duplicate, original);
+                fMergeMap.append(1, &mapping);
+
+                merged[digests[i].fIndex] = true;
+                duplicates->add(duplicate);
+                mergedCount++;
+            }
+        }
+        if (0 == mergedCount) {
+            return;
+        }
+    }
+}
+
+SkPDFObject* SkPDFCatalog::getMergedObject(SkPDFObject* object) {
+    // What an object was merged into may have been merged itself.
+    for (int i = 0; i < fMergeMap.count(); i++) {
+        if (object == fMergeMap[i].fDuplicate) {
+            return getMergedObject(fMergeMap[i].fOriginal);
+        }
+    }
+    return object;
+}
+
 void SkPDFCatalog::emitObjectNumber(SkWStream* stream, SkPDFObject* obj) {
     stream->writeDecAsText(assignObjNum(obj));
     stream->writeText(" 0");  // Generation number is always 0.
@@ -70,6 +229,12 @@ int SkPDFCatalog::findObjectIndex(SkPDFObject* obj) const {
             return findObjectIndex(fSubstituteMap[i].fOriginal);
         }
     }
+    // Or if it's been merged into another object.
+    for (int i = 0; i < fMergeMap.count(); ++i) {
+        if (fMergeMap[i].fDuplicate == obj) {
+            return findObjectIndex(fMergeMap[i].fOriginal);
+        }
+    }
     return -1;
 }
 
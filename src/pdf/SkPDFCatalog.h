@@ -44,6 +44,43 @@ public:
      */
     size_t setFileOffset(SkPDFObject* obj, off_t offset);
 
+    /** Call prepare() for every object in the catalog, spread across the
+     *  SkTaskGroup threads, if there are any.  Objects are otherwise prepared
+     *  one by one as they're sized, so this only changes how long it takes.
+     */
+    void prepareObjects();
+
+    /** Like prepareObjects(), but only for the passed objects, which should
+     *  already have been added to the catalog.
+     */
+    void prepareObjects(const SkTDArray<SkPDFObject*>& objects);
+
+    /** Forget the passed object once it's been emitted, so it can be freed.
+     *  Its object number and file offset are kept for the cross reference
+     *  table.  If standIn is not NULL, references to it get obj's number,
+     *  otherwise obj can't be referred to again.  Either way, obj may be
+     *  added again as a new object.
+     *  @param obj         The object to forget.
+     *  @param standIn     An object not otherwise in the catalog, or NULL.
+     */
+    void retireObject(SkPDFObject* obj, SkPDFObject* standIn);
+
+    /** Merge objects that would emit the same thing, as their emitDigest()
+     *  tells, so that only one of them is emitted.  The others are dropped
+     *  from the catalog, and references to them refer to the one they were
+     *  merged into, so they mustn't be emitted or sized.  None of the
+     *  objects may have an object number yet.
+     *  @param objects     The objects to merge, which are in the catalog.
+     *  @param duplicates  The objects merged into others are added to this.
+     */
+    void mergeDuplicates(const SkTDArray<SkPDFObject*>& objects,
+                         SkTSet<SkPDFObject*>* duplicates);
+
+    /** Return the object that mergeDuplicates() merged the passed object
+     *  into, if any, otherwise the passed object.
+     */
+    SkPDFObject* getMergedObject(SkPDFObject* object);
+
     /** Output the object number for the passed object.
      *  @param obj         The object of interest.
      *  @param stream      The writable output stream to send the output to.
@@ -113,8 +150,18 @@ private:
     // TODO(vandebo): Make this a hash if it's a performance problem.
     SkTDArray<struct Rec> fCatalog;
 
+    struct MergeMapping {
+        MergeMapping(SkPDFObject* duplicate, SkPDFObject* original)
+            : fDuplicate(duplicate), fOriginal(original) {
+        }
+        SkPDFObject* fDuplicate;
+        SkPDFObject* fOriginal;
+    };
+
     // TODO(arthurhsu): Make this a hash if it's a performance problem.
     SkTDArray<SubstituteMapping> fSubstituteMap;
+
+    SkTDArray<MergeMapping> fMergeMap;
     SkTSet<SkPDFObject*> fSubstituteResourcesFirstPage;
     SkTSet<SkPDFObject*> fSubstituteResourcesRemaining;
 
@@ -24,6 +24,21 @@ static void addResourcesToCatalog(bool firstPage,
     }
 }
 
+// Moves the references resources holds to objects in duplicates to removed.
+static void remove_duplicates(const SkTSet<SkPDFObject*>& duplicates,
+                              SkTSet<SkPDFObject*>* resources,
+                              SkTDArray<SkPDFObject*>* removed) {
+    SkTSet<SkPDFObject*> kept;
+    for (int i = 0; i < resources->count(); i++) {
+        if (duplicates.contains((*resources)[i])) {
+            removed->push((*resources)[i]);
+        } else {
+            kept.add((*resources)[i]);
+        }
+    }
+    *resources = kept;
+}
+
 static void perform_font_subsetting(SkPDFCatalog* catalog,
                                     const SkTDArray<SkPDFPage*>& pages,
                                     SkTDArray<SkPDFObject*>* substitutes) {
@@ -75,6 +90,7 @@ SkPDFDocument::~SkPDFDocument() {
     }
 
     fSubstitutes.safeUnrefAll();
+    fDuplicates.safeUnrefAll();
 
     fDocCatalog->unref();
     SkSafeUnref(fTrailerDict);
@@ -156,9 +172,24 @@ bool SkPDFDocument::emitPDF(SkWStream* stream) {
             fDocCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (raw_dests)))->unref();
         }
 
+        // Images, form XObjects and the like drawn more than once are only
+        // emitted once, and so only compressed once.
+        SkTDArray<SkPDFObject*> resources;
+        resources.append(fFirstPageResources->count(), fFirstPageResources->begin());
+        resources.append(fOtherPageResources->count(), fOtherPageResources->begin());
+        SkTSet<SkPDFObject*> merged;
+        fCatalog->mergeDuplicates(resources, &merged);
+        if (!merged.isEmpty()) {
+            remove_duplicates(merged, fFirstPageResources, &fDuplicates);
+            remove_duplicates(merged, fOtherPageResources, &fDuplicates);
+        }
+
         // Build font subsetting info before proceeding.
         perform_font_subsetting(fCatalog.get(), fPages, &fSubstitutes);
 
+        // Compress streams and images on all threads before we size them.
+        fCatalog->prepareObjects();
+
         // Figure out the size of things and inform the catalog of file offsets.
         off_t fileOffset = headerSize();
         fileOffset += fCatalog->setFileOffset(fDocCatalog, fileOffset);
@@ -85,6 +85,12 @@ public:
     virtual void getResources(const SkTSet<SkPDFObject*>& knownResourceObjects,
                               SkTSet<SkPDFObject*>* newResourceObjects);
 
+    // Fonts are canonical, and substituted by their subsets once every page
+    // is known, so they're never merged.
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+        return false;
+    }
+
     /** Returns the typeface represented by this class. Returns NULL for the
      *  default typeface.
      */
@@ -44,6 +44,11 @@ public:
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
+    // The dictionary may not be populated yet, and graphic states are
+    // canonical anyway, so there's nothing to merge.
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+        return false;
+    }
 
     /** Get the graphic state for the passed SkPaint. The reference count of
      *  the object is incremented and it is the caller's responsibility to
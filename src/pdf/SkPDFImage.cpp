@@ -8,6 +8,7 @@
 #include "SkPDFImage.h"
 
 #include "SkBitmap.h"
+#include "SkChecksum.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
 #include "SkData.h"
@@ -17,6 +18,7 @@
 #include "SkRect.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkThread.h"
 #include "SkUnPreMultiply.h"
 
 static const int kNoColorTransform = 0;
@@ -501,7 +503,8 @@ SkPDFImage::SkPDFImage(SkStream* stream,
                        SkPicture::EncodeBitmap encoder)
     : fIsAlpha(isAlpha),
       fSrcRect(srcRect),
-      fEncoder(encoder) {
+      fEncoder(encoder),
+      fHasPixelDigest(false) {
 
     if (bitmap.isImmutable()) {
         fBitmap = bitmap;
@@ -576,12 +579,18 @@ SkPDFImage::SkPDFImage(SkPDFImage& pdfImage)
       fIsAlpha(pdfImage.fIsAlpha),
       fSrcRect(pdfImage.fSrcRect),
       fEncoder(pdfImage.fEncoder),
-      fStreamValid(pdfImage.fStreamValid) {
+      fStreamValid(pdfImage.fStreamValid),
+      fHasPixelDigest(pdfImage.fHasPixelDigest) {
+    memcpy(fPixelDigest, pdfImage.fPixelDigest, sizeof(fPixelDigest));
     // Nothing to do here - the image params are already copied in SkPDFStream's
     // constructor, and the bitmap will be regenerated and encoded in
     // populate.
 }
 
+// SkPDFCatalog::prepareObjects() populates images on several threads at once, but the
+// caller's encoder needn't be thread-safe, so it's only ever called by one at a time.
+SK_DECLARE_STATIC_MUTEX(gEncoderMutex);
+
 bool SkPDFImage::populate(SkPDFCatalog* catalog) {
     if (getState() == kUnused_State) {
         // Initializing image data for the first time.
@@ -594,7 +603,11 @@ bool SkPDFImage::populate(SkPDFCatalog* catalog) {
                 return false;
             }
             size_t pixelRefOffset = 0;
-            SkAutoTUnref<SkData> data(fEncoder(&pixelRefOffset, subset));
+            SkAutoTUnref<SkData> data;
+            {
+                SkAutoMutexAcquire lock(gEncoderMutex);
+                data.reset(fEncoder(&pixelRefOffset, subset));
+            }
             if (data.get() && data->size() < get_uncompressed_size(fBitmap,
                                                                    fSrcRect)) {
                 this->setData(data.get());
@@ -629,6 +642,56 @@ bool SkPDFImage::populate(SkPDFCatalog* catalog) {
     return true;
 }
 
+// Hashes srcRect of bitmap where it is, row by row, with two differently seeded Murmur3s, so
+// that images are told apart by 64 bits.
+static bool hash_pixels(const SkBitmap& bitmap, const SkIRect& srcRect, uint32_t hash[2]) {
+    SkAutoLockPixels alp(bitmap);
+    if (NULL == bitmap.getPixels() || 0 == bitmap.bytesPerPixel()) {
+        return false;
+    }
+    const size_t rowBytes = srcRect.width() * bitmap.bytesPerPixel();
+    const size_t hashedBytes = SkAlign4(rowBytes);
+    // Murmur3 reads aligned whole words, so rows that aren't are copied here first.
+    SkAutoSTMalloc<256, uint32_t> rowCopy(hashedBytes / 4);
+    hash[0] = 0;
+    hash[1] = 0x9E3779B9;
+    for (int y = srcRect.fTop; y < srcRect.fBottom; y++) {
+        const void* row = bitmap.getAddr(srcRect.fLeft, y);
+        const uint32_t* words = static_cast<const uint32_t*>(row);
+        if (hashedBytes != rowBytes || !SkIsAlign4(reinterpret_cast<intptr_t>(row))) {
+            rowCopy[hashedBytes / 4 - 1] = 0;
+            memcpy(rowCopy.get(), row, rowBytes);
+            words = rowCopy.get();
+        }
+        hash[0] = SkChecksum::Murmur3(words, hashedBytes, hash[0]);
+        hash[1] = SkChecksum::Murmur3(words, hashedBytes, hash[1]);
+    }
+    return true;
+}
+
+bool SkPDFImage::emitDataDigest(SkWStream* stream) {
+    // populate() encodes fSrcRect of fBitmap with fEncoder, or falls back
+    // to the data we were handed, if any, or else to fBitmap's pixels.  The
+    // data we're handed is always extracted from fBitmap's fSrcRect, and any
+    // palette is already in our dictionary, so the pixels stand for it all.
+    // Rather than copy them into every digest, we hash them where they are,
+    // once; they can't change.
+    if (!fHasPixelDigest) {
+        if (!hash_pixels(fBitmap, fSrcRect, fPixelDigest)) {
+            return false;
+        }
+        fHasPixelDigest = true;
+    }
+    stream->write(&fEncoder, sizeof(fEncoder));
+    stream->writeBool(fIsAlpha);
+    stream->write32(fBitmap.colorType());
+    stream->write32(fBitmap.alphaType());
+    stream->write(&fSrcRect, sizeof(fSrcRect));
+    stream->writeBool(fStreamValid);
+    stream->write(fPixelDigest, sizeof(fPixelDigest));
+    return true;
+}
+
 namespace {
 /**
  *  This PDFObject assumes that its constructor was handed
@@ -670,6 +733,10 @@ public:
         stream->write(fData->data(), fData->size());
         stream->write(kPostface, sizeof(kPostface));
     }
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog) SK_OVERRIDE {
+        this->emitObject(stream, catalog, false);
+        return true;
+    }
 };
 
 /**
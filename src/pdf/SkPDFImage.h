@@ -74,6 +74,9 @@ private:
     SkIRect fSrcRect;
     SkPicture::EncodeBitmap fEncoder;
     bool fStreamValid;
+    // Hashes of fSrcRect's pixels for emitDataDigest(), once computed.
+    uint32_t fPixelDigest[2];
+    bool fHasPixelDigest;
 
     SkTDArray<SkPDFObject*> fResources;
 
@@ -103,6 +106,9 @@ private:
     // fSubstitute should be used.
     virtual bool populate(SkPDFCatalog* catalog);
 
+    // Our data comes from fBitmap, so that's what we write a hash of.
+    virtual bool emitDataDigest(SkWStream* stream);
+
     typedef SkPDFStream INHERITED;
 };
 
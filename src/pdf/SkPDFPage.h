@@ -97,6 +97,10 @@ public:
      */
     const SkPDFGlyphSetMap& getFontGlyphUsage() const;
 
+    /** Get the page content, or NULL if the page hasn't been finalized.
+     */
+    SkPDFStream* getContentStream() const { return fContentStream.get(); }
+
 private:
     // Multiple pages may reference the content.
     SkAutoTUnref<SkPDFDevice> fDevice;
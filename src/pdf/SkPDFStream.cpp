@@ -75,6 +75,38 @@ size_t SkPDFStream::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
         strlen(" stream\n\nendstream") + this->dataSize();
 }
 
+void SkPDFStream::prepare(SkPDFCatalog* catalog) {
+    SkAutoMutexAcquire lock(fMutex);
+    // Compress now if we've not been requested yet.  Any later request that
+    // needs a substitute stream is left to getOutputSize(), which may change
+    // the catalog.
+    if (fState == kUnused_State) {
+        this->populate(catalog);
+    }
+}
+
+bool SkPDFStream::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    SkAutoMutexAcquire lock(fMutex);
+    // Once populated, we may have been compressed or substituted, so only
+    // streams that haven't been are compared, by what populate() starts from.
+    if (fState != kUnused_State ||
+            !this->INHERITED::emitDigest(stream, catalog)) {
+        return false;
+    }
+    stream->writeText(" stream\n");
+    if (!this->emitDataDigest(stream)) {
+        return false;
+    }
+    stream->writeText("\nendstream");
+    return true;
+}
+
+bool SkPDFStream::emitDataDigest(SkWStream* stream) {
+    stream->writeStream(fDataStream.get(), fDataStream->getLength());
+    SkAssertResult(fDataStream->rewind());
+    return true;
+}
+
 SkPDFStream::SkPDFStream() : fState(kUnused_State) {}
 
 void SkPDFStream::setData(SkData* data) {
@@ -39,11 +39,13 @@ public:
 
     virtual ~SkPDFStream();
 
-    // The SkPDFObject interface.  These two methods use a mutex to
+    // The SkPDFObject interface.  These four methods use a mutex to
     // allow multiple threads to call at the same time.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
+    virtual void prepare(SkPDFCatalog* catalog);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
 
 protected:
     enum State {
@@ -67,6 +69,10 @@ protected:
     // fSubstitute should be used.
     virtual bool populate(SkPDFCatalog* catalog);
 
+    // Write what populate() would make the stream's data from, for
+    // emitDigest().  Returns false if it can't.
+    virtual bool emitDataDigest(SkWStream* stream);
+
     void setSubstitute(SkPDFStream* stream) {
         fSubstitute.reset(stream);
     }
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPDFStreamingDocument.h"
+
+#include "SkPDFCatalog.h"
+#include "SkPDFDevice.h"
+#include "SkPDFPage.h"
+#include "SkPDFStream.h"
+#include "SkPDFTypes.h"
+#include "SkStream.h"
+
+// Adds font, and the objects it uses, to fonts unless they're already resident.
+static void add_font(SkPDFFont* font, const SkTSet<SkPDFObject*>& resident,
+                     SkTSet<SkPDFObject*>* fonts) {
+    if (resident.contains(font) || fonts->contains(font)) {
+        return;
+    }
+    fonts->add(font);
+    font->ref();
+    font->getResources(resident, fonts);
+}
+
+SkPDFStreamingDocument::SkPDFStreamingDocument(SkWStream* stream, SkPDFDocument::Flags flags)
+        : fStream(stream),
+          fStartOffset(0),
+          fClosed(false),
+          fCatalog(SkNEW_ARGS(SkPDFCatalog, (flags))),
+          fDocCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog"))),
+          fPageTreeRoot(SkNEW_ARGS(SkPDFDict, ("Pages"))),
+          fDests(SkNEW(SkPDFDict)) {
+    SkASSERT(stream);
+    // Nothing is on the first page, as far as the catalog's concerned: we
+    // number objects in the order they're written.
+    fCatalog->addObject(fDocCatalog.get(), false);
+    fCatalog->addObject(fPageTreeRoot.get(), false);
+}
+
+SkPDFStreamingDocument::~SkPDFStreamingDocument() {
+    fPageStandIns.unrefAll();
+    fResidentResources.unrefAll();
+    fSubstitutes.unrefAll();
+}
+
+off_t SkPDFStreamingDocument::offset() const {
+    return (off_t)(fStream->bytesWritten() - fStartOffset);
+}
+
+void SkPDFStreamingDocument::emitIndirect(SkPDFObject* obj) {
+    fCatalog->addObject(obj, false);
+    fCatalog->setFileOffset(obj, this->offset());
+    obj->emit(fStream, fCatalog.get(), true);
+}
+
+bool SkPDFStreamingDocument::appendPage(SkPDFDevice* pdfDevice) {
+    if (fClosed) {
+        return false;
+    }
+
+    SkAutoTUnref<SkPDFPage> page(SkNEW_ARGS(SkPDFPage, (pdfDevice)));
+    page->insert("Parent", SkNEW_ARGS(SkPDFObjRef, (fPageTreeRoot.get())))->unref();
+
+    // Resources we've kept from earlier pages are known; everything else is
+    // new, and holds a ref from newResources.
+    SkTSet<SkPDFObject*> newResources;
+    page->finalizePage(fCatalog.get(), false, fResidentResources, &newResources);
+
+    // Fonts stay resident, to be subset and written by close().  Fonts used
+    // only by form XObjects show up in the glyph usage, not the font list.
+    const SkPDFGlyphSetMap& usage = page->getFontGlyphUsage();
+    fGlyphUsage.merge(usage);
+    SkTSet<SkPDFObject*> fonts;
+    const SkTDArray<SkPDFFont*>& fontResources = page->getFontResources();
+    for (int i = 0; i < fontResources.count(); i++) {
+        add_font(fontResources[i], fResidentResources, &fonts);
+    }
+    SkPDFGlyphSetMap::F2BIter iterator(usage);
+    for (const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
+         entry;
+         entry = iterator.next()) {
+        add_font(entry->fFont, fResidentResources, &fonts);
+    }
+    for (int i = 0; i < fonts.count(); i++) {
+        fCatalog->addObject(fonts[i], false);
+    }
+    // mergeInto returns the number of duplicates.
+    // If there are duplicates, there is a bug and we mess ref counting.
+    SkDEBUGCODE(int duplicates =) fResidentResources.mergeInto(fonts);
+    SkASSERT(duplicates == 0);
+
+    // Everything else is written now, but only once if it's drawn more
+    // than once on the page.
+    SkTDArray<SkPDFObject*> resources;
+    for (int i = 0; i < newResources.count(); i++) {
+        if (!fResidentResources.contains(newResources[i])) {
+            fCatalog->addObject(newResources[i], false);
+            resources.push(newResources[i]);
+        }
+    }
+    SkTSet<SkPDFObject*> merged;
+    fCatalog->mergeDuplicates(resources, &merged);
+
+    SkTDArray<SkPDFObject*> pageObjects;
+    pageObjects.push(page.get());
+    pageObjects.push(page->getContentStream());
+    for (int i = 0; i < resources.count(); i++) {
+        if (!merged.contains(resources[i])) {
+            pageObjects.push(resources[i]);
+        }
+    }
+    fCatalog->addObject(page.get(), false);
+    fCatalog->prepareObjects(pageObjects);
+
+    if (fPageStandIns.isEmpty()) {
+        fStartOffset = fStream->bytesWritten();
+        // The same header SkPDFDocument writes.
+        fStream->writeText("%PDF-1.4\n%");
+        fStream->write32(0xD3EBE9E1);
+        fStream->writeText("\n");
+    }
+    for (int i = 0; i < pageObjects.count(); i++) {
+        this->emitIndirect(pageObjects[i]);
+    }
+
+    // The page tree and destinations refer to the page through its stand-in.
+    SkPDFObject* standIn = SkNEW(SkPDFDict);
+    fCatalog->retireObject(page.get(), standIn);
+    for (int i = 1; i < pageObjects.count(); i++) {
+        fCatalog->retireObject(pageObjects[i], NULL);
+    }
+    for (int i = 0; i < merged.count(); i++) {
+        fCatalog->retireObject(merged[i], NULL);
+    }
+    pdfDevice->appendDestinations(fDests.get(), standIn);
+    fPageStandIns.push(standIn);  // Transfer ownership to fPageStandIns.
+
+    newResources.unrefAll();
+    return true;
+}
+
+bool SkPDFStreamingDocument::close() {
+    if (fClosed || fPageStandIns.isEmpty()) {
+        return false;
+    }
+    fClosed = true;
+
+    SkPDFGlyphSetMap::F2BIter iterator(fGlyphUsage);
+    for (const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
+         entry;
+         entry = iterator.next()) {
+        SkPDFFont* subsetFont = entry->fFont->getFontSubset(entry->fGlyphSet);
+        if (subsetFont) {
+            fCatalog->setSubstitute(entry->fFont, subsetFont);
+            fSubstitutes.push(subsetFont);  // Transfer ownership to fSubstitutes.
+        }
+    }
+
+    // A flat page tree: the pages are gone, so there's nothing to gain by
+    // balancing it.
+    SkAutoTUnref<SkPDFArray> kids(SkNEW(SkPDFArray));
+    kids->reserve(fPageStandIns.count());
+    for (int i = 0; i < fPageStandIns.count(); i++) {
+        kids->append(SkNEW_ARGS(SkPDFObjRef, (fPageStandIns[i])))->unref();
+    }
+    fPageTreeRoot->insert("Kids", kids.get());
+    fPageTreeRoot->insertInt("Count", fPageStandIns.count());
+    fDocCatalog->insert("Pages", SkNEW_ARGS(SkPDFObjRef, (fPageTreeRoot.get())))->unref();
+    if (fDests->size() > 0) {
+        fCatalog->addObject(fDests.get(), false);
+        fDocCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (fDests.get())))->unref();
+    }
+
+    // Compress the fonts, and the subsets' font files, on all threads.
+    fCatalog->prepareObjects();
+
+    this->emitIndirect(fDocCatalog.get());
+    this->emitIndirect(fPageTreeRoot.get());
+    if (fDests->size() > 0) {
+        this->emitIndirect(fDests.get());
+    }
+    for (int i = 0; i < fResidentResources.count(); i++) {
+        this->emitIndirect(fResidentResources[i]);
+    }
+    fCatalog->setSubstituteResourcesOffsets(this->offset(), false);
+    fCatalog->emitSubstituteResources(fStream, false);
+
+    const off_t xrefOffset = this->offset();
+    const int64_t objCount = fCatalog->emitXrefTable(fStream, false);
+
+    SkAutoTUnref<SkPDFDict> trailer(SkNEW(SkPDFDict));
+    trailer->insertInt("Size", int(objCount));
+    trailer->insert("Root", SkNEW_ARGS(SkPDFObjRef, (fDocCatalog.get())))->unref();
+    fStream->writeText("trailer\n");
+    trailer->emitObject(fStream, fCatalog.get(), false);
+    fStream->writeText("\nstartxref\n");
+    fStream->writeBigDecAsText(xrefOffset);
+    fStream->writeText("\n%%EOF");
+    return true;
+}
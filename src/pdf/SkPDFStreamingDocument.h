@@ -0,0 +1,86 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPDFStreamingDocument_DEFINED
+#define SkPDFStreamingDocument_DEFINED
+
+#include <sys/types.h>
+
+#include "SkPDFDocument.h"
+#include "SkPDFFont.h"
+#include "SkRefCnt.h"
+#include "SkTDArray.h"
+#include "SkTSet.h"
+#include "SkTemplates.h"
+
+class SkPDFCatalog;
+class SkPDFDevice;
+class SkPDFDict;
+class SkPDFObject;
+class SkWStream;
+
+/** \class SkPDFStreamingDocument
+
+    Like SkPDFDocument, but writes each page to the stream as it's appended,
+    so memory is bounded by the largest page rather than the whole document.
+
+    A page, its content stream and every resource it uses are written and
+    released by appendPage(), except fonts.  Fonts are likely shared between
+    pages and can't be subset until every page is known, so they stay
+    resident and are written by close(), along with the page tree and the
+    cross reference table.  Resources that aren't fonts are written once per
+    page that uses them.
+
+    The objects a page leaves behind in the catalog are stand-ins no bigger
+    than an empty dictionary, so the page tree and named destinations can
+    still refer to it.
+*/
+class SkPDFStreamingDocument : SkNoncopyable {
+public:
+    /** Create a PDF document that writes to stream, which must outlive it.
+     */
+    explicit SkPDFStreamingDocument(SkWStream* stream,
+                                    SkPDFDocument::Flags flags = (SkPDFDocument::Flags)0);
+    ~SkPDFStreamingDocument();
+
+    /** Write the page drawn into pdfDevice, and everything it uses except
+     *  fonts, to the stream.  Fails, writing nothing, after close().
+     */
+    bool appendPage(SkPDFDevice* pdfDevice);
+
+    /** Write the fonts, the page tree and the cross reference table to the
+     *  stream, finishing the PDF.  Returns false, writing nothing, if no
+     *  pages have been appended or it's already been closed.
+     */
+    bool close();
+
+private:
+    // Adds obj to the catalog, if need be, and writes it at the end of the stream.
+    void emitIndirect(SkPDFObject* obj);
+    off_t offset() const;
+
+    SkWStream* fStream;
+    size_t fStartOffset;  // Where the header was written, if it's been written.
+    bool fClosed;
+
+    SkAutoTDelete<SkPDFCatalog> fCatalog;
+    SkAutoTUnref<SkPDFDict> fDocCatalog;
+    SkAutoTUnref<SkPDFDict> fPageTreeRoot;
+    SkAutoTUnref<SkPDFDict> fDests;
+
+    // Each written page's place in the catalog.  Owns a ref on each.
+    SkTDArray<SkPDFObject*> fPageStandIns;
+
+    // Fonts and the objects they use, kept until close().  Owns a ref on each.
+    SkTSet<SkPDFObject*> fResidentResources;
+    SkPDFGlyphSetMap fGlyphUsage;
+
+    // Subsets of the resident fonts.  Owns a ref on each.
+    SkTDArray<SkPDFObject*> fSubstitutes;
+};
+
+#endif
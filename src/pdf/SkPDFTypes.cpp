@@ -34,6 +34,10 @@ size_t SkPDFObject::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
 void SkPDFObject::getResources(const SkTSet<SkPDFObject*>& knownResourceObjects,
                                SkTSet<SkPDFObject*>* newResourceObjects) {}
 
+bool SkPDFObject::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    return false;
+}
+
 void SkPDFObject::emitIndirectObject(SkWStream* stream, SkPDFCatalog* catalog) {
     catalog->emitObjectNumber(stream, this);
     stream->writeText(" obj\n");
@@ -89,6 +93,15 @@ size_t SkPDFObjRef::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
     return catalog->getObjectNumberSize(fObj.get()) + strlen(" R");
 }
 
+bool SkPDFObjRef::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    // The object itself, or what it's been merged into, stands in for its
+    // object number.
+    const SkPDFObject* obj = catalog->getMergedObject(fObj.get());
+    stream->write(&obj, sizeof(obj));
+    stream->writeText(" R");
+    return true;
+}
+
 SkPDFInt::SkPDFInt(int32_t value) : fValue(value) {}
 SkPDFInt::~SkPDFInt() {}
 
@@ -100,6 +113,11 @@ void SkPDFInt::emitObject(SkWStream* stream, SkPDFCatalog* catalog,
     stream->writeDecAsText(fValue);
 }
 
+bool SkPDFInt::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->emitObject(stream, catalog, false);
+    return true;
+}
+
 SkPDFBool::SkPDFBool(bool value) : fValue(value) {}
 SkPDFBool::~SkPDFBool() {}
 
@@ -121,6 +139,11 @@ size_t SkPDFBool::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
     return strlen("false");
 }
 
+bool SkPDFBool::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->emitObject(stream, catalog, false);
+    return true;
+}
+
 SkPDFScalar::SkPDFScalar(SkScalar value) : fValue(value) {}
 SkPDFScalar::~SkPDFScalar() {}
 
@@ -133,6 +156,11 @@ void SkPDFScalar::emitObject(SkWStream* stream, SkPDFCatalog* catalog,
     Append(fValue, stream);
 }
 
+bool SkPDFScalar::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->emitObject(stream, catalog, false);
+    return true;
+}
+
 // static
 void SkPDFScalar::Append(SkScalar value, SkWStream* stream) {
     // The range of reals in PDF/A is the same as SkFixed: +/- 32,767 and
@@ -209,6 +237,11 @@ size_t SkPDFString::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
     return fValue.size();
 }
 
+bool SkPDFString::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->emitObject(stream, catalog, false);
+    return true;
+}
+
 // static
 SkString SkPDFString::FormatString(const char* input, size_t len) {
     return DoFormatString(input, len, false, false);
@@ -293,6 +326,11 @@ size_t SkPDFName::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
     return fValue.size();
 }
 
+bool SkPDFName::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->emitObject(stream, catalog, false);
+    return true;
+}
+
 // static
 SkString SkPDFName::FormatName(const SkString& input) {
     SkASSERT(input.size() <= kMaxLen);
@@ -349,6 +387,20 @@ size_t SkPDFArray::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
     return result;
 }
 
+bool SkPDFArray::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    stream->writeText("[");
+    for (int i = 0; i < fValue.count(); i++) {
+        if (!fValue[i]->emitDigest(stream, catalog)) {
+            return false;
+        }
+        if (i + 1 < fValue.count()) {
+            stream->writeText(" ");
+        }
+    }
+    stream->writeText("]");
+    return true;
+}
+
 void SkPDFArray::reserve(int length) {
     SkASSERT(length <= kMaxLen);
     fValue.setReserve(length);
@@ -443,6 +495,21 @@ size_t SkPDFDict::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
     return result;
 }
 
+bool SkPDFDict::emitDigest(SkWStream* stream, SkPDFCatalog* catalog) {
+    SkAutoMutexAcquire lock(fMutex);
+    stream->writeText("<<");
+    for (int i = 0; i < fValue.count(); i++) {
+        fValue[i].key->emitObject(stream, catalog, false);
+        stream->writeText(" ");
+        if (!fValue[i].value->emitDigest(stream, catalog)) {
+            return false;
+        }
+        stream->writeText("\n");
+    }
+    stream->writeText(">>");
+    return true;
+}
+
 SkPDFObject*  SkPDFDict::append(SkPDFName* key, SkPDFObject* value) {
     SkASSERT(key);
     SkASSERT(value);
@@ -38,6 +38,27 @@ public:
      */
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
+    /** Do any expensive work needed to size and emit this object, like
+     *  compressing a stream, ahead of time.  This must not assign object
+     *  numbers or otherwise change the catalog, as it may be called for
+     *  many objects at once from different threads.
+     *  @param catalog  The object catalog to use.
+     */
+    virtual void prepare(SkPDFCatalog* catalog) {}
+
+    /** Write a digest of this object to stream and return true, so the
+     *  catalog can merge objects that would emit the same thing.  Two
+     *  objects may write the same digest only if they'd emit the same
+     *  object.  Unlike emitObject(), this doesn't assign object numbers or
+     *  compress anything: references write the object they refer to, and
+     *  streams write what they'd compress.  Objects whose content isn't
+     *  known until they're emitted return false, as the default does, and
+     *  are never merged.
+     *  @param stream   The writable output stream to send the digest to.
+     *  @param catalog  The object catalog to use.
+     */
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
+
     /** For non-primitive objects (i.e. objects defined outside this file),
      *  this method will add to newResourceObjects any objects that this method
      *  depends on, but not already in knownResourceObjects. This operates
@@ -119,6 +140,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
 private:
@@ -144,6 +166,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
 
 private:
     int32_t fValue;
@@ -168,6 +191,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
 private:
@@ -195,6 +219,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
 
 private:
     SkScalar fValue;
@@ -228,6 +253,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
     static SkString FormatString(const char* input, size_t len);
@@ -264,6 +290,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
 private:
@@ -292,6 +319,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
     /** The size of the array.
@@ -365,6 +393,7 @@ public:
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
+    virtual bool emitDigest(SkWStream* stream, SkPDFCatalog* catalog);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
 
     /** The size of the dictionary.
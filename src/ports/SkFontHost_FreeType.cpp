@@ -106,6 +106,27 @@ static bool         gLCDSupportValid;  // true iff |gLCDSupport| has been set.
 static bool         gLCDSupport;  // true iff LCD is supported by the runtime.
 static int          gLCDExtra;  // number of extra pixels for filtering.
 
+/*  By default every scaler context shares its typeface's face in gFTLibrary, so all glyph loading
+    and rendering in the process is serialized by gFTMutex.
+
+    With SK_FONTHOST_FREETYPE_PRIVATE_FACES defined, each scaler context instead gets an
+    FT_Library and FT_Face of its own, and uses them without taking any lock. A scaler context is
+    only used by one thread at a time (through its glyph cache), so contexts on different threads
+    rasterize fully in parallel. Faces given up by deleted contexts wait in gPrivateFaceHead to be
+    reused by the next context for their typeface, so re-creating a strike does not mean reopening
+    the font. Typeface level queries still go through gFTLibrary and gFTMutex.
+ */
+#ifdef SK_FONTHOST_FREETYPE_PRIVATE_FACES
+static const bool   gPrivateFaces = true;
+#else
+static const bool   gPrivateFaces = false;
+#endif
+
+SK_DECLARE_STATIC_MUTEX(gPrivateFaceMutex);
+static SkFaceRec*   gPrivateFaceHead;   // idle private faces, most recently used first
+static int          gPrivateFaceCount;
+static const int    kMaxIdlePrivateFaces = 16;
+
 /////////////////////////////////////////////////////////////////////////
 
 // FT_Library_SetLcdFilterWeights was introduced in FreeType 2.4.0.
@@ -117,21 +138,22 @@ static int          gLCDExtra;  // number of extra pixels for filtering.
 // Android >= Gingerbread (good)
 typedef FT_Error (*FT_Library_SetLcdFilterWeightsProc)(FT_Library, unsigned char*);
 
-// Caller must lock gFTMutex before calling this function.
-static bool InitFreetype() {
-    FT_Error err = FT_Init_FreeType(&gFTLibrary);
+// Creates a library, setting up LCD filtering if the runtime supports it.
+// *lcdSupported is set to whether it does.
+static bool init_ft_library(FT_Library* library, bool* lcdSupported) {
+    FT_Error err = FT_Init_FreeType(library);
     if (err) {
         return false;
     }
+    *lcdSupported = false;
 
     // Setup LCD filtering. This reduces color fringes for LCD smoothed glyphs.
 #ifdef FT_LCD_FILTER_H
     // Use default { 0x10, 0x40, 0x70, 0x40, 0x10 }, as it adds up to 0x110, simulating ink spread.
     // SetLcdFilter must be called before SetLcdFilterWeights.
-    err = FT_Library_SetLcdFilter(gFTLibrary, FT_LCD_FILTER_DEFAULT);
+    err = FT_Library_SetLcdFilter(*library, FT_LCD_FILTER_DEFAULT);
     if (0 == err) {
-        gLCDSupport = true;
-        gLCDExtra = 2; //Using a filter adds one full pixel to each side.
+        *lcdSupported = true;
 
 #ifdef SK_FONTHOST_FREETYPE_USE_NORMAL_LCD_FILTER
         // This also adds to 0x110 simulating ink spread, but provides better results than default.
@@ -139,7 +161,7 @@ static bool InitFreetype() {
 
 #if defined(SK_FONTHOST_FREETYPE_RUNTIME_VERSION) && \
             SK_FONTHOST_FREETYPE_RUNTIME_VERSION > 0x020400
-        err = FT_Library_SetLcdFilterWeights(gFTLibrary, gGaussianLikeHeavyWeights);
+        err = FT_Library_SetLcdFilterWeights(*library, gGaussianLikeHeavyWeights);
 #elif defined(SK_CAN_USE_DLOPEN) && SK_CAN_USE_DLOPEN == 1
         //The FreeType library is already loaded, so symbols are available in process.
         void* self = dlopen(NULL, RTLD_LAZY);
@@ -150,16 +172,34 @@ static bool InitFreetype() {
             dlclose(self);
 
             if (setLcdFilterWeights) {
-                err = setLcdFilterWeights(gFTLibrary, gGaussianLikeHeavyWeights);
+                err = setLcdFilterWeights(*library, gGaussianLikeHeavyWeights);
             }
         }
 #endif
 #endif
     }
-#else
-    gLCDSupport = false;
 #endif
+
+    return true;
+}
+
+// Records whether a library from init_ft_library() filters LCD glyphs. Every library is set up
+// alike, so this holds for all of them. Caller must lock gFTMutex.
+static void set_lcd_support(bool lcdSupported) {
+    gLCDSupport = lcdSupported;
+    if (lcdSupported) {
+        gLCDExtra = 2; //Using a filter adds one full pixel to each side.
+    }
     gLCDSupportValid = true;
+}
+
+// Caller must lock gFTMutex before calling this function.
+static bool InitFreetype() {
+    bool lcdSupported;
+    if (!init_ft_library(&gFTLibrary, &lcdSupported)) {
+        return false;
+    }
+    set_lcd_support(lcdSupported);
 
     return true;
 }
@@ -179,7 +219,8 @@ static void determine_lcd_support(bool* lcdSupported) {
 static bool is_lcd_supported() {
     static bool lcdSupported = false;
     SkOnce(&gLCDSupportValid, &gFTMutex, determine_lcd_support, &lcdSupported);
-    return lcdSupported;
+    // Support may have been recorded by a library created before we got here, skipping the once.
+    return gLCDSupport;
 }
 
 class SkScalerContext_FreeType : public SkScalerContext_FreeType_Base {
@@ -204,8 +245,9 @@ protected:
     virtual SkUnichar generateGlyphToChar(uint16_t glyph) SK_OVERRIDE;
 
 private:
+    SkBaseMutex* fFaceMutex;        // gFTMutex for a shared face, NULL for a private one
     SkFaceRec*  fFaceRec;
-    FT_Face     fFace;              // reference to shared face in gFaceRecHead
+    FT_Face     fFace;              // reference to shared face in gFaceRecHead, or our own
     FT_Size     fFTSize;            // our own copy
     FT_Int      fStrikeIndex;
     SkFixed     fScaleX, fScaleY;
@@ -222,9 +264,9 @@ private:
     void getBBoxForCurrentGlyph(SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock fFaceMutex before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock fFaceMutex before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph);
 };
@@ -235,6 +277,7 @@ private:
 struct SkFaceRec {
     SkFaceRec*      fNext;
     FT_Face         fFace;
+    FT_Library      fLibrary;       // the private library fFace was opened in, or NULL
     FT_StreamRec    fFTStream;
     SkStream*       fSkStream;
     uint32_t        fRefCnt;
@@ -279,7 +322,7 @@ extern "C" {
 }
 
 SkFaceRec::SkFaceRec(SkStream* strm, uint32_t fontID)
-        : fNext(NULL), fSkStream(strm), fRefCnt(1), fFontID(fontID) {
+        : fNext(NULL), fLibrary(NULL), fSkStream(strm), fRefCnt(1), fFontID(fontID) {
 //    SkDEBUGF(("SkFaceRec: opening %s (%p)\n", key.c_str(), strm));
 
     sk_bzero(&fFTStream, sizeof(fFTStream));
@@ -289,20 +332,9 @@ SkFaceRec::SkFaceRec(SkStream* strm, uint32_t fontID)
     fFTStream.close = sk_stream_close;
 }
 
-// Will return 0 on failure
-// Caller must lock gFTMutex before calling this function.
-static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+// Opens the typeface's font in library. Will return 0 on failure.
+static SkFaceRec* open_ft_face(FT_Library library, const SkTypeface* typeface) {
     const SkFontID fontID = typeface->uniqueID();
-    SkFaceRec* rec = gFaceRecHead;
-    while (rec) {
-        if (rec->fFontID == fontID) {
-            SkASSERT(rec->fFace);
-            rec->fRefCnt += 1;
-            return rec;
-        }
-        rec = rec->fNext;
-    }
-
     int face_index;
     SkStream* strm = typeface->openStream(&face_index);
     if (NULL == strm) {
@@ -310,7 +342,7 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
     }
 
     // this passes ownership of strm to the rec
-    rec = SkNEW_ARGS(SkFaceRec, (strm, fontID));
+    SkFaceRec* rec = SkNEW_ARGS(SkFaceRec, (strm, fontID));
 
     FT_Open_Args    args;
     memset(&args, 0, sizeof(args));
@@ -327,18 +359,37 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
         args.stream = &rec->fFTStream;
     }
 
-    FT_Error err = FT_Open_Face(gFTLibrary, &args, face_index, &rec->fFace);
+    FT_Error err = FT_Open_Face(library, &args, face_index, &rec->fFace);
     if (err) {    // bad filename, try the default font
         fprintf(stderr, "ERROR: unable to open font '%x'\n", fontID);
         SkDELETE(rec);
         return NULL;
-    } else {
-        SkASSERT(rec->fFace);
-        //fprintf(stderr, "Opened font '%s'\n", filename.c_str());
+    }
+    SkASSERT(rec->fFace);
+    //fprintf(stderr, "Opened font '%s'\n", filename.c_str());
+    return rec;
+}
+
+// Will return 0 on failure
+// Caller must lock gFTMutex before calling this function.
+static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+    const SkFontID fontID = typeface->uniqueID();
+    SkFaceRec* rec = gFaceRecHead;
+    while (rec) {
+        if (rec->fFontID == fontID) {
+            SkASSERT(rec->fFace);
+            rec->fRefCnt += 1;
+            return rec;
+        }
+        rec = rec->fNext;
+    }
+
+    rec = open_ft_face(gFTLibrary, typeface);
+    if (rec) {
         rec->fNext = gFaceRecHead;
         gFaceRecHead = rec;
-        return rec;
     }
+    return rec;
 }
 
 // Caller must lock gFTMutex before calling this function.
@@ -365,6 +416,70 @@ static void unref_ft_face(FT_Face face) {
     SkDEBUGFAIL("shouldn't get here, face not in list");
 }
 
+// Returns a face for the typeface in a library of its own, for the caller's use alone, reusing
+// an idle one if there is one. Will return 0 on failure.
+static SkFaceRec* acquire_private_face(const SkTypeface* typeface) {
+    const SkFontID fontID = typeface->uniqueID();
+    {
+        SkAutoMutexAcquire  ac(gPrivateFaceMutex);
+        SkFaceRec** prev = &gPrivateFaceHead;
+        for (SkFaceRec* rec = gPrivateFaceHead; rec; rec = rec->fNext) {
+            if (rec->fFontID == fontID) {
+                *prev = rec->fNext;
+                rec->fNext = NULL;
+                gPrivateFaceCount -= 1;
+                return rec;
+            }
+            prev = &rec->fNext;
+        }
+    }
+
+    // Opening the face is the slow part, so it's done outside of the lock.
+    FT_Library library;
+    bool lcdSupported;
+    if (!init_ft_library(&library, &lcdSupported)) {
+        return NULL;
+    }
+    {
+        // Glyph metrics pad LCD glyphs by gLCDExtra, which gFTLibrary may not have set up yet.
+        SkAutoMutexAcquire  ac(gFTMutex);
+        set_lcd_support(lcdSupported);
+    }
+    SkFaceRec* rec = open_ft_face(library, typeface);
+    if (NULL == rec) {
+        FT_Done_FreeType(library);
+        return NULL;
+    }
+    rec->fLibrary = library;
+    return rec;
+}
+
+// Gives a face from acquire_private_face() back, to wait for reuse.
+static void release_private_face(SkFaceRec* rec) {
+    SkASSERT(rec->fLibrary);
+    SkFaceRec* evicted = NULL;
+    {
+        SkAutoMutexAcquire  ac(gPrivateFaceMutex);
+        rec->fNext = gPrivateFaceHead;
+        gPrivateFaceHead = rec;
+        if (++gPrivateFaceCount > kMaxIdlePrivateFaces) {
+            // drop the face that has been idle longest, at the end of the list
+            SkFaceRec** last = &gPrivateFaceHead;
+            while ((*last)->fNext) {
+                last = &(*last)->fNext;
+            }
+            evicted = *last;
+            *last = NULL;
+            gPrivateFaceCount -= 1;
+        }
+    }
+    if (evicted) {
+        FT_Done_Face(evicted->fFace);
+        FT_Done_FreeType(evicted->fLibrary);
+        SkDELETE(evicted);
+    }
+}
+
 class AutoFTAccess {
 public:
     AutoFTAccess(const SkTypeface* tf) : fRec(NULL), fFace(NULL) {
@@ -852,21 +967,25 @@ static FT_Int chooseBitmapStrike(FT_Face face, SkFixed scaleY) {
 
 SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
                                                    const SkDescriptor* desc)
-        : SkScalerContext_FreeType_Base(typeface, desc) {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
-    if (gFTCount == 0) {
-        if (!InitFreetype()) {
-            sk_throw();
-        }
-    }
-    ++gFTCount;
+        : SkScalerContext_FreeType_Base(typeface, desc)
+        , fFaceMutex(gPrivateFaces ? NULL : &gFTMutex) {
+    SkAutoMutexAcquire  ac(fFaceMutex);
 
     // load the font file
     fStrikeIndex = -1;
     fFTSize = NULL;
     fFace = NULL;
-    fFaceRec = ref_ft_face(typeface);
+    if (gPrivateFaces) {
+        fFaceRec = acquire_private_face(typeface);
+    } else {
+        if (gFTCount == 0) {
+            if (!InitFreetype()) {
+                sk_throw();
+            }
+        }
+        ++gFTCount;
+        fFaceRec = ref_ft_face(typeface);
+    }
     if (NULL == fFaceRec) {
         return;
     }
@@ -1047,12 +1166,19 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
 }
 
 SkScalerContext_FreeType::~SkScalerContext_FreeType() {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceMutex);
 
     if (fFTSize != NULL) {
         FT_Done_Size(fFTSize);
     }
 
+    if (gPrivateFaces) {
+        if (fFaceRec != NULL) {
+            release_private_face(fFaceRec);
+        }
+        return;
+    }
+
     if (fFace != NULL) {
         unref_ft_face(fFace);
     }
@@ -1109,7 +1235,7 @@ void SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
     * which are very cheap to compute with some font formats...
     */
     if (fDoLinearMetrics) {
-        SkAutoMutexAcquire  ac(gFTMutex);
+        SkAutoMutexAcquire  ac(fFaceMutex);
 
         if (this->setupSize()) {
             glyph->zeroMetrics();
@@ -1210,7 +1336,7 @@ inline void scaleGlyphMetrics(SkGlyph& glyph, SkScalar scale) {
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceMutex);
 
     glyph->fRsbDelta = 0;
     glyph->fLsbDelta = 0;
@@ -1317,7 +1443,7 @@ void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
 
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceMutex);
 
     FT_Error    err;
 
@@ -1341,7 +1467,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 
 void SkScalerContext_FreeType::generatePath(const SkGlyph& glyph,
                                             SkPath* path) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceMutex);
 
     SkASSERT(path);
 
@@ -1382,7 +1508,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkPaint::FontMetrics* metrics
         return;
     }
 
-    SkAutoMutexAcquire ac(gFTMutex);
+    SkAutoMutexAcquire ac(fFaceMutex);
 
     if (this->setupSize()) {
         ERROR:
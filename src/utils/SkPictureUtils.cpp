@@ -12,7 +12,10 @@
 #include "SkPictureUtils.h"
 #include "SkPixelRef.h"
 #include "SkRRect.h"
+#include "SkRecordCompare.h"
 #include "SkShader.h"
+#include "SkSurface.h"
+#include "SkTaskGroup.h"
 
 class PixelRefSet {
 public:
@@ -218,3 +221,90 @@ SkData* SkPictureUtils::GatherPixelRefs(const SkPicture* pict, const SkRect& are
     }
     return data;
 }
+
+namespace {
+
+// Draws one tile of a DrawTiled() call into its own window of the shared pixels.
+class DrawTileTask : public SkRunnable {
+public:
+    DrawTileTask(const SkPicture* pict, const SkMatrix* matrix, const SkBitmap& tile,
+                 int left, int top)
+        : fPicture(pict), fMatrix(matrix), fTile(tile), fLeft(left), fTop(top) {}
+
+    virtual void run() SK_OVERRIDE {
+        SkCanvas canvas(fTile);
+        canvas.translate(-SkIntToScalar(fLeft), -SkIntToScalar(fTop));
+        if (fMatrix) {
+            canvas.concat(*fMatrix);
+        }
+        // The canvas' clip is just this tile, so playback only visits the ops the
+        // picture's BBH (if any) reports as touching it.
+        fPicture->playback(&canvas);
+        canvas.flush();
+    }
+
+private:
+    const SkPicture* fPicture;
+    const SkMatrix*  fMatrix;
+    SkBitmap         fTile;
+    const int        fLeft, fTop;
+};
+
+}  // namespace
+
+bool SkPictureUtils::DrawTiled(const SkPicture* pict, SkSurface* surface, const SkMatrix* matrix,
+                               int tileWidth, int tileHeight) {
+    if (NULL == pict || NULL == surface || tileWidth <= 0 || tileHeight <= 0) {
+        return false;
+    }
+
+    // Make sure no snapshot shares the pixels we're about to write to behind the surface's back.
+    surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+
+    SkImageInfo info;
+    size_t rowBytes;
+    void* pixels = const_cast<void*>(surface->peekPixels(&info, &rowBytes));
+    if (NULL == pixels) {
+        return false;
+    }
+
+    SkBitmap full;
+    if (!full.installPixels(info, pixels, rowBytes)) {
+        return false;
+    }
+
+    SkTDArray<DrawTileTask*> tasks;
+    for (int y = 0; y < info.height(); y += tileHeight) {
+        for (int x = 0; x < info.width(); x += tileWidth) {
+            SkBitmap tile;
+            if (full.extractSubset(&tile, SkIRect::MakeXYWH(x, y, tileWidth, tileHeight))) {
+                *tasks.append() = SkNEW_ARGS(DrawTileTask, (pict, matrix, tile, x, y));
+            }
+        }
+    }
+
+    SkTaskGroup tg;
+    for (int i = 0; i < tasks.count(); i++) {
+        tg.add(tasks[i]);
+    }
+    tg.wait();
+
+    tasks.deleteAll();
+    return true;
+}
+
+void SkPictureUtils::ComputeDamage(const SkPicture* before, const SkPicture* after,
+                                   SkRegion* damage) {
+    SkASSERT(before && after && damage);
+
+    SkRect bounds = before->cullRect();
+    bounds.join(after->cullRect());
+    SkIRect clip;
+    bounds.roundOut(&clip);
+
+    if (NULL == before->fRecord.get() || NULL == after->fRecord.get()) {
+        damage->setRect(clip);
+        return;
+    }
+    SkRecordComputeDamage(*before->fRecord, *after->fRecord, clip, damage);
+}
@@ -1,7 +1,9 @@
 #include "SkTaskGroup.h"
 
 #include "SkCondVar.h"
+#include "SkDeque.h"
 #include "SkTDArray.h"
+#include "SkTemplates.h"
 #include "SkThread.h"
 #include "SkThreadUtils.h"
 
@@ -20,13 +22,21 @@
 
 namespace {
 
+// Each thread in the pool owns a queue of Work, one deque per priority.  Tasks are spread across
+// the queues as they're added, so threads adding work rarely contend on the same lock.  A thread
+// takes work from the back of its own queue, and when that runs dry, steals work from the front
+// of the others'.  Higher priority work is always looked for first, in every queue.
 class ThreadPool : SkNoncopyable {
 public:
-    static void Add(SkRunnable* task, int32_t* pending) {
+    static void Add(SkRunnable* const tasks[], int count,
+                    SkTaskGroup::Priority priority, int32_t* pending) {
         if (!gGlobal) {  // If we have no threads, run synchronously.
-            return task->run();
+            for (int i = 0; i < count; i++) {
+                tasks[i]->run();
+            }
+            return;
         }
-        gGlobal->add(task, pending);
+        gGlobal->add(tasks, count, priority, pending);
     }
 
     static void Wait(int32_t* pending) {
@@ -37,14 +47,10 @@ public:
         while (sk_acquire_load(pending) > 0) {  // Pairs with sk_atomic_dec here or in Loop.
             // Lend a hand until our SkTaskGroup of interest is done.
             Work work;
-            {
-                AutoLock lock(&gGlobal->fReady);
-                if (gGlobal->fWork.isEmpty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                gGlobal->fWork.pop(&work);
+            if (!gGlobal->pop(-1, &work)) {
+                // Someone has picked up all the work (including ours).  How nice of them!
+                // (They may still be working on it, so we can't assert *pending == 0 here.)
+                continue;
             }
             // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
@@ -53,6 +59,8 @@ public:
         }
     }
 
+    static int ThreadCount() { return gGlobal ? gGlobal->fWorkers.count() : 0; }
+
 private:
     struct AutoLock {
         AutoLock(SkCondVar* c) : fC(c) { fC->lock(); }
@@ -66,63 +74,171 @@ private:
         int32_t* pending;  // then sk_atomic_dec(pending) afterwards.
     };
 
-    explicit ThreadPool(int threads) : fDraining(false) {
+    // One per thread in the pool.
+    struct Worker : SkNoncopyable {
+        Worker(ThreadPool* pool, int index)
+            : fPool(pool)
+            , fIndex(index)
+            , fHigh(sizeof(Work), kWorkPerBlock)
+            , fNormal(sizeof(Work), kWorkPerBlock)
+            , fLow(sizeof(Work), kWorkPerBlock) {
+            sk_bzero(fCount, sizeof(fCount));
+            fThread.reset(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, this)));
+        }
+
+        SkDeque& work(int priority) {
+            switch (priority) {
+                case SkTaskGroup::kHigh_Priority:   return fHigh;
+                case SkTaskGroup::kNormal_Priority: return fNormal;
+                default:                            return fLow;
+            }
+        }
+
+        static const int kWorkPerBlock = 64;
+
+        ThreadPool*             fPool;
+        int                     fIndex;
+        SkMutex                 fMutex;  // Guards the deques and fCount.
+        // Work in each priority's deque.  OK to peek without fMutex.
+        int32_t                 fCount[SkTaskGroup::kPriorityCount];
+        SkDeque                 fHigh, fNormal, fLow;
+        SkAutoTDelete<SkThread> fThread;
+    };
+
+    explicit ThreadPool(int threads) : fQueued(0), fSleeping(0), fNextWorker(0), fDraining(false) {
         if (threads == -1) {
             threads = num_cores();
         }
         for (int i = 0; i < threads; i++) {
-            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, this)));
-            fThreads.top()->start();
+            fWorkers.push(SkNEW_ARGS(Worker, (this, i)));
+        }
+        // Start the threads only after fWorkers is complete: they all look through it.
+        for (int i = 0; i < fWorkers.count(); i++) {
+            fWorkers[i]->fThread->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.isEmpty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(fQueued == 0);  // All SkTaskGroups should be destroyed by now.
         {
             AutoLock lock(&fReady);
             fDraining = true;
             fReady.broadcast();
         }
-        for (int i = 0; i < fThreads.count(); i++) {
-            fThreads[i]->join();
+        for (int i = 0; i < fWorkers.count(); i++) {
+            fWorkers[i]->fThread->join();
+        }
+        for (int i = 0; i < fWorkers.count(); i++) {
+            for (int priority = 0; priority < SkTaskGroup::kPriorityCount; priority++) {
+                SkASSERT(fWorkers[i]->fCount[priority] == 0);  // Can't hurt to double check.
+            }
         }
-        SkASSERT(fWork.isEmpty());  // Can't hurt to double check.
-        fThreads.deleteAll();
+        fWorkers.deleteAll();
     }
 
-    void add(SkRunnable* task, int32_t* pending) {
-        Work work = { task, pending };
-        sk_atomic_inc(pending);  // No barrier needed.
-        {
+    void add(SkRunnable* const tasks[], int count,
+             SkTaskGroup::Priority priority, int32_t* pending) {
+        if (count <= 0) {
+            return;
+        }
+        sk_atomic_add(pending, count);  // No barrier needed.
+
+        // Hand out the tasks in contiguous runs, taking each Worker's lock only once.
+        // We start at a different Worker each time to spread the load.
+        const int workers = fWorkers.count();
+        const int perWorker = (count + workers - 1) / workers;
+        unsigned next = (unsigned)sk_atomic_inc(&fNextWorker);
+        for (int i = 0; i < count; i += perWorker) {
+            Worker* worker = fWorkers[next++ % workers];
+            const int stop = SkTMin(i + perWorker, count);
+
+            SkAutoMutexAcquire lock(worker->fMutex);
+            SkDeque& deque = worker->work(priority);
+            for (int j = i; j < stop; j++) {
+                Work* work = (Work*)deque.push_back();
+                work->task    = tasks[j];
+                work->pending = pending;
+            }
+            worker->fCount[priority] += stop - i;
+        }
+
+        // sk_atomic_add is a full barrier, pairing with the one in Loop: either we see a thread
+        // that's about to sleep and wake it, or it sees our Work and doesn't go to sleep.
+        sk_atomic_add(&fQueued, count);
+        if (sk_acquire_load(&fSleeping) > 0) {
             AutoLock lock(&fReady);
-            fWork.push(work);
-            fReady.signal();
+            if (count == 1) {
+                fReady.signal();
+            } else {
+                fReady.broadcast();
+            }
         }
     }
 
+    // Find the highest priority Work in any queue, preferring self's own queue.
+    // Pass -1 for self when calling from a thread outside the pool.
+    bool pop(int self, Work* work) {
+        const int workers = fWorkers.count();
+        const int first = self < 0 ? 0 : self;
+        for (int priority = 0; priority < SkTaskGroup::kPriorityCount; priority++) {
+            for (int i = 0; i < workers; i++) {
+                Worker* worker = fWorkers[(first + i) % workers];
+                if (sk_acquire_load(&worker->fCount[priority]) == 0) {
+                    continue;  // Not worth taking the lock.  If we're wrong, Loop() retries.
+                }
+                SkAutoMutexAcquire lock(worker->fMutex);
+                SkDeque& deque = worker->work(priority);
+                if (deque.empty()) {
+                    continue;
+                }
+                // Our own newest work is likely still warm in cache; others' oldest is fairest.
+                if (worker->fIndex == self) {
+                    *work = *(Work*)deque.back();
+                    deque.pop_back();
+                } else {
+                    *work = *(Work*)deque.front();
+                    deque.pop_front();
+                }
+                worker->fCount[priority]--;
+                lock.release();
+
+                sk_atomic_dec(&fQueued);
+                return true;
+            }
+        }
+        return false;
+    }
+
     static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
+        Worker* self = (Worker*)arg;
+        ThreadPool* pool = self->fPool;
         Work work;
         while (true) {
-            {
-                AutoLock lock(&pool->fReady);
-                while (pool->fWork.isEmpty()) {
-                    if (pool->fDraining) {
-                        return;
-                    }
-                    pool->fReady.wait();
+            if (pool->pop(self->fIndex, &work)) {
+                work.task->run();
+                sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
+                continue;
+            }
+
+            AutoLock lock(&pool->fReady);
+            sk_atomic_inc(&pool->fSleeping);  // Full barrier, pairs with the one in add().
+            while (sk_acquire_load(&pool->fQueued) <= 0) {
+                if (pool->fDraining) {
+                    sk_atomic_dec(&pool->fSleeping);
+                    return;
                 }
-                pool->fWork.pop(&work);
+                pool->fReady.wait();
             }
-            work.task->run();
-            sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
+            sk_atomic_dec(&pool->fSleeping);
         }
     }
 
-    SkTDArray<Work>      fWork;
-    SkTDArray<SkThread*> fThreads;
-    SkCondVar            fReady;
-    bool                 fDraining;
+    SkTDArray<Worker*> fWorkers;
+    int32_t            fQueued;      // Work added but not yet popped.  May briefly dip below 0.
+    int32_t            fSleeping;    // Threads in Loop() that may be waiting on fReady.
+    int32_t            fNextWorker;  // Where add() starts handing out Work.
+    SkCondVar          fReady;
+    bool               fDraining;
 
     static ThreadPool* gGlobal;
     friend struct SkTaskGroup::Enabler;
@@ -140,10 +256,20 @@ SkTaskGroup::Enabler::Enabler(int threads) {
 
 SkTaskGroup::Enabler::~Enabler() {
     SkDELETE(ThreadPool::gGlobal);
+    ThreadPool::gGlobal = NULL;
 }
 
+int SkTaskGroup::ThreadCount() { return ThreadPool::ThreadCount(); }
+
 SkTaskGroup::SkTaskGroup() : fPending(0) {}
 
-void SkTaskGroup::add(SkRunnable* task) { ThreadPool::Add(task, &fPending); }
-void SkTaskGroup::wait()                { ThreadPool::Wait(&fPending); }
+void SkTaskGroup::add(SkRunnable* task, Priority priority) {
+    ThreadPool::Add(&task, 1, priority, &fPending);
+}
+
+void SkTaskGroup::batch(SkRunnable* const tasks[], int count, Priority priority) {
+    ThreadPool::Add(tasks, count, priority, &fPending);
+}
+
+void SkTaskGroup::wait() { ThreadPool::Wait(&fPending); }
 
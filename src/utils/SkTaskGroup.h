@@ -10,6 +10,8 @@
 
 #include "SkTypes.h"
 #include "SkRunnable.h"
+#include "SkTemplates.h"
+#include "SkThread.h"
 
 class SkTaskGroup : SkNoncopyable {
 public:
@@ -19,11 +21,29 @@ public:
         ~Enabler();
     };
 
+    // How many threads SkTaskGroups are sharing.  0 if there's no Enabler.
+    static int ThreadCount();
+
+    // Idle threads pick up higher priority tasks first.  Tasks of equal priority are not
+    // guaranteed to run in any particular order.
+    enum Priority {
+        kHigh_Priority,    // Latency-critical work, e.g. something a caller is about to wait() on.
+        kNormal_Priority,
+        kLow_Priority,     // Background work like prefetching or decoding ahead.
+
+        kLast_Priority = kLow_Priority
+    };
+    static const int kPriorityCount = kLast_Priority + 1;
+
     SkTaskGroup();
     ~SkTaskGroup() { this->wait(); }
 
     // Add a task to this SkTaskGroup.  It will likely run() on another thread.
-    void add(SkRunnable*);
+    void add(SkRunnable*, Priority = kNormal_Priority);
+
+    // Add count tasks to this SkTaskGroup at once.  This is cheaper than calling add() count
+    // times: the tasks are handed to the threads in a few large chunks instead of one at a time.
+    void batch(SkRunnable* const tasks[], int count, Priority = kNormal_Priority);
 
     // Block until all Tasks previously add()ed to this SkTaskGroup have run().
     // You may safely reuse this SkTaskGroup after wait() returns.
@@ -33,4 +53,153 @@ private:
     /*atomic*/ int32_t fPending;
 };
 
+namespace SkTaskGroupPrivate {
+
+// Each ForRunner repeatedly claims the next grain-sized chunk of [0, count) until none are left.
+template <typename Fn>
+class ForRunner : public SkRunnable {
+public:
+    ForRunner() : fFn(NULL), fNext(NULL), fCount(0), fGrain(1) {}
+
+    void init(Fn* fn, int32_t* next, int count, int grain) {
+        fFn = fn;
+        fNext = next;
+        fCount = count;
+        fGrain = grain;
+    }
+
+    virtual void run() SK_OVERRIDE {
+        int start;
+        while ((start = sk_atomic_add(fNext, fGrain)) < fCount) {
+            const int stop = SkTMin(start + fGrain, fCount);
+            for (int i = start; i < stop; i++) {
+                (*fFn)(i);
+            }
+        }
+    }
+
+private:
+    Fn*      fFn;
+    int32_t* fNext;
+    int      fCount, fGrain;
+};
+
+// Like ForRunner, but calls fn(i, &fPartial), accumulating its own partial result.
+template <typename T, typename Fn>
+class ReduceRunner : public SkRunnable {
+public:
+    ReduceRunner() : fFn(NULL), fNext(NULL), fCount(0), fGrain(1) {}
+
+    void init(Fn* fn, int32_t* next, int count, int grain, const T& identity) {
+        fFn = fn;
+        fNext = next;
+        fCount = count;
+        fGrain = grain;
+        fPartial = identity;
+    }
+
+    virtual void run() SK_OVERRIDE {
+        int start;
+        while ((start = sk_atomic_add(fNext, fGrain)) < fCount) {
+            const int stop = SkTMin(start + fGrain, fCount);
+            for (int i = start; i < stop; i++) {
+                (*fFn)(i, &fPartial);
+            }
+        }
+    }
+
+    const T& partial() const { return fPartial; }
+
+private:
+    Fn*      fFn;
+    int32_t* fNext;
+    int      fCount, fGrain;
+    T        fPartial;
+};
+
+// How many runners to use for count items in chunks of grain.  We make one more than there are
+// threads, as the thread calling wait() will lend a hand too.
+static inline int runner_count(int count, int grain) {
+    const int chunks = (count + grain - 1) / grain;
+    return SkTMin(chunks, SkTaskGroup::ThreadCount() + 1);
+}
+
+// Run all the runners on an SkTaskGroup, and wait for them to finish.
+template <typename Runner>
+static inline void run_all(Runner runners[], int n) {
+    SkAutoSTMalloc<16, SkRunnable*> tasks(n);
+    for (int i = 0; i < n; i++) {
+        tasks[i] = &runners[i];
+    }
+    SkTaskGroup tg;
+    tg.batch(tasks.get(), n, SkTaskGroup::kHigh_Priority);
+    tg.wait();
+}
+
+}  // namespace SkTaskGroupPrivate
+
+/**
+ *  Call fn(i) for each i in [0, count), spreading the calls across the SkTaskGroup threads in
+ *  chunks of grain consecutive indices.  fn(i) may be called concurrently from many threads, in
+ *  any order.  Returns once all calls have finished.
+ *
+ *  Pick grain so that grain calls do enough work to be worth handing to another thread.
+ *  Nothing is allocated per index or per chunk, just one small runner for each thread.
+ */
+template <typename Fn>
+void sk_parallel_for(int count, int grain, Fn& fn) {
+    SkASSERT(count >= 0);
+    grain = SkTMax(grain, 1);
+
+    const int n = SkTaskGroupPrivate::runner_count(count, grain);
+    if (n <= 1) {  // Not worth the trouble, or we've no threads anyway.
+        for (int i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    int32_t next = 0;
+    SkAutoSTArray<16, SkTaskGroupPrivate::ForRunner<Fn> > runners(n);
+    for (int i = 0; i < n; i++) {
+        runners[i].init(&fn, &next, count, grain);
+    }
+    SkTaskGroupPrivate::run_all(runners.get(), n);
+}
+
+/**
+ *  Like sk_parallel_for(), but reduces the indices [0, count) to a single T.
+ *
+ *  Each thread starts its own partial result from identity and calls fn(i, &partial) for each
+ *  index it picks up.  The partial results are then combined into the final result, which also
+ *  starts as identity, with fn.join(&result, partial).  The order indices are seen and partial
+ *  results joined is unspecified, so fn's accumulation and join should be commutative.
+ */
+template <typename T, typename Fn>
+T sk_parallel_reduce(int count, int grain, const T& identity, Fn& fn) {
+    SkASSERT(count >= 0);
+    grain = SkTMax(grain, 1);
+
+    T result = identity;
+    const int n = SkTaskGroupPrivate::runner_count(count, grain);
+    if (n <= 1) {
+        for (int i = 0; i < count; i++) {
+            fn(i, &result);
+        }
+        return result;
+    }
+
+    int32_t next = 0;
+    SkAutoSTArray<16, SkTaskGroupPrivate::ReduceRunner<T, Fn> > runners(n);
+    for (int i = 0; i < n; i++) {
+        runners[i].init(&fn, &next, count, grain, identity);
+    }
+    SkTaskGroupPrivate::run_all(runners.get(), n);
+
+    for (int i = 0; i < n; i++) {
+        fn.join(&result, runners[i].partial());
+    }
+    return result;
+}
+
 #endif//SkTaskGroup_DEFINED
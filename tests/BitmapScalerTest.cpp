@@ -0,0 +1,98 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapScaler.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static void make_noise(SkBitmap* bm, int width, int height, bool opaque) {
+    bm->allocN32Pixels(width, height, opaque);
+    SkRandom rand;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const U8CPU a = opaque ? 0xFF : rand.nextULessThan(256);
+            *bm->getAddr32(x, y) = SkPreMultiplyARGB(a, rand.nextULessThan(256),
+                                                        rand.nextULessThan(256),
+                                                        rand.nextULessThan(256));
+        }
+    }
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels lockA(a), lockB(b);
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const SkBitmapScaler::ResizeMethod methods[] = {
+    SkBitmapScaler::RESIZE_BOX,
+    SkBitmapScaler::RESIZE_TRIANGLE,
+    SkBitmapScaler::RESIZE_LANCZOS3,
+    SkBitmapScaler::RESIZE_HAMMING,
+    SkBitmapScaler::RESIZE_MITCHELL,
+};
+
+static const SkISize sizes[] = {
+    SkISize::Make(97, 63),    // Downscale.
+    SkISize::Make(1, 1),
+    SkISize::Make(700, 41),   // Upscale in x, downscale in y.
+    SkISize::Make(130, 500),  // The other way around.
+};
+
+// ResizeInParallel() must be bit-identical to Resize().
+DEF_TEST(BitmapScaler_Parallel, r) {
+    for (int opaque = 0; opaque < 2; opaque++) {
+        SkBitmap src;
+        make_noise(&src, 517, 389, SkToBool(opaque));
+
+        for (size_t m = 0; m < SK_ARRAY_COUNT(methods); m++) {
+            for (size_t s = 0; s < SK_ARRAY_COUNT(sizes); s++) {
+                const float w = SkIntToScalar(sizes[s].width()),
+                            h = SkIntToScalar(sizes[s].height());
+                SkBitmap serial, parallel;
+                REPORTER_ASSERT(r, SkBitmapScaler::Resize(&serial, src, methods[m], w, h));
+                REPORTER_ASSERT(r,
+                        SkBitmapScaler::ResizeInParallel(&parallel, src, methods[m], w, h));
+                REPORTER_ASSERT(r, same_pixels(serial, parallel));
+            }
+        }
+    }
+}
+
+// The AVX2 convolvers must be bit-identical to the SSE2 ones.
+DEF_TEST(BitmapScaler_AVX2, r) {
+    SkConvolutionProcs sse2 = { 0, NULL, NULL, NULL, NULL },
+                       avx2 = { 0, NULL, NULL, NULL, NULL };
+    SkBitmapScaler::PlatformConvolutionProcs(&sse2, SK_CPU_SSE_LEVEL_SSE2);
+    SkBitmapScaler::PlatformConvolutionProcs(&avx2, SK_CPU_SSE_LEVEL_AVX2);
+    if (sse2.fConvolveVertically == avx2.fConvolveVertically) {
+        return;  // No AVX2 on this machine or in this build.
+    }
+
+    for (int opaque = 0; opaque < 2; opaque++) {
+        SkBitmap src;
+        make_noise(&src, 517, 389, SkToBool(opaque));
+
+        for (size_t m = 0; m < SK_ARRAY_COUNT(methods); m++) {
+            for (size_t s = 0; s < SK_ARRAY_COUNT(sizes); s++) {
+                const float w = SkIntToScalar(sizes[s].width()),
+                            h = SkIntToScalar(sizes[s].height());
+                SkBitmap expected, actual;
+                REPORTER_ASSERT(r, SkBitmapScaler::Resize(&expected, src, methods[m], w, h, sse2));
+                REPORTER_ASSERT(r, SkBitmapScaler::Resize(&actual,   src, methods[m], w, h, avx2));
+                REPORTER_ASSERT(r, same_pixels(expected, actual));
+            }
+        }
+    }
+}
@@ -6,9 +6,11 @@
  */
 
 #include "SkBitmap.h"
+#include "SkBlitRow.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkGradientShader.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -262,3 +264,73 @@ DEF_TEST(BlitRow, reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
 }
+
+static SkPMColor random_pmcolor(SkRandom* rand) {
+    // Favor the opaque and transparent pixels the procs special-case.
+    U8CPU a;
+    switch (rand->nextU() % 4) {
+        case 0:  a = 0;    break;
+        case 1:  a = 0xFF; break;
+        default: a = rand->nextU() & 0xFF; break;
+    }
+    return SkPremultiplyARGBInline(a, rand->nextU() & 0xFF, rand->nextU() & 0xFF,
+                                   rand->nextU() & 0xFF);
+}
+
+static SkPMColor blit_row_32(unsigned flags, SkPMColor src, SkPMColor dst, U8CPU alpha) {
+    switch (flags) {
+        case 0:
+            return src;
+        case SkBlitRow::kGlobalAlpha_Flag32: {
+            unsigned scale = SkAlpha255To256(alpha);
+            return SkAlphaMulQ(src, scale) + SkAlphaMulQ(dst, 256 - scale);
+        }
+        case SkBlitRow::kSrcPixelAlpha_Flag32:
+            return SkPMSrcOver(src, dst);
+        default:
+            return SkBlendARGB32(src, dst, alpha);
+    }
+}
+
+// Whatever procs this CPU gets (SSE2, AVX2, NEON...) must match the portable math, for every
+// dst alignment and for counts on both sides of their vector widths.
+DEF_TEST(BlitRow_Procs32, reporter) {
+    static const int kMaxCount = 67;
+    static const int kMaxOffset = 8;
+    SkRandom rand;
+    SkPMColor src[kMaxCount], dst[kMaxCount + kMaxOffset], expected[kMaxCount];
+
+    // Every combination of kGlobalAlpha_Flag32 and kSrcPixelAlpha_Flag32.
+    for (unsigned flags = 0; flags < 4; flags++) {
+        SkBlitRow::Proc32 proc = SkBlitRow::Factory32(flags);
+        for (int count = 0; count <= kMaxCount; count++) {
+            for (int offset = 0; offset < kMaxOffset; offset++) {
+                // Callers only ask for kGlobalAlpha_Flag32 when alpha < 0xFF.
+                U8CPU alpha = (flags & SkBlitRow::kGlobalAlpha_Flag32) ? rand.nextU() % 0xFF
+                                                                       : 0xFF;
+                for (int i = 0; i < count; i++) {
+                    src[i] = random_pmcolor(&rand);
+                    dst[offset + i] = random_pmcolor(&rand);
+                    expected[i] = blit_row_32(flags, src[i], dst[offset + i], alpha);
+                }
+                proc(dst + offset, src, count, alpha);
+                REPORTER_ASSERT(reporter,
+                                0 == memcmp(dst + offset, expected, count * sizeof(SkPMColor)));
+            }
+        }
+    }
+
+    SkBlitRow::ColorProc colorProc = SkBlitRow::ColorProcFactory();
+    for (int count = 0; count <= kMaxCount; count++) {
+        for (int offset = 0; offset < kMaxOffset; offset++) {
+            SkPMColor color = random_pmcolor(&rand);
+            for (int i = 0; i < count; i++) {
+                src[i] = random_pmcolor(&rand);
+            }
+            SkBlitRow::Color32(expected, src, count, color);
+            colorProc(dst + offset, src, count, color);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(dst + offset, expected, count * sizeof(SkPMColor)));
+        }
+    }
+}
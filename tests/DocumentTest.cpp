@@ -1,9 +1,11 @@
 #include "Test.h"
 
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDocument.h"
 #include "SkOSFile.h"
 #include "SkStream.h"
+#include "SkString.h"
 
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
@@ -96,10 +98,86 @@ static void test_close(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, stream.bytesWritten() != 0);
 }
 
+static void draw_page(SkCanvas* canvas, SkColor color) {
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 50, 50), paint);
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawText("Skia", 4, 10, 80, paint);
+}
+
+// Like strstr(), but PDFs hold binary data.
+static const char* find(const char* begin, const char* end, const char str[]) {
+    const size_t len = strlen(str);
+    for (const char* p = begin; p + len <= end; p++) {
+        if (0 == memcmp(p, str, len)) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static void test_streaming(skiatest::Reporter* reporter) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+
+    draw_page(doc->beginPage(100, 100), SK_ColorRED);
+    doc->endPage();
+    // The first page is written as soon as it ends.
+    const size_t afterFirstPage = stream.bytesWritten();
+    REPORTER_ASSERT(reporter, afterFirstPage != 0);
+
+    draw_page(doc->beginPage(100, 100), SK_ColorBLUE);
+    doc->endPage();
+    REPORTER_ASSERT(reporter, stream.bytesWritten() > afterFirstPage);
+
+    REPORTER_ASSERT(reporter, doc->close());
+
+    SkAutoDataUnref data(stream.copyToData());
+    const char* pdf = static_cast<const char*>(data->data());
+    const char* end = pdf + data->size();
+    REPORTER_ASSERT(reporter, 0 == strncmp(pdf, "%PDF", 4));
+    REPORTER_ASSERT(reporter, find(pdf, end, "/Count 2"));
+    REPORTER_ASSERT(reporter, find(pdf, end, "%%EOF") == end - 5);
+
+    // Every object the cross reference table lists is where it says it is.
+    const char* xref = find(pdf, end, "\nxref\n");
+    REPORTER_ASSERT(reporter, xref);
+    if (NULL == xref) {
+        return;
+    }
+    int first, count;
+    REPORTER_ASSERT(reporter, 2 == sscanf(xref, "\nxref\n%d %d\n", &first, &count));
+    REPORTER_ASSERT(reporter, 0 == first && count > 1);
+    const char* entry = find(xref, end, "0000000000 65535 f \n");
+    REPORTER_ASSERT(reporter, entry);
+    if (NULL == entry) {
+        return;
+    }
+    for (int objNum = 1; objNum < count; objNum++) {
+        entry += 20;  // Each entry is 20 bytes.
+        long offset = atol(entry);
+        REPORTER_ASSERT(reporter, offset > 0 && offset < end - pdf);
+        SkString expected;
+        expected.printf("%d 0 obj", objNum);
+        REPORTER_ASSERT(reporter, 0 == strncmp(pdf + offset, expected.c_str(), expected.size()));
+    }
+}
+
+static void test_streaming_empty(skiatest::Reporter* reporter) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+
+    REPORTER_ASSERT(reporter, !doc->close());
+    REPORTER_ASSERT(reporter, stream.bytesWritten() == 0);
+}
+
 DEF_TEST(document_tests, reporter) {
     test_empty(reporter);
     test_abort(reporter);
     test_abortWithFile(reporter);
     test_file(reporter);
     test_close(reporter);
+    test_streaming(reporter);
+    test_streaming_empty(reporter);
 }
@@ -6,11 +6,15 @@
  */
 
 #include "Resources.h"
+#include "SkCanvas.h"
 #include "SkEndian.h"
 #include "SkFontStream.h"
+#include "SkGraphics.h"
 #include "SkOSFile.h"
 #include "SkPaint.h"
 #include "SkStream.h"
+#include "SkThread.h"
+#include "SkThreadUtils.h"
 #include "SkTypeface.h"
 #include "Test.h"
 
@@ -303,6 +307,83 @@ static void test_advances(skiatest::Reporter* reporter) {
     }
 }
 
+// More sizes than the FreeType host keeps idle private faces for, so faces get dropped too.
+static const int kThreadedSizeCount = 24;
+static const int kThreadedThreadCount = 4;
+static const char gThreadedText[] = "Hamburgefons 0123456789";
+
+static void draw_text_at_size(SkTypeface* face, int sizeIndex, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(320, 48);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTypeface(face);
+    paint.setTextSize(SkIntToScalar(10 + sizeIndex));
+    canvas.drawText(gThreadedText, strlen(gThreadedText), 2, 40, paint);
+}
+
+namespace {
+struct ThreadedDraw {
+    SkTypeface*     fFace;
+    const SkBitmap* fExpected;
+    int             fFirst;
+    int32_t*        fMismatches;
+};
+}
+
+// Each thread draws every size, starting from a different one.
+static void threaded_draw(void* arg) {
+    const ThreadedDraw* draw = (const ThreadedDraw*)arg;
+    for (int i = 0; i < kThreadedSizeCount; ++i) {
+        const int sizeIndex = (draw->fFirst + i) % kThreadedSizeCount;
+        SkBitmap bitmap;
+        draw_text_at_size(draw->fFace, sizeIndex, &bitmap);
+        const SkBitmap& expected = draw->fExpected[sizeIndex];
+        SkAutoLockPixels lockA(bitmap), lockB(expected);
+        if (0 != memcmp(bitmap.getPixels(), expected.getPixels(), bitmap.getSize())) {
+            sk_atomic_inc(draw->fMismatches);
+        }
+    }
+}
+
+// Rasterizes from several threads at once, while a tight strike limit keeps scaler contexts
+// (and so, with SK_FONTHOST_FREETYPE_PRIVATE_FACES, their private faces) coming and going.
+// Everything drawn must match drawing on one thread.
+DEF_TEST(FontHost_threaded, reporter) {
+    SkAutoTUnref<SkTypeface> face(SkTypeface::CreateFromFile(
+            GetResourcePath("Funkster.ttf").c_str()));
+    if (!face) {
+        return;  // This font host can't load fonts from files.
+    }
+
+    SkBitmap expected[kThreadedSizeCount];
+    for (int i = 0; i < kThreadedSizeCount; ++i) {
+        draw_text_at_size(face, i, &expected[i]);
+    }
+    SkGraphics::PurgeFontCache();
+    const int oldCountLimit = SkGraphics::SetFontCacheCountLimit(4);
+
+    int32_t mismatches = 0;
+    ThreadedDraw draws[kThreadedThreadCount];
+    SkAutoTDelete<SkThread> threads[kThreadedThreadCount];
+    for (int i = 0; i < kThreadedThreadCount; ++i) {
+        draws[i].fFace = face;
+        draws[i].fExpected = expected;
+        draws[i].fFirst = i * kThreadedSizeCount / kThreadedThreadCount;
+        draws[i].fMismatches = &mismatches;
+        threads[i].reset(SkNEW_ARGS(SkThread, (threaded_draw, &draws[i])));
+        REPORTER_ASSERT(reporter, threads[i]->start());
+    }
+    for (int i = 0; i < kThreadedThreadCount; ++i) {
+        threads[i]->join();
+    }
+    REPORTER_ASSERT(reporter, 0 == mismatches);
+
+    SkGraphics::PurgeFontCache();
+    SkGraphics::SetFontCacheCountLimit(oldCountLimit);
+}
+
 DEF_TEST(FontHost, reporter) {
     test_tables(reporter);
     test_fontstream(reporter);
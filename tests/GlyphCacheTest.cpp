@@ -0,0 +1,57 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkTaskGroup.h"
+#include "SkTypeface.h"
+#include "Test.h"
+#include "sk_tool_utils.h"
+
+static const char gText[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+namespace {
+// Measures the same text at a handful of sizes, so many threads share (and fight over) a few
+// strikes, while the tight limits set below keep purging them out from under each other.
+struct MeasureText {
+    void operator()(int i) {
+        SkPaint paint;
+        sk_tool_utils::set_portable_typeface(&paint);
+        paint.setTextSize(SkIntToScalar(9 + i % 8));
+        paint.setAntiAlias(SkToBool(i & 8));
+        SkScalar width = paint.measureText(gText, strlen(gText));
+        if (width != fWidths[i % 16]) {
+            sk_atomic_inc(&fMismatches);
+        }
+    }
+
+    SkScalar fWidths[16];
+    int32_t  fMismatches;
+};
+}
+
+DEF_TEST(GlyphCache_threaded, r) {
+    MeasureText measure;
+    for (int i = 0; i < 16; ++i) {
+        SkPaint paint;
+        sk_tool_utils::set_portable_typeface(&paint);
+        paint.setTextSize(SkIntToScalar(9 + i % 8));
+        paint.setAntiAlias(SkToBool(i & 8));
+        measure.fWidths[i] = paint.measureText(gText, strlen(gText));
+    }
+    measure.fMismatches = 0;
+
+    const int oldCountLimit = SkGraphics::SetFontCacheCountLimit(4);
+    sk_parallel_for(2000, 8, measure);
+    REPORTER_ASSERT(r, 0 == measure.fMismatches);
+    // Strikes in use can't be purged, so each thread may have held one past the limit.
+    REPORTER_ASSERT(r, SkGraphics::GetFontCacheCountUsed() <=
+                       SkGraphics::GetFontCacheCountLimit() + SkTaskGroup::ThreadCount() + 1);
+
+    SkGraphics::PurgeFontCache();
+    SkGraphics::SetFontCacheCountLimit(oldCountLimit);
+}
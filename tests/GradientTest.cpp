@@ -6,8 +6,11 @@
  */
 
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkGradientShader.h"
+#include "SkGradient_opts.h"
+#include "gradients/SkGradientShaderPriv.h"
 #include "SkShader.h"
 #include "SkTemplates.h"
 #include "Test.h"
@@ -189,7 +192,236 @@ static void TestGradientShaders(skiatest::Reporter* reporter) {
     }
 }
 
+// Portable references for the span procs, after SkLinearGradient.cpp and SkRadialGradient.cpp.
+static int ref_mirror_8bits(int x) {
+    if (x & 256) {
+        x = ~x;
+    }
+    return x & 255;
+}
+
+static int ref_linear_index(SkShader::TileMode mode, SkFixed fx) {
+    switch (mode) {
+        case SkShader::kRepeat_TileMode: return (fx >> 8) & 0xFF;
+        case SkShader::kMirror_TileMode: return ref_mirror_8bits(fx >> 8);
+        default:                         return fx >> 8;
+    }
+}
+
+static int ref_radial_clamp_index(SkFixed fx, SkFixed fy, const uint8_t sqrtTable[]) {
+    unsigned xx = SkPin32(fx, -0xFFFF >> 1, 0xFFFF >> 1);
+    unsigned yy = SkPin32(fy, -0xFFFF >> 1, 0xFFFF >> 1);
+    unsigned fi = SkFastMin32((xx * xx + yy * yy) >> (14 + 16 - 11), 0x7FF);
+    return sqrtTable[fi];
+}
+
+static int ref_radial_index(SkShader::TileMode mode, SkScalar fx, SkScalar fy) {
+    SkFixed dist = SkFloatToFixed(sk_float_sqrt(fx * fx + fy * fy));
+    if (SkShader::kMirror_TileMode == mode) {
+        dist = (dist ^ (dist << 15 >> 31)) & 0xFFFF;
+    } else {
+        dist &= 0xFFFF;
+    }
+    return dist >> 8;
+}
+
+// The platform span procs must pick the same cache entries as the portable loops, down to the
+// dither row, so they draw exactly the same pixels.
+static void TestPlatformSpanProcs(skiatest::Reporter* reporter) {
+    SkGradientSpanProcs procs;
+    SkGradientGetPlatformProcs(&procs);
+
+    // Each cache entry holds its own index, so dst shows which entry was read.
+    SkPMColor cache[4 * 256];
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(cache); ++i) {
+        cache[i] = i;
+    }
+    uint8_t sqrtTable[2048];
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(sqrtTable); ++i) {
+        sqrtTable[i] = i >> 3;
+    }
+
+    // Odd, and not a multiple of any vector width.
+    const int kCount = 37;
+    // Long enough for float positions accumulated a pixel at a time to drift.
+    const int kLongCount = 1021;
+    SkPMColor dst[kLongCount];
+
+    const struct {
+        SkShader::TileMode      fMode;
+        SkLinearGradientSpanProc fProc;
+        SkFixed                 fX, fDX;
+    } linear[] = {
+        { SkShader::kClamp_TileMode,  procs.fLinearClamp,  0x0100,   0x06C0 },
+        { SkShader::kClamp_TileMode,  procs.fLinearClamp,  0xFF00,  -0x06C0 },
+        { SkShader::kRepeat_TileMode, procs.fLinearRepeat, -0x12345, 0x1234 },
+        { SkShader::kRepeat_TileMode, procs.fLinearRepeat, 0x7FFF0000, 0x12345 },
+        { SkShader::kMirror_TileMode, procs.fLinearMirror, -0x12345, 0x1234 },
+        { SkShader::kMirror_TileMode, procs.fLinearMirror, 0x30000,  -0x2345 },
+    };
+
+    for (int toggle = 0; toggle < 4 * 256; toggle += 256) {
+        for (size_t i = 0; i < SK_ARRAY_COUNT(linear); ++i) {
+            if (NULL == linear[i].fProc) {
+                continue;
+            }
+            linear[i].fProc(linear[i].fX, linear[i].fDX, dst, cache, toggle, kCount);
+            uint32_t fx = linear[i].fX;
+            for (int j = 0; j < kCount; ++j) {
+                int row = (j & 1) ? toggle ^ 256 : toggle;
+                REPORTER_ASSERT(reporter,
+                                dst[j] == (SkPMColor)(row + ref_linear_index(linear[i].fMode, fx)));
+                fx += linear[i].fDX;
+            }
+        }
+
+        if (procs.fRadialClamp) {
+            // The first span crosses the pinned edge; the second stays inside the circle.
+            const SkFixed spans[][4] = {
+                { -0x9000,  0x0700,  0x2000, -0x0300 },
+                { -0x3000,  0x0100, -0x1000,  0x0080 },
+            };
+            for (size_t i = 0; i < SK_ARRAY_COUNT(spans); ++i) {
+                SkFixed fx = spans[i][0], dx = spans[i][1], fy = spans[i][2], dy = spans[i][3];
+                procs.fRadialClamp(fx, dx, fy, dy, sqrtTable, dst, cache, toggle, kCount);
+                for (int j = 0; j < kCount; ++j) {
+                    int row = (j & 1) ? toggle ^ 256 : toggle;
+                    REPORTER_ASSERT(reporter,
+                                    dst[j] == (SkPMColor)(row +
+                                                          ref_radial_clamp_index(fx, fy, sqrtTable)));
+                    fx += dx;
+                    fy += dy;
+                }
+            }
+        }
+
+        const struct {
+            SkShader::TileMode       fMode;
+            SkRadialGradientSpanProc fProc;
+        } radial[] = {
+            { SkShader::kRepeat_TileMode, procs.fRadialRepeat },
+            { SkShader::kMirror_TileMode, procs.fRadialMirror },
+        };
+        const struct {
+            SkScalar fX, fDX, fY, fDY;
+            int      fCount;
+        } radialSpans[] = {
+            { -1.3f,  0.071f,  0.4f,    0.023f,  kCount },
+            { -3.7f,  0.0071f, 1.1f,   -0.0023f, kLongCount },
+            { 25.5f, -0.0513f, -12.25f, 0.0317f, kLongCount },
+        };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(radial); ++i) {
+            if (NULL == radial[i].fProc) {
+                continue;
+            }
+            for (size_t k = 0; k < SK_ARRAY_COUNT(radialSpans); ++k) {
+                SkScalar fx = radialSpans[k].fX, dx = radialSpans[k].fDX,
+                         fy = radialSpans[k].fY, dy = radialSpans[k].fDY;
+                const int count = radialSpans[k].fCount;
+                radial[i].fProc(fx, dx, fy, dy, dst, cache, toggle, count);
+                int mismatches = 0;
+                for (int j = 0; j < count; ++j) {
+                    int row = (j & 1) ? toggle ^ 256 : toggle;
+                    if (dst[j] != (SkPMColor)(row + ref_radial_index(radial[i].fMode, fx, fy))) {
+                        mismatches++;
+                    }
+                    fx += dx;
+                    fy += dy;
+                }
+                REPORTER_ASSERT(reporter, 0 == mismatches);
+            }
+        }
+    }
+}
+
+// With kHighQualityInterpolation_Flag, a black to white gradient is an undithered ramp.
+static void TestHighQualityInterpolation(skiatest::Reporter* reporter) {
+    const int kWidth = 1024;
+    const SkPoint pts[] = { { 0, SK_ScalarHalf }, { SkIntToScalar(kWidth), SK_ScalarHalf } };
+    const SkColor colors[] = { SK_ColorBLACK, SK_ColorWHITE };
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kWidth, 2);
+    SkCanvas canvas(bitmap);
+    SkPaint paint;
+    paint.setDither(true);
+
+    paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+            SkShader::kClamp_TileMode,
+            SkGradientShader::kHighQualityInterpolation_Flag, NULL))->unref();
+    canvas.drawPaint(paint);
+
+    SkAutoLockPixels alp(bitmap);
+    int prev = 0;
+    for (int x = 0; x < kWidth; ++x) {
+        const SkPMColor c = *bitmap.getAddr32(x, 0);
+        const int expected = SkScalarRoundToInt(255 * (x + SK_ScalarHalf) / kWidth);
+        REPORTER_ASSERT(reporter, SkAbs32((int)SkGetPackedR32(c) - expected) <= 1);
+        REPORTER_ASSERT(reporter, (int)SkGetPackedR32(c) >= prev);
+        REPORTER_ASSERT(reporter, c == *bitmap.getAddr32(x, 1));
+        prev = SkGetPackedR32(c);
+    }
+
+    // Mirrored, the second radius retraces the first.  The center is on row 0's pixel centers.
+    const SkScalar radius = SkIntToScalar(kWidth / 4);
+    paint.setShader(SkGradientShader::CreateRadial(pts[0], radius, colors, NULL, 2,
+            SkShader::kMirror_TileMode,
+            SkGradientShader::kHighQualityInterpolation_Flag, NULL))->unref();
+    canvas.drawPaint(paint);
+    for (int x = 0; x < kWidth / 4; ++x) {
+        REPORTER_ASSERT(reporter,
+                        *bitmap.getAddr32(x, 0) == *bitmap.getAddr32(kWidth / 2 - 1 - x, 0));
+    }
+}
+
+class GradientShaderCacheTester {
+public:
+    typedef SkGradientShaderBase::GradientShaderCache GradientShaderCache;
+
+    static GradientShaderCache* RefCache(const SkShader* shader, U8CPU alpha) {
+        return static_cast<const SkGradientShaderBase*>(shader)->refCache(alpha);
+    }
+};
+
+static SkShader* make_linear(const SkColor colors[], SkShader::TileMode mode, SkScalar length) {
+    const SkPoint pts[] = { { 0, 0 }, { length, 0 } };
+    const SkScalar pos[] = { 0, 0.25f, 1 };
+    return SkGradientShader::CreateLinear(pts, colors, pos, 3, mode);
+}
+
+// Gradients with the same colors, positions and flags share one GradientShaderCache through
+// SkResourceCache, whatever their geometry and tiling.  Any difference gets its own.
+static void TestSharedCache(skiatest::Reporter* reporter) {
+    typedef GradientShaderCacheTester::GradientShaderCache GradientShaderCache;
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    const SkColor otherColors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorCYAN };
+
+    // Another test may purge the global cache between our lookups, so allow a few tries.
+    SkAutoTUnref<SkShader> a;
+    SkAutoTUnref<GradientShaderCache> cacheA;
+    bool shared = false;
+    for (int i = 0; i < 3 && !shared; ++i) {
+        a.reset(make_linear(colors, SkShader::kClamp_TileMode, 10));
+        cacheA.reset(GradientShaderCacheTester::RefCache(a, 0xFF));
+        SkAutoTUnref<SkShader> b(make_linear(colors, SkShader::kRepeat_TileMode, 20));
+        SkAutoTUnref<GradientShaderCache> cacheB(GradientShaderCacheTester::RefCache(b, 0xFF));
+        shared = cacheA.get() == cacheB.get();
+    }
+    REPORTER_ASSERT(reporter, shared);
+
+    SkAutoTUnref<SkShader> c(make_linear(otherColors, SkShader::kClamp_TileMode, 10));
+    SkAutoTUnref<GradientShaderCache> cacheC(GradientShaderCacheTester::RefCache(c, 0xFF));
+    REPORTER_ASSERT(reporter, cacheA.get() != cacheC.get());
+
+    SkAutoTUnref<GradientShaderCache> cacheHalf(GradientShaderCacheTester::RefCache(a, 0x80));
+    REPORTER_ASSERT(reporter, cacheA.get() != cacheHalf.get());
+    REPORTER_ASSERT(reporter, 0x80 == cacheHalf->getAlpha());
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
+    TestPlatformSpanProcs(reporter);
+    TestHighQualityInterpolation(reporter);
+    TestSharedCache(reporter);
 }
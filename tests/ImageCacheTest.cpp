@@ -114,3 +114,45 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+#include "SkTaskGroup.h"
+#include "SkThread.h"
+
+namespace {
+// Adds each key to the global cache, then looks it (and a neighbour) back up.
+struct GlobalAddFind {
+    void operator()(int i) {
+        TestingKey key(i);
+        SkResourceCache::Add(SkNEW_ARGS(TestingRec, (key, i)));
+
+        intptr_t value = -1;
+        if (SkResourceCache::Find(key, TestingRec::Visitor, &value) && value != i) {
+            sk_atomic_inc(&fMismatches);
+        }
+        (void)SkResourceCache::Find(TestingKey(i ^ 1), TestingRec::Visitor, &value);
+    }
+    int32_t fMismatches;
+};
+}
+
+DEF_TEST(ImageCache_globalThreaded, r) {
+    const size_t originalByteLimit = SkResourceCache::GetTotalByteLimit();
+    if (0 == originalByteLimit) {
+        return;  // The global cache is discardable, with no byte budget to check.
+    }
+    const size_t limit = 100 * sizeof(TestingRec);
+    SkResourceCache::SetTotalByteLimit(limit);
+
+    GlobalAddFind addFind;
+    addFind.fMismatches = 0;
+    sk_parallel_for(COUNT * 1000, 64, addFind);
+
+    REPORTER_ASSERT(r, 0 == addFind.fMismatches);
+    // One shard may borrow up to the whole budget, but every other shard then stays within its
+    // own share, so together they can never reach twice the budget.
+    REPORTER_ASSERT(r, SkResourceCache::GetTotalBytesUsed() <= 2 * limit);
+
+    SkResourceCache::SetTotalByteLimit(0);
+    REPORTER_ASSERT(r, 0 == SkResourceCache::GetTotalBytesUsed());
+    SkResourceCache::SetTotalByteLimit(originalByteLimit);
+}
@@ -364,6 +364,63 @@ DEF_TEST(TestNegativeBlurSigma, reporter) {
     test_negative_blur_sigma(&device, reporter);
 }
 
+static SkBitmap transpose(const SkBitmap& src) {
+    SkBitmap dst;
+    dst.allocN32Pixels(src.height(), src.width());
+    SkAutoLockPixels lockSrc(src);
+    for (int y = 0; y < src.height(); y++) {
+        for (int x = 0; x < src.width(); x++) {
+            *dst.getAddr32(y, x) = *src.getAddr32(x, y);
+        }
+    }
+    return dst;
+}
+
+static bool bitmaps_equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels lockA(a);
+    SkAutoLockPixels lockB(b);
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_blur_is_separable(SkBaseDevice* device, skiatest::Reporter* reporter) {
+    // The raster blur works on bands of rows, transposing between x and y. Check that bands,
+    // band remainders and transposes all line up, by blurring in x and y in different ways.
+    SkDeviceImageFilterProxy proxy(device);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+    SkScalar three = SkIntToScalar(3), five = SkIntToScalar(5);
+    SkAutoTUnref<SkImageFilter> blurXY(SkBlurImageFilter::Create(three, five));
+    SkAutoTUnref<SkImageFilter> blurX(SkBlurImageFilter::Create(three, 0));
+    SkAutoTUnref<SkImageFilter> blurY(SkBlurImageFilter::Create(0, five));
+    SkAutoTUnref<SkImageFilter> blurYByThree(SkBlurImageFilter::Create(0, three));
+
+    SkBitmap gradient = make_gradient_circle(250, 190);
+    SkBitmap xy, x, xThenY, transposedY;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, blurXY->filterImage(&proxy, gradient, ctx, &xy, &offset));
+    REPORTER_ASSERT(reporter, blurX->filterImage(&proxy, gradient, ctx, &x, &offset));
+    REPORTER_ASSERT(reporter, blurY->filterImage(&proxy, x, ctx, &xThenY, &offset));
+    REPORTER_ASSERT(reporter, blurYByThree->filterImage(&proxy, transpose(gradient), ctx,
+                                                        &transposedY, &offset));
+
+    REPORTER_ASSERT(reporter, bitmaps_equal(xy, xThenY));
+    REPORTER_ASSERT(reporter, bitmaps_equal(x, transpose(transposedY)));
+}
+
+DEF_TEST(BlurImageFilterSeparable, reporter) {
+    SkBitmap temp;
+    temp.allocN32Pixels(100, 100);
+    SkBitmapDevice device(temp);
+    test_blur_is_separable(&device, reporter);
+}
+
 DEF_TEST(ImageFilterDrawTiled, reporter) {
     // Check that all filters when drawn tiled (with subsequent clip rects) exactly
     // match the same filters drawn with a single full-canvas bitmap draw.
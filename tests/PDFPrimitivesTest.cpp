@@ -7,16 +7,20 @@
 
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkChecksum.h"
 #include "SkData.h"
 #include "SkFlate.h"
 #include "SkImageEncoder.h"
 #include "SkMatrix.h"
 #include "SkPDFCatalog.h"
 #include "SkPDFDevice.h"
+#include "SkPDFImage.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
 #include "SkScalar.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkThread.h"
 #include "SkTypes.h"
 #include "Test.h"
 
@@ -162,6 +166,15 @@ static void TestPDFStream(skiatest::Reporter* reporter) {
         CheckObjectOutput(reporter, stream.get(),
                           (const char*) expectedResultData2->data(),
                           expectedResultData2->size(), true, true);
+
+        // Compressing ahead of time, as documents do, gives the same output.
+        SkAutoTUnref<SkPDFStream> prepared(new SkPDFStream(streamData2.get()));
+        SkPDFCatalog catalog((SkPDFDocument::Flags)0);
+        catalog.addObject(prepared.get(), false);
+        catalog.prepareObjects();
+        CheckObjectOutput(reporter, prepared.get(),
+                          (const char*) expectedResultData2->data(),
+                          expectedResultData2->size(), true, true);
     }
 }
 
@@ -241,6 +254,54 @@ static void TestSubstitute(skiatest::Reporter* reporter) {
                                             buffer.getOffset()));
 }
 
+static void TestMergeDuplicates(skiatest::Reporter* reporter) {
+    // Two identical streams, each referred to by one of two identical dicts,
+    // and a stream that's different.
+    SkAutoTUnref<SkData> data(SkData::NewWithCopy("Some data", 9));
+    SkAutoTUnref<SkData> otherData(SkData::NewWithCopy("Other data", 10));
+    SkAutoTUnref<SkPDFStream> stream1(new SkPDFStream(data.get()));
+    SkAutoTUnref<SkPDFStream> stream2(new SkPDFStream(data.get()));
+    SkAutoTUnref<SkPDFStream> stream3(new SkPDFStream(otherData.get()));
+    SkAutoTUnref<SkPDFDict> dict1(new SkPDFDict);
+    SkAutoTUnref<SkPDFDict> dict2(new SkPDFDict);
+    dict1->insert("Stream", new SkPDFObjRef(stream1.get()))->unref();
+    dict2->insert("Stream", new SkPDFObjRef(stream2.get()))->unref();
+
+    SkPDFCatalog catalog((SkPDFDocument::Flags)0);
+    SkTDArray<SkPDFObject*> objects;
+    objects.push(dict1.get());
+    objects.push(dict2.get());
+    objects.push(stream1.get());
+    objects.push(stream2.get());
+    objects.push(stream3.get());
+    for (int i = 0; i < objects.count(); i++) {
+        catalog.addObject(objects[i], false);
+    }
+
+    // The dicts are only the same once their streams are merged.
+    SkTSet<SkPDFObject*> duplicates;
+    catalog.mergeDuplicates(objects, &duplicates);
+    REPORTER_ASSERT(reporter, 2 == duplicates.count());
+    REPORTER_ASSERT(reporter, duplicates.contains(dict2.get()));
+    REPORTER_ASSERT(reporter, duplicates.contains(stream2.get()));
+    REPORTER_ASSERT(reporter, catalog.getMergedObject(stream2.get()) == stream1.get());
+    REPORTER_ASSERT(reporter, catalog.getMergedObject(stream3.get()) == stream3.get());
+
+    SkDynamicMemoryWStream buffer1, buffer2;
+    catalog.emitObjectNumber(&buffer1, stream1.get());
+    catalog.emitObjectNumber(&buffer2, stream2.get());
+    SkAutoDataUnref number1(buffer1.copyToData());
+    SkAutoDataUnref number2(buffer2.copyToData());
+    REPORTER_ASSERT(reporter, number1->equals(number2));
+
+    // Only three objects are left to emit.
+    catalog.setFileOffset(dict1.get(), 1);
+    catalog.setFileOffset(stream1.get(), 2);
+    catalog.setFileOffset(stream3.get(), 3);
+    SkDynamicMemoryWStream xref;
+    REPORTER_ASSERT(reporter, 4 == catalog.emitXrefTable(&xref, false));
+}
+
 // Create a bitmap that would be very eficiently compressed in a ZIP.
 static void setup_bitmap(SkBitmap* bitmap, int width, int height) {
     bitmap->allocN32Pixels(width, height);
@@ -316,10 +377,106 @@ static void TestDCTDecode(skiatest::Reporter* reporter) {
               true);
 }
 
+static int count_images(const SkDynamicMemoryWStream& stream) {
+    SkAutoDataUnref data(stream.copyToData());
+    const char image[] = "/Subtype /Image";
+    const size_t len = strlen(image);
+    int count = 0;
+    for (size_t offset = 0; offset + len <= data->size(); offset++) {
+        if (memcmp(data->bytes() + offset, image, len) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void TestDuplicateImages(skiatest::Reporter* reporter) {
+    // Two bitmaps with the same pixels, and one without.
+    SkBitmap white1, white2, red;
+    setup_bitmap(&white1, 10, 10);
+    setup_bitmap(&white2, 10, 10);
+    setup_bitmap(&red, 10, 10);
+    red.eraseColor(SK_ColorRED);
+
+    SkPDFDocument doc;
+    SkISize pageSize = SkISize::Make(100, 100);
+    const SkBitmap* pages[][2] = { { &white1, &red }, { &white2, &white1 } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(pages); i++) {
+        SkAutoTUnref<SkPDFDevice> dev(new SkPDFDevice(pageSize, pageSize, SkMatrix::I()));
+        SkCanvas c(dev);
+        c.drawBitmap(*pages[i][0], 0, 0, NULL);
+        c.drawBitmap(*pages[i][1], 20, 20, NULL);
+        doc.appendPage(dev);
+    }
+
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(reporter, doc.emitPDF(&stream));
+    REPORTER_ASSERT(reporter, 2 == count_images(stream));
+}
+
+static int32_t gEncodersRunning;
+static bool gEncodersOverlapped;
+
+// "Encodes" a bitmap as its checksum, slowly enough that other threads have time to call it too.
+static SkData* encode_checking_overlap(size_t* pixelRefOffset, const SkBitmap& bitmap) {
+    if (sk_atomic_inc(&gEncodersRunning) > 0) {
+        gEncodersOverlapped = true;
+    }
+    SkAutoLockPixels lock(bitmap);
+    uint32_t checksum = 0;
+    for (int i = 0; i < 1000; i++) {
+        checksum += SkChecksum::Compute(bitmap.getAddr32(0, 0), bitmap.getSize());
+    }
+    sk_atomic_dec(&gEncodersRunning);
+    *pixelRefOffset = 0;
+    return SkData::NewWithCopy(&checksum, sizeof(checksum));
+}
+
+// Emits images the catalog has prepared, in parallel on skia_test's SkTaskGroup threads, and
+// checks they match the same images populated one by one as they're emitted.
+static void TestPreparedImages(skiatest::Reporter* reporter) {
+    if (0 == SkTaskGroup::ThreadCount()) {
+        return;  // Nothing to run in parallel with; prepareObjects() would just be serial.
+    }
+
+    SkPDFCatalog parallelCatalog((SkPDFDocument::Flags)0);
+    SkPDFCatalog serialCatalog((SkPDFDocument::Flags)0);
+    SkTDArray<SkPDFObject*> parallel, serial;
+    for (int i = 0; i < 16; i++) {
+        SkBitmap bitmap;
+        setup_bitmap(&bitmap, 32 + i, 32);
+        bitmap.eraseColor(SkColorSetRGB(16 * i, 255 - 16 * i, 128));
+        // Half are deflated, half go to the encoder.
+        SkPicture::EncodeBitmap encoder = (i & 1) ? encode_checking_overlap : NULL;
+        const SkIRect srcRect = SkIRect::MakeWH(bitmap.width(), bitmap.height());
+        *parallel.append() = SkPDFImage::CreateImage(bitmap, srcRect, encoder);
+        *serial.append() = SkPDFImage::CreateImage(bitmap, srcRect, encoder);
+        parallelCatalog.addObject(parallel[i], false);
+        serialCatalog.addObject(serial[i], false);
+    }
+
+    gEncodersOverlapped = false;
+    parallelCatalog.prepareObjects();
+    REPORTER_ASSERT(reporter, !gEncodersOverlapped);
+
+    for (int i = 0; i < parallel.count(); i++) {
+        SkDynamicMemoryWStream parallelStream, serialStream;
+        parallel[i]->emit(&parallelStream, &parallelCatalog, true);
+        serial[i]->emit(&serialStream, &serialCatalog, true);
+        SkAutoDataUnref parallelData(parallelStream.copyToData());
+        SkAutoDataUnref serialData(serialStream.copyToData());
+        REPORTER_ASSERT(reporter, parallelData->equals(serialData));
+    }
+    parallel.unrefAll();
+    serial.unrefAll();
+}
+
 static void TestImages(skiatest::Reporter* reporter) {
     TestUncompressed(reporter);
     TestFlateDecode(reporter);
     TestDCTDecode(reporter);
+    TestDuplicateImages(reporter);
+    TestPreparedImages(reporter);
 }
 
 // This test used to assert without the fix submitted for
@@ -424,6 +581,8 @@ DEF_TEST(PDFPrimitives, reporter) {
 
     TestSubstitute(reporter);
 
+    TestMergeDuplicates(reporter);
+
     test_issue1083();
 
     TestImages(reporter);
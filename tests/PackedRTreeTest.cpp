@@ -0,0 +1,101 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPackedRTree.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static const int NUM_RECTS = 200;
+static const int NUM_ITERATIONS = 20;
+static const int NUM_QUERIES = 50;
+
+static SkRect random_rect(SkRandom& rand) {
+    SkRect rect = {0,0,0,0};
+    while (rect.isEmpty()) {
+        rect.fLeft   = rand.nextRangeF(0, 1000);
+        rect.fRight  = rand.nextRangeF(0, 1000);
+        rect.fTop    = rand.nextRangeF(0, 1000);
+        rect.fBottom = rand.nextRangeF(0, 1000);
+        rect.sort();
+    }
+    return rect;
+}
+
+// Unlike SkRTree, we expect exactly the intersecting rects, in opIndex order.
+static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, const SkRect rects[],
+                        const SkPackedRTree& tree) {
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        const SkRect query = random_rect(rand);
+        SkTDArray<unsigned> expected;
+        for (int j = 0; j < NUM_RECTS; ++j) {
+            if (SkRect::Intersects(query, rects[j])) {
+                expected.push(j);
+            }
+        }
+
+        SkTDArray<unsigned> found;
+        tree.search(query, &found);
+        REPORTER_ASSERT(reporter, found == expected);
+    }
+}
+
+static void packed_rtree_test_main(SkPackedRTree::Order order, skiatest::Reporter* reporter) {
+    SkRect rects[NUM_RECTS];
+    SkRandom rand;
+
+    // 200 rects pack into 13 nodes under a root.
+    const int expectedDepth = 3;
+
+    for (int i = 0; i < NUM_ITERATIONS; ++i) {
+        for (int j = 0; j < NUM_RECTS; ++j) {
+            rects[j] = random_rect(rand);
+        }
+
+        // Bulk-loaded, as pictures build their BBH.
+        SkPackedRTree bulk(1000, 1000, order);
+        bulk.reserve(NUM_RECTS);
+        for (int j = 0; j < NUM_RECTS; ++j) {
+            bulk.insert(j, rects[j], true);
+        }
+        bulk.flushDeferredInserts();
+        REPORTER_ASSERT(reporter, NUM_RECTS == bulk.getCount());
+        REPORTER_ASSERT(reporter, expectedDepth == bulk.getDepth());
+        run_queries(reporter, rand, rects, bulk);
+
+        // Inserted in reverse and half at a time, rebuilding each time.
+        SkPackedRTree rebuilt(0, 0, order);
+        for (int j = NUM_RECTS - 1; j >= NUM_RECTS / 2; --j) {
+            rebuilt.insert(j, rects[j], true);
+        }
+        rebuilt.flushDeferredInserts();
+        for (int j = NUM_RECTS / 2 - 1; j >= 0; --j) {
+            rebuilt.insert(j, rects[j], j > 0);
+        }
+        REPORTER_ASSERT(reporter, NUM_RECTS == rebuilt.getCount());
+        REPORTER_ASSERT(reporter, expectedDepth == rebuilt.getDepth());
+        run_queries(reporter, rand, rects, rebuilt);
+    }
+}
+
+DEF_TEST(PackedRTree, reporter) {
+    packed_rtree_test_main(SkPackedRTree::kHilbert_Order, reporter);
+    packed_rtree_test_main(SkPackedRTree::kOpIndex_Order, reporter);
+
+    SkPackedRTree tree(100, 100);
+    SkTDArray<unsigned> found;
+    tree.search(SkRect::MakeWH(100, 100), &found);
+    REPORTER_ASSERT(reporter, found.isEmpty());
+
+    // Empty bounds can't intersect anything, so they're dropped.
+    tree.insert(0, SkRect::MakeEmpty(), true);
+    tree.insert(1, SkRect::MakeXYWH(10, 10, 10, 10), true);
+    tree.flushDeferredInserts();
+    REPORTER_ASSERT(reporter, 1 == tree.getCount());
+    REPORTER_ASSERT(reporter, 1 == tree.getDepth());
+    tree.search(SkRect::MakeWH(100, 100), &found);
+    REPORTER_ASSERT(reporter, 1 == found.count() && 1 == found[0]);
+}
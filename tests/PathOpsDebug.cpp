@@ -440,7 +440,7 @@ void SkIntersectionHelper::dump() const {
     }
 }
 
-const SkTDArray<SkOpSpan>& SkOpSegment::debugSpans() const {
+const SkOpSpanArray& SkOpSegment::debugSpans() const {
     return fTs;
 }
 
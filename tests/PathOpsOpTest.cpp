@@ -3511,10 +3511,34 @@ static void issue2808(skiatest::Reporter* reporter, const char* filename) {
     testPathOp(reporter, path1, path2, kUnion_PathOp, filename);
 }
 
+// Enough segments in one contour that finding intersections walks a multi-level bounds tree.
+static void add_wavy_circle(SkPath* path, SkScalar cx, SkScalar cy, int count) {
+    for (int i = 0; i < count; ++i) {
+        SkScalar angle = SK_ScalarPI * 2 * i / count;
+        SkScalar radius = 40 + 4 * SkScalarSin(angle * 25);
+        SkScalar x = cx + radius * SkScalarCos(angle);
+        SkScalar y = cy + radius * SkScalarSin(angle);
+        if (0 == i) {
+            path->moveTo(x, y);
+        } else {
+            path->lineTo(x, y);
+        }
+    }
+    path->close();
+}
+
+static void manySegments(skiatest::Reporter* reporter, const char* filename) {
+    SkPath path, pathB;
+    add_wavy_circle(&path, 50, 50, 600);
+    add_wavy_circle(&pathB, 70, 60, 600);
+    testPathOp(reporter, path, pathB, kIntersect_PathOp, filename);
+}
+
 static void (*firstTest)(skiatest::Reporter* , const char* filename) = 0;
 static void (*stopTest)(skiatest::Reporter* , const char* filename) = 0;
 
 static struct TestDesc tests[] = {
+    TEST(manySegments),
     TEST(issue2753),  // FIXME: pair of cubics miss intersection
     TEST(cubicOp114),  // FIXME: curve with inflection is ordered the wrong way
     TEST(issue2808),
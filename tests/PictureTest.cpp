@@ -13,10 +13,12 @@
 #include "SkData.h"
 #include "SkDecodingImageGenerator.h"
 #include "SkError.h"
+#include "SkGradientShader.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
+#include "SkPictureData.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
 #include "SkPixelRef.h"
@@ -24,9 +26,10 @@
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkStreamingPictureRecorder.h"
+#include "SkSurface.h"
 
 #if SK_SUPPORT_GPU
-#include "SkSurface.h"
 #include "GrContextFactory.h"
 #include "GrPictureUtils.h"
 #endif
@@ -1919,3 +1922,425 @@ DEF_TEST(Picture_BitmapLeak, r) {
     REPORTER_ASSERT(r, mut.pixelRef()->unique());
     REPORTER_ASSERT(r, immut.pixelRef()->unique());
 }
+
+// Tiled parallel playback should draw exactly what a single serial playback draws.
+// (Everything here is pixel aligned, so float rounding can't differ from tile to tile.)
+DEF_TEST(Picture_DrawTiled, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(150, 100, &factory);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 100, 60), paint);
+        paint.setColor(0x8000FF00);
+        canvas->drawRect(SkRect::MakeXYWH(20, 30, 120, 25), paint);
+        canvas->save();
+            canvas->clipRect(SkRect::MakeXYWH(40, 0, 30, 100));
+            paint.setColor(SK_ColorRED);
+            canvas->drawPaint(paint);
+        canvas->restore();
+    SkAutoTUnref<const SkPicture> picture(recorder.endRecording());
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 200);
+    SkMatrix matrix;
+    matrix.setScale(2, 2);
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected);
+    expectedCanvas.concat(matrix);
+    picture->playback(&expectedCanvas);
+
+    // Tile sizes that don't evenly divide the surface exercise the edge tiles.
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info));
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    REPORTER_ASSERT(r, SkPictureUtils::DrawTiled(picture, surface, &matrix, 64, 37));
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    REPORTER_ASSERT(r, surface->getCanvas()->readPixels(&actual, 0, 0));
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+// A stand-in codec: the "encoding" is the width and height followed by the N32 pixels.
+static SkData* encode_raw_pixels(size_t*, const SkBitmap& bm) {
+    SkDynamicMemoryWStream stream;
+    SkAutoLockPixels lock(bm);
+    stream.write32(bm.width());
+    stream.write32(bm.height());
+    for (int y = 0; y < bm.height(); ++y) {
+        stream.write(bm.getAddr32(0, y), bm.width() * sizeof(SkPMColor));
+    }
+    return stream.copyToData();
+}
+
+// Decodes encode_raw_pixels()' data when asked for pixels, counting the decodes.
+class RawPixelsGenerator : public SkImageGenerator {
+public:
+    explicit RawPixelsGenerator(SkData* encoded) : fEncoded(SkRef(encoded)) {}
+
+    static int gDecodes;
+
+protected:
+    virtual bool onGetInfo(SkImageInfo* info) SK_OVERRIDE {
+        const int32_t* header = static_cast<const int32_t*>(fEncoded->data());
+        *info = SkImageInfo::MakeN32Premul(header[0], header[1]);
+        return true;
+    }
+
+    virtual bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                             SkPMColor ctable[], int* ctableCount) SK_OVERRIDE {
+        const size_t srcRowBytes = info.minRowBytes();
+        const char* src = static_cast<const char*>(fEncoded->data()) + 2 * sizeof(int32_t);
+        for (int y = 0; y < info.height(); ++y) {
+            memcpy(static_cast<char*>(pixels) + y * rowBytes, src + y * srcRowBytes, srcRowBytes);
+        }
+        sk_atomic_inc(&gDecodes);
+        return true;
+    }
+
+private:
+    SkAutoTUnref<SkData> fEncoded;
+};
+
+int RawPixelsGenerator::gDecodes;
+
+// Counts the encoded bitmaps handed over as views of gSerialized rather than as copies.
+static const SkData* gSerialized;
+static int gInPlaceBitmaps;
+
+static bool install_raw_pixels(SkData* encoded, SkBitmap* dst) {
+    const uint8_t* start = gSerialized->bytes();
+    if (encoded->bytes() >= start &&
+        encoded->bytes() + encoded->size() <= start + gSerialized->size()) {
+        gInPlaceBitmaps++;
+    }
+    return SkInstallDiscardablePixelRef(SkNEW_ARGS(RawPixelsGenerator, (encoded)), dst);
+}
+
+static bool decode_raw_pixels(const void* src, size_t length, SkBitmap* dst) {
+    SkAutoDataUnref encoded(SkData::NewWithCopy(src, length));
+    return SkInstallDiscardablePixelRef(SkNEW_ARGS(RawPixelsGenerator, (encoded)), dst);
+}
+
+DEF_TEST(Picture_CreateFromData, r) {
+    SkBitmap bm;
+    make_bm(&bm, 20, 10, SK_ColorRED, true);
+
+    SkPictureRecorder nestedRecorder;
+    nestedRecorder.beginRecording(50, 50)->drawBitmap(bm, 5, 30);
+    SkAutoTUnref<SkPicture> nested(nestedRecorder.endRecording());
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(50, 50);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 30, 15), paint);
+        canvas->drawBitmap(bm, 25, 5);
+        canvas->drawPicture(nested);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream wStream;
+    picture->serialize(&wStream, &encode_raw_pixels);
+    SkAutoDataUnref serialized(wStream.copyToData());
+
+    SkMemoryStream stream(serialized);
+    SkAutoTUnref<SkPicture> fromStream(SkPicture::CreateFromStream(&stream, &decode_raw_pixels));
+    gSerialized = serialized;
+    gInPlaceBitmaps = 0;
+    RawPixelsGenerator::gDecodes = 0;
+    SkAutoTUnref<SkPicture> fromData(SkPicture::CreateFromData(serialized, &install_raw_pixels));
+    REPORTER_ASSERT(r, fromStream.get() && fromData.get());
+    if (NULL == fromStream.get() || NULL == fromData.get()) {
+        return;
+    }
+    // One bitmap was serialized with each picture. Neither is copied or decoded by loading.
+    REPORTER_ASSERT(r, 2 == gInPlaceBitmaps);
+    REPORTER_ASSERT(r, 0 == RawPixelsGenerator::gDecodes);
+
+    SkBitmap expected, actual;
+    make_bm(&expected, 50, 50, SK_ColorWHITE, false);
+    make_bm(&actual, 50, 50, SK_ColorWHITE, false);
+    SkCanvas expectedCanvas(expected), actualCanvas(actual);
+    fromStream->playback(&expectedCanvas);
+    fromData->playback(&actualCanvas);
+    REPORTER_ASSERT(r, RawPixelsGenerator::gDecodes > 0);
+    REPORTER_ASSERT(r, SK_ColorRED == expected.getColor(30, 7));
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+
+    // The picture keeps what it needs of the data alive.
+    serialized.reset(NULL);
+    make_bm(&actual, 50, 50, SK_ColorWHITE, false);
+    SkCanvas againCanvas(actual);
+    fromData->playback(&againCanvas);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+class PictureDataTester {
+public:
+    static const SkData* OpData(const SkPicture& picture) {
+        return picture.fData.get() ? picture.fData->opData() : NULL;
+    }
+
+    // Whether the hash a picture has cached is the hash of the record it holds.
+    static bool ContentHashIsCurrent(const SkPicture& picture) {
+        return picture.contentHash() == SkPicture::ContentHash(*picture.fRecord);
+    }
+};
+
+DEF_TEST(Picture_CreateFromDataWithoutCopy, r) {
+    SkPictureRecorder nestedRecorder;
+    nestedRecorder.beginRecording(50, 50)->drawCircle(25, 25, 20, SkPaint());
+    SkAutoTUnref<SkPicture> nested(nestedRecorder.endRecording());
+
+    // Text and a shader, so the typeface and factory chunks come ahead of the buffer.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(50, 50);
+        const SkPoint pts[] = { { 0, 0 }, { 50, 50 } };
+        const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+        SkPaint paint;
+        paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                       SkShader::kClamp_TileMode))->unref();
+        canvas->drawRect(SkRect::MakeXYWH(5, 5, 40, 20), paint);
+        canvas->drawText("skp", 3, 10, 40, SkPaint());
+        canvas->drawPicture(nested);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream wStream;
+    picture->serialize(&wStream);
+    SkAutoDataUnref serialized(wStream.copyToData());
+    REPORTER_ASSERT(r, SkIsAlign4(reinterpret_cast<intptr_t>(serialized->data())));
+
+    SkAutoTUnref<SkPicture> fromData(SkPicture::CreateFromData(serialized,
+                                                               &install_raw_pixels));
+    REPORTER_ASSERT(r, fromData.get());
+    if (NULL == fromData.get()) {
+        return;
+    }
+    // The ops of an SKP in aligned memory are used where they are.
+    const SkData* ops = PictureDataTester::OpData(*fromData);
+    REPORTER_ASSERT(r, ops && ops->bytes() >= serialized->bytes() &&
+                       ops->bytes() + ops->size() <= serialized->bytes() + serialized->size());
+
+    SkBitmap expected, actual;
+    make_bm(&expected, 50, 50, SK_ColorWHITE, false);
+    make_bm(&actual, 50, 50, SK_ColorWHITE, false);
+    SkCanvas expectedCanvas(expected), actualCanvas(actual);
+    picture->playback(&expectedCanvas);
+    fromData->playback(&actualCanvas);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+static void draw_streaming_content(SkCanvas* canvas, const SkPicture* nested,
+                                   const SkBitmap& bm) {
+    SkRandom rand;
+    SkPaint paint;
+    // Top-level clips, which can't skip ahead when streamed.
+    canvas->clipRect(SkRect::MakeWH(180, 190));
+    for (int i = 0; i < 200; ++i) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        const SkRect r = SkRect::MakeXYWH(rand.nextRangeF(0, 180), rand.nextRangeF(0, 180),
+                                          rand.nextRangeF(2, 20), rand.nextRangeF(2, 20));
+        switch (i % 5) {
+            case 0:
+                canvas->drawRect(r, paint);
+                break;
+            case 1:
+                // A clip that empties itself, which playback skips past to the restore.
+                canvas->save();
+                canvas->clipRect(SkRect::MakeXYWH(-10, -10, 5, 5));
+                canvas->drawOval(r, paint);
+                canvas->restore();
+                break;
+            case 2:
+                canvas->save();
+                canvas->translate(r.fLeft, r.fTop);
+                canvas->clipRect(SkRect::MakeWH(r.width(), r.height()));
+                canvas->drawPicture(nested);
+                canvas->restore();
+                break;
+            case 3:
+                canvas->pushCull(r);
+                canvas->drawBitmap(bm, r.fLeft, r.fTop);
+                canvas->popCull();
+                break;
+            default:
+                canvas->drawCircle(r.centerX(), r.centerY(), r.width(), paint);
+                break;
+        }
+    }
+}
+
+DEF_TEST(Picture_StreamingRecorder, r) {
+    SkBitmap bm;
+    make_checkerboard(&bm, 8, 8, true);
+
+    SkPictureRecorder nestedRecorder;
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    nestedRecorder.beginRecording(20, 20)->drawOval(SkRect::MakeWH(20, 20), paint);
+    SkAutoTUnref<SkPicture> nested(nestedRecorder.endRecording());
+
+    SkPictureRecorder recorder;
+    draw_streaming_content(recorder.beginRecording(200, 200), nested, bm);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    // Small chunks, so the ops are split many times, including between saves.
+    SkDynamicMemoryWStream wStream;
+    SkStreamingPictureRecorder streamingRecorder;
+    draw_streaming_content(streamingRecorder.beginRecording(&wStream, 200, 200, NULL, 256),
+                           nested, bm);
+    REPORTER_ASSERT(r, streamingRecorder.endRecording());
+    REPORTER_ASSERT(r, NULL == streamingRecorder.getRecordingCanvas());
+    SkAutoDataUnref serialized(wStream.copyToData());
+
+    SkMemoryStream stream(serialized);
+    SkAutoTUnref<SkPicture> fromStream(SkPicture::CreateFromStream(&stream));
+    SkAutoTUnref<SkPicture> fromData(SkPicture::CreateFromData(serialized,
+                                                               &install_raw_pixels));
+    REPORTER_ASSERT(r, fromStream.get() && fromData.get());
+    if (NULL == fromStream.get() || NULL == fromData.get()) {
+        return;
+    }
+    REPORTER_ASSERT(r, picture->cullRect() == fromStream->cullRect());
+
+    SkBitmap expected;
+    make_bm(&expected, 200, 200, SK_ColorWHITE, false);
+    SkCanvas expectedCanvas(expected);
+    picture->playback(&expectedCanvas);
+
+    const SkPicture* loaded[] = { fromStream, fromData };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(loaded); ++i) {
+        SkBitmap actual;
+        make_bm(&actual, 200, 200, SK_ColorWHITE, false);
+        SkCanvas actualCanvas(actual);
+        loaded[i]->playback(&actualCanvas);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSize()));
+    }
+}
+
+// Records a layer of a frame: a circle, whose radius stands in for the layer's content.
+static SkPicture* record_layer(SkScalar radius, const SkPicture* previous) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawCircle(50, 50, radius, paint);
+    return recorder.endRecordingReusing(previous);
+}
+
+static SkPicture* record_frame(const SkPicture* layer1, const SkPicture* layer2,
+                               const SkPicture* previous, SkBBHFactory* factory = NULL) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(200, 100, factory);
+    canvas->drawPicture(layer1);
+    canvas->translate(100, 0);
+    canvas->drawPicture(layer2);
+    return recorder.endRecordingReusing(previous);
+}
+
+DEF_TEST(Picture_EndRecordingReusing, r) {
+    SkAutoTUnref<SkPicture> layer1(record_layer(10, NULL));
+    SkAutoTUnref<SkPicture> layer2(record_layer(20, NULL));
+    SkAutoTUnref<SkPicture> frame1(record_frame(layer1, layer2, NULL));
+
+    // Layers sharing with the last frame find their counterparts in it.
+    SkAutoTUnref<SkPicture> same1(record_layer(10, frame1));
+    SkAutoTUnref<SkPicture> changed2(record_layer(30, frame1));
+    REPORTER_ASSERT(r, same1.get() == layer1.get());
+    REPORTER_ASSERT(r, changed2.get() != layer2.get());
+    SkAutoTUnref<SkPicture> frame2(record_frame(same1, changed2, frame1));
+    REPORTER_ASSERT(r, frame2.get() != frame1.get());
+    // New pictures are hashed as they're stored.
+    REPORTER_ASSERT(r, PictureDataTester::ContentHashIsCurrent(*changed2));
+    REPORTER_ASSERT(r, PictureDataTester::ContentHashIsCurrent(*frame2));
+
+    // Layers recorded without sharing are swapped for equal ones when drawn into a frame that
+    // shares, and then the frame as a whole is equal to the last one.
+    SkAutoTUnref<SkPicture> fresh1(record_layer(10, NULL));
+    SkAutoTUnref<SkPicture> fresh2(record_layer(30, NULL));
+    REPORTER_ASSERT(r, fresh1.get() != layer1.get());
+    SkAutoTUnref<SkPicture> frame3(record_frame(fresh1, fresh2, frame2));
+    REPORTER_ASSERT(r, frame3.get() == frame2.get());
+
+    // A frame that wants a BBH won't share one that has none.
+    SkRTreeFactory factory;
+    SkAutoTUnref<SkPicture> frame4(record_frame(layer1, changed2, frame2, &factory));
+    REPORTER_ASSERT(r, frame4.get() != frame2.get());
+    SkAutoTUnref<SkPicture> frame5(record_frame(layer1, changed2, frame4, &factory));
+    REPORTER_ASSERT(r, frame5.get() == frame4.get());
+
+    // Shared or not, every frame draws the same as the one it was recorded from.
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(200, 100);
+    actual.allocN32Pixels(200, 100);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas(expected).drawPicture(frame3);
+    actual.eraseColor(SK_ColorWHITE);
+    SkAutoTUnref<SkPicture> unshared(record_frame(fresh1, fresh2, NULL));
+    SkCanvas(actual).drawPicture(unshared);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()));
+}
+
+// Draws 100 colored rects, with one moved and one recolored when changed.
+static SkPicture* record_damage_frame(bool changed) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(500, 500, NULL, 0);
+    SkRandom rand;
+    for (int i = 0; i < 100; i++) {
+        SkScalar x = rand.nextRangeScalar(0, 450),
+                 y = rand.nextRangeScalar(0, 450);
+        SkPaint paint;
+        paint.setColor(rand.nextU() | 0xFF000000);
+        if (changed && 40 == i) {
+            x += 25;
+        }
+        if (changed && 70 == i) {
+            paint.setColor(SK_ColorRED);
+        }
+        canvas->drawRect(SkRect::MakeXYWH(x, y, 50, 50), paint);
+    }
+    return recorder.endRecording();
+}
+
+DEF_TEST(Picture_ComputeDamage, r) {
+    SkAutoTUnref<SkPicture> before(record_damage_frame(false));
+    SkAutoTUnref<SkPicture> after(record_damage_frame(true));
+
+    SkRegion damage;
+    SkPictureUtils::ComputeDamage(before, before, &damage);
+    REPORTER_ASSERT(r, damage.isEmpty());
+
+    SkPictureUtils::ComputeDamage(before, after, &damage);
+    REPORTER_ASSERT(r, !damage.isEmpty());
+    // At most the moved rect, before and after, and the recolored one.
+    int area = 0;
+    for (SkRegion::Iterator iter(damage); !iter.done(); iter.next()) {
+        area += iter.rect().width() * iter.rect().height();
+    }
+    REPORTER_ASSERT(r, area <= 3 * 51 * 51);
+
+    // Clearing and redrawing after over before, clipped to the damage, draws all of after.
+    SkBitmap incremental, full;
+    incremental.allocN32Pixels(500, 500);
+    full.allocN32Pixels(500, 500);
+    SkCanvas incrementalCanvas(incremental), fullCanvas(full);
+    incrementalCanvas.clear(SK_ColorWHITE);
+    fullCanvas.clear(SK_ColorWHITE);
+
+    before->playback(&incrementalCanvas);
+    incrementalCanvas.clipRegion(damage);
+    incrementalCanvas.drawColor(SK_ColorWHITE, SkXfermode::kSrc_Mode);
+    after->playback(&incrementalCanvas);
+    after->playback(&fullCanvas);
+
+    SkAutoLockPixels lockIncremental(incremental), lockFull(full);
+    REPORTER_ASSERT(r, 0 == memcmp(incremental.getPixels(), full.getPixels(),
+                                   full.getSize()));
+}
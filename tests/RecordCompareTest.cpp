@@ -0,0 +1,101 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkPath.h"
+#include "SkRecord.h"
+#include "SkRecordCompare.h"
+#include "SkRecorder.h"
+#include "SkRecords.h"
+
+static const int W = 1920, H = 1080;
+
+// Draws a little of everything, with the last rect's width and the text's color varying.
+static void draw(SkCanvas* canvas, SkScalar width, SkColor textColor) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.quadTo(50, 80, 90, 10);
+
+    canvas->save();
+    canvas->clipRect(SkRect::MakeWH(500, 500));
+    canvas->drawPath(path, paint);
+    canvas->translate(20, 30);
+    canvas->drawRect(SkRect::MakeWH(width, 100), paint);
+    canvas->restore();
+
+    const SkPoint pos[] = { {0, 0}, {10, 0}, {20, 0} };
+    paint.setColor(textColor);
+    canvas->drawPosText("abc", 3, pos, paint);
+}
+
+DEF_TEST(RecordCompare, r) {
+    SkRecord a, b, c, d;
+    SkRecorder recA(&a, W, H), recB(&b, W, H), recC(&c, W, H), recD(&d, W, H);
+    draw(&recA, 100, SK_ColorBLACK);
+    draw(&recB, 100, SK_ColorBLACK);
+    draw(&recC, 101, SK_ColorBLACK);
+    draw(&recD, 100, SK_ColorRED);
+
+    REPORTER_ASSERT(r, SkRecordEqual(a, b));
+    REPORTER_ASSERT(r, SkRecordHash(a) == SkRecordHash(b));
+    REPORTER_ASSERT(r, !SkRecordEqual(a, c));
+    REPORTER_ASSERT(r, !SkRecordEqual(a, d));
+    REPORTER_ASSERT(r, SkRecordHash(a) != SkRecordHash(c));
+    REPORTER_ASSERT(r, SkRecordHash(a) != SkRecordHash(d));
+
+    // NoOps are skipped, so a and d differ only in what we no-op here.
+    d.replace<SkRecords::NoOp>(d.count() - 1);
+    REPORTER_ASSERT(r, !SkRecordEqual(a, d));
+    a.replace<SkRecords::NoOp>(a.count() - 1);
+    REPORTER_ASSERT(r, SkRecordEqual(a, d));
+    REPORTER_ASSERT(r, SkRecordHash(a) == SkRecordHash(d));
+    REPORTER_ASSERT(r, !SkRecordEqual(a, b));
+}
+
+DEF_TEST(RecordCompare_Damage, r) {
+    const SkRect a = SkRect::MakeLTRB(10, 10, 20, 20),
+                 b = SkRect::MakeLTRB(100, 100, 120, 120),
+                 c = SkRect::MakeLTRB(300, 300, 340, 340),
+                 moved = SkRect::MakeLTRB(200, 200, 220, 220);
+    const SkIRect clip = SkIRect::MakeWH(W, H);
+
+    SkRecord before;
+    SkRecorder recBefore(&before, W, H);
+    recBefore.drawRect(a, SkPaint());
+    recBefore.drawRect(b, SkPaint());
+    recBefore.save();
+        recBefore.clipRect(SkRect::MakeLTRB(0, 0, 320, 320));
+        recBefore.drawRect(c, SkPaint());
+    recBefore.restore();
+
+    SkRegion damage;
+    SkRecordComputeDamage(before, before, clip, &damage);
+    REPORTER_ASSERT(r, damage.isEmpty());
+
+    // Moving b damages where it was and where it is, and nothing else.
+    SkRecord after;
+    SkRecorder recAfter(&after, W, H);
+    recAfter.drawRect(a, SkPaint());
+    recAfter.drawRect(moved, SkPaint());
+    recAfter.save();
+        recAfter.clipRect(SkRect::MakeLTRB(0, 0, 330, 330));
+        recAfter.drawRect(c, SkPaint());
+    recAfter.restore();
+
+    SkRecordComputeDamage(before, after, clip, &damage);
+    REPORTER_ASSERT(r, damage.contains(SkIRect::MakeLTRB(100, 100, 120, 120)));
+    REPORTER_ASSERT(r, damage.contains(SkIRect::MakeLTRB(200, 200, 220, 220)));
+    REPORTER_ASSERT(r, !damage.intersects(SkIRect::MakeLTRB(10, 10, 20, 20)));
+
+    // Changing the clip damages what it clips, before and after.
+    REPORTER_ASSERT(r, damage.contains(SkIRect::MakeLTRB(300, 300, 330, 330)));
+    REPORTER_ASSERT(r, !damage.intersects(SkIRect::MakeLTRB(331, 331, 340, 340)));
+}
@@ -217,7 +217,7 @@ DEF_TEST(RecordDraw_PartialClear, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, rerecord, 1);
     REPORTER_ASSERT(r, drawRect->rect == rect);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == SK_ColorRED);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == SK_ColorRED);
 }
 
 // A regression test for crbug.com/415468 and skbug.com/2957.
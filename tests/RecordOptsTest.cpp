@@ -162,5 +162,154 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != NULL);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
+
+    // The other draws shared goodDrawPaint, but they shouldn't pick up the folded alpha.
+    const SkRecords::DrawRect* unfolded = assert_type<SkRecords::DrawRect>(r, record, 10);
+    REPORTER_ASSERT(r, unfolded != NULL);
+    REPORTER_ASSERT(r, unfolded->paint->getColor() == 0xFF020202);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantSetMatrices, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.translate(10, 10);                               // 0: replaced by the next.
+    recorder.translate(10, 10);                               // 1
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());     // 2
+    recorder.save();                                          // 3
+        recorder.resetMatrix();                               // 4
+        recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint()); // 5
+    recorder.restore();                                       // 6
+    recorder.setMatrix(recorder.getTotalMatrix());            // 7: already in effect.
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());     // 8
+    recorder.save();                                          // 9
+        recorder.scale(2, 2);                                 // 10: undone by the restore.
+    recorder.restore();                                       // 11
+
+    SkRecordNoopRedundantSetMatrices(&record);
+    assert_type<SkRecords::NoOp>     (r, record, 0);
+    assert_type<SkRecords::SetMatrix>(r, record, 1);
+    assert_type<SkRecords::SetMatrix>(r, record, 4);
+    assert_type<SkRecords::NoOp>     (r, record, 7);
+    assert_type<SkRecords::NoOp>     (r, record, 10);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantClipRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.clipRect(SkRect::MakeWH(100, 100));                  // 0
+    recorder.save();                                              // 1
+        recorder.clipRect(SkRect::MakeWH(200, 200));              // 2: contains the clip.
+        recorder.translate(50, 50);                               // 3
+        recorder.clipRect(SkRect::MakeLTRB(-50, -50, 50, 50));    // 4: the same, translated.
+        recorder.clipRect(SkRect::MakeWH(40, 40));                // 5: shrinks it.
+        recorder.clipRect(SkRect::MakeWH(50, 50), SkRegion::kIntersect_Op, true);  // 6: soft.
+        recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());     // 7
+    recorder.restore();                                           // 8
+    recorder.clipRect(SkRect::MakeWH(200, 200), SkRegion::kUnion_Op);  // 9: grows it.
+    recorder.clipRect(SkRect::MakeWH(150, 150));                  // 10: may shrink it.
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());         // 11
+
+    SkRecordNoopRedundantClipRects(&record);
+    assert_type<SkRecords::ClipRect>(r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 2);
+    assert_type<SkRecords::NoOp>    (r, record, 4);
+    assert_type<SkRecords::ClipRect>(r, record, 5);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+    assert_type<SkRecords::ClipRect>(r, record, 9);
+    assert_type<SkRecords::ClipRect>(r, record, 10);
+}
+
+DEF_TEST(RecordOpts_MergeDrawRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint paint, other, antiAliased;
+    other.setColor(SK_ColorRED);
+    antiAliased.setAntiAlias(true);
+
+    // A row of three rects.
+    recorder.drawRect(SkRect::MakeLTRB( 0, 0, 10, 10), paint);        // 0
+    recorder.drawRect(SkRect::MakeLTRB(10, 0, 20, 10), paint);        // 1
+    recorder.drawRect(SkRect::MakeLTRB(20, 0, 30, 10), paint);        // 2
+    // Overlapping.
+    recorder.drawRect(SkRect::MakeLTRB(25, 0, 40, 10), paint);        // 3
+    // Another paint.
+    recorder.drawRect(SkRect::MakeLTRB(40, 0, 50, 10), other);        // 4
+    // Stacked, but antialiased.
+    recorder.drawRect(SkRect::MakeLTRB(0, 10, 10, 20), antiAliased);  // 5
+    recorder.drawRect(SkRect::MakeLTRB(0, 20, 10, 30), antiAliased);  // 6
+
+    SkRecordMergeDrawRects(&record);
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    const SkRecords::DrawRect* merged = assert_type<SkRecords::DrawRect>(r, record, 2);
+    REPORTER_ASSERT(r, merged && merged->rect == SkRect::MakeLTRB(0, 0, 30, 10));
+    for (unsigned i = 3; i < 7; i++) {
+        assert_type<SkRecords::DrawRect>(r, record, i);
+    }
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent;
+    translucent.setAlpha(0x80);
+
+    recorder.clipRect(SkRect::MakeWH(100, 100));                   // 0
+    recorder.drawRect(SkRect::MakeWH(50, 50), opaque);             // 1: occluded by 10.
+    recorder.save();                                               // 2: occluded by 10.
+        recorder.translate(10, 10);                                // 3
+        recorder.drawRect(SkRect::MakeWH(50, 50), opaque);         // 4
+    recorder.restore();                                            // 5
+    recorder.save();                                               // 6
+        recorder.clipRect(SkRect::MakeWH(200, 200), SkRegion::kReplace_Op);  // 7: escapes.
+        recorder.drawRect(SkRect::MakeWH(150, 150), opaque);       // 8
+    recorder.restore();                                            // 9
+    recorder.drawRect(SkRect::MakeWH(100, 100), opaque);           // 10: occluder.
+    recorder.save();                                               // 11
+        recorder.clipRect(SkRect::MakeWH(50, 50));                 // 12
+        recorder.drawRect(SkRect::MakeWH(100, 100), translucent);  // 13: not an occluder.
+        recorder.drawRect(SkRect::MakeWH(60, 60), opaque);         // 14: occluder.
+    recorder.restore();                                            // 15
+    recorder.save();                                               // 16
+        recorder.drawRect(SkRect::MakeWH(100, 100), opaque);       // 17: occluder.
+    recorder.restore();                                            // 18
+
+    SkRecordNoopOccludedDraws(&record);
+    for (unsigned i = 1; i < 6; i++) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::Save>    (r, record, 6);
+    assert_type<SkRecords::DrawRect>(r, record, 8);
+    // 14 occludes 13, then 17, through the Save at 16, occludes 10 and the block 11-15.
+    for (unsigned i = 10; i < 16; i++) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::DrawRect>(r, record, 17);
+}
+
+DEF_TEST(RecordOpts_MergeDrawPosTexts, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint paint;
+    const SkScalar xpos[] = { 0, 10, 20 };
+
+    recorder.drawPosTextH("ab", 2, xpos, 10, paint);      // 0
+    recorder.drawPosTextH("c", 1, xpos + 2, 10, paint);   // 1
+    recorder.drawPosTextH("d", 1, xpos, 20, paint);       // 2: another baseline.
+
+    SkRecordMergeDrawPosTexts(&record);
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    const SkRecords::DrawPosTextH* merged = assert_type<SkRecords::DrawPosTextH>(r, record, 1);
+    if (merged) {
+        REPORTER_ASSERT(r, 3 == merged->byteLength);
+        REPORTER_ASSERT(r, 0 == memcmp("abc", merged->text, 3));
+        REPORTER_ASSERT(r, 0 == memcmp(xpos, merged->xpos, sizeof(xpos)));
+    }
+    assert_type<SkRecords::DrawPosTextH>(r, record, 2);
 }
@@ -118,12 +118,12 @@ DEF_TEST(RecordPattern_IsDraw, r) {
 
     REPORTER_ASSERT(r, pattern.match(&record, 3));
     REPORTER_ASSERT(r, pattern.first<Save>()    != NULL);
-    REPORTER_ASSERT(r, pattern.second<SkPaint>()->getColor() == 0xEEAA8822);
+    REPORTER_ASSERT(r, pattern.second<const SkPaint>()->getColor() == 0xEEAA8822);
     REPORTER_ASSERT(r, pattern.third<Restore>() != NULL);
 
     REPORTER_ASSERT(r, pattern.match(&record, 6));
     REPORTER_ASSERT(r, pattern.first<Save>()    != NULL);
-    REPORTER_ASSERT(r, pattern.second<SkPaint>()->getColor() == 0xFACEFACE);
+    REPORTER_ASSERT(r, pattern.second<const SkPaint>()->getColor() == 0xFACEFACE);
     REPORTER_ASSERT(r, pattern.third<Restore>() != NULL);
 }
 
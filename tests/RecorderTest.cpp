@@ -6,6 +6,7 @@
  */
 
 #include "Test.h"
+#include "RecordTestUtils.h"
 
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
@@ -102,6 +103,32 @@ DEF_TEST(Recorder_RefLeaking, r) {
     REPORTER_ASSERT(r, paint.getShader()->unique());
 }
 
+// Equal paints should be stored once per SkRecord, and their refs dropped with the record.
+DEF_TEST(Recorder_InternPaints, r) {
+    SkPaint paint;
+    paint.setShader(SkShader::CreateEmptyShader())->unref();
+
+    REPORTER_ASSERT(r, paint.getShader()->unique());
+    {
+        SkRecord record;
+        SkRecorder recorder(&record, 100, 100);
+        recorder.drawRect(SkRect::MakeWH(10, 10), paint);
+        recorder.drawRect(SkRect::MakeWH(20, 20), paint);
+        REPORTER_ASSERT(r, 1 == record.paintCount());
+        REPORTER_ASSERT(r, !paint.getShader()->unique());
+
+        SkPaint other(paint);
+        other.setColor(SK_ColorBLUE);
+        recorder.drawOval(SkRect::MakeWH(30, 30), other);
+        REPORTER_ASSERT(r, 2 == record.paintCount());
+
+        const SkRecords::DrawRect* first  = assert_type<SkRecords::DrawRect>(r, record, 0);
+        const SkRecords::DrawRect* second = assert_type<SkRecords::DrawRect>(r, record, 1);
+        REPORTER_ASSERT(r, first->paint.get() == second->paint.get());
+    }
+    REPORTER_ASSERT(r, paint.getShader()->unique());
+}
+
 DEF_TEST(Recorder_RefPictures, r) {
     SkAutoTUnref<SkPicture> pic;
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTaskGroup.h"
+#include "SkThread.h"
+#include "Test.h"
+
+class Counter : public SkRunnable {
+public:
+    Counter() : fRuns(0) {}
+
+    virtual void run() SK_OVERRIDE { sk_atomic_inc(&fRuns); }
+
+    int32_t fRuns;
+};
+
+DEF_TEST(TaskGroup_Batch, r) {
+    static const int kTasks = 1000;
+    Counter counters[kTasks];
+    SkRunnable* tasks[kTasks];
+    for (int i = 0; i < kTasks; i++) {
+        tasks[i] = &counters[i];
+    }
+
+    SkTaskGroup tg;
+    tg.batch(tasks, kTasks/2, SkTaskGroup::kLow_Priority);
+    tg.batch(tasks + kTasks/2, kTasks - kTasks/2, SkTaskGroup::kHigh_Priority);
+    tg.batch(tasks, 0);  // Should be harmless.
+    tg.wait();
+
+    for (int i = 0; i < kTasks; i++) {
+        REPORTER_ASSERT(r, 1 == counters[i].fRuns);
+    }
+}
+
+// Each of these adds more work from inside a task, then waits on it there.
+class Spawner : public SkRunnable {
+public:
+    virtual void run() SK_OVERRIDE {
+        SkTaskGroup tg;
+        for (int i = 0; i < kChildren; i++) {
+            tg.add(&fChildren[i], (SkTaskGroup::Priority)(i % SkTaskGroup::kPriorityCount));
+        }
+        tg.wait();
+    }
+
+    static const int kChildren = 10;
+    Counter fChildren[kChildren];
+};
+
+DEF_TEST(TaskGroup_Nested, r) {
+    static const int kSpawners = 50;
+    Spawner spawners[kSpawners];
+
+    SkTaskGroup tg;
+    for (int i = 0; i < kSpawners; i++) {
+        tg.add(&spawners[i]);
+    }
+    tg.wait();
+
+    for (int i = 0; i < kSpawners; i++) {
+        for (int j = 0; j < Spawner::kChildren; j++) {
+            REPORTER_ASSERT(r, 1 == spawners[i].fChildren[j].fRuns);
+        }
+    }
+}
+
+struct Doubler {
+    void operator()(int i) { fOut[i] = 2 * i; }
+    int* fOut;
+};
+
+DEF_TEST(TaskGroup_ParallelFor, r) {
+    static const int kCount = 10000;
+    SkAutoTMalloc<int> out(kCount);
+
+    const int grains[] = { 1, 7, 256, kCount, 2 * kCount };
+    for (size_t g = 0; g < SK_ARRAY_COUNT(grains); g++) {
+        sk_bzero(out.get(), kCount * sizeof(int));
+        Doubler doubler = { out.get() };
+        sk_parallel_for(kCount, grains[g], doubler);
+        for (int i = 0; i < kCount; i++) {
+            REPORTER_ASSERT(r, out[i] == 2 * i);
+        }
+    }
+
+    Doubler nothing = { NULL };
+    sk_parallel_for(0, 1, nothing);  // Should never call nothing(i).
+}
+
+struct Summer {
+    void operator()(int i, int64_t* sum) { *sum += i; }
+    void join(int64_t* sum, int64_t partial) { *sum += partial; }
+};
+
+DEF_TEST(TaskGroup_ParallelReduce, r) {
+    static const int kCount = 100000;
+    const int64_t expected = (int64_t)kCount * (kCount - 1) / 2;
+
+    Summer summer;
+    REPORTER_ASSERT(r, expected == sk_parallel_reduce(kCount, 1000, (int64_t)0, summer));
+    REPORTER_ASSERT(r, expected == sk_parallel_reduce(kCount, 1, (int64_t)0, summer));
+    REPORTER_ASSERT(r, 42 == sk_parallel_reduce(0, 1000, (int64_t)42, summer));
+}
@@ -6,6 +6,8 @@
  */
 
 #include "SkColor.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
 #include "SkXfermode.h"
 #include "Test.h"
 
@@ -51,7 +53,39 @@ static void test_IsMode(skiatest::Reporter* reporter) {
     }
 }
 
+// xfer32() may run SIMD code (SSE2, AVX2, NEON...) for whole groups of pixels.  It must give
+// the same answer as the mode's proc, whatever the count and dst alignment.
+static void test_xfer32(skiatest::Reporter* reporter) {
+    static const int kMaxCount = 43;
+    static const int kMaxOffset = 8;
+    SkRandom rand;
+    SkPMColor src[kMaxCount], dst[kMaxCount + kMaxOffset], expected[kMaxCount];
+
+    for (int i = 0; i <= SkXfermode::kLastSeparableMode; ++i) {
+        SkXfermode::Mode mode = (SkXfermode::Mode)i;
+        SkXfermode* xfer = SkXfermode::Create(mode);
+        if (NULL == xfer) {
+            continue;
+        }
+        SkXfermodeProc proc = SkXfermode::GetProc(mode);
+
+        for (int count = 0; count <= kMaxCount; count++) {
+            int offset = count % kMaxOffset;
+            for (int j = 0; j < count; j++) {
+                src[j] = SkPreMultiplyColor(rand.nextU());
+                dst[offset + j] = SkPreMultiplyColor(rand.nextU());
+                expected[j] = proc(src[j], dst[offset + j]);
+            }
+            xfer->xfer32(dst + offset, src, count, NULL);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(dst + offset, expected, count * sizeof(SkPMColor)));
+        }
+        xfer->unref();
+    }
+}
+
 DEF_TEST(Xfermode, reporter) {
     test_asMode(reporter);
     test_IsMode(reporter);
+    test_xfer32(reporter);
 }
@@ -808,6 +808,8 @@ SkBBHFactory* PictureRenderer::getFactory() {
             return SkNEW(SkRTreeFactory);
         case kTileGrid_BBoxHierarchyType:
             return SkNEW_ARGS(SkTileGridFactory, (fGridInfo));
+        case kPackedRTree_BBoxHierarchyType:
+            return SkNEW(SkPackedRTreeFactory);
     }
     SkASSERT(0); // invalid bbhType
     return NULL;
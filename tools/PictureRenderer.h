@@ -58,8 +58,9 @@ public:
         kNone_BBoxHierarchyType = 0,
         kRTree_BBoxHierarchyType,
         kTileGrid_BBoxHierarchyType,
+        kPackedRTree_BBoxHierarchyType,
 
-        kLast_BBoxHierarchyType = kTileGrid_BBoxHierarchyType,
+        kLast_BBoxHierarchyType = kPackedRTree_BBoxHierarchyType,
     };
 
     // this uses SkPaint::Flags as a base and adds additional flags
@@ -262,6 +263,8 @@ public:
         }
         if (kRTree_BBoxHierarchyType == fBBoxHierarchyType) {
             config.append("_rtree");
+        } else if (kPackedRTree_BBoxHierarchyType == fBBoxHierarchyType) {
+            config.append("_packedrtree");
         } else if (kTileGrid_BBoxHierarchyType == fBBoxHierarchyType) {
             config.append("_grid");
             config.append("_");
@@ -310,6 +313,8 @@ public:
         }
         if (kRTree_BBoxHierarchyType == fBBoxHierarchyType) {
             result["bbh"] = "rtree";
+        } else if (kPackedRTree_BBoxHierarchyType == fBBoxHierarchyType) {
+            result["bbh"] = "packedrtree";
         } else if (kTileGrid_BBoxHierarchyType == fBBoxHierarchyType) {
             SkString tmp("grid_");
             tmp.appendS32(fGridInfo.fTileInterval.width());
@@ -18,7 +18,7 @@
 
 // Alphabetized list of flags used by this file or bench_ and render_pictures.
 DEFINE_string(bbh, "none", "bbhType [width height]: Set the bounding box hierarchy type to "
-              "be used. Accepted values are: none, rtree, grid. "
+              "be used. Accepted values are: none, rtree, packedrtree, grid. "
               "Not compatible with --pipe. With value "
               "'grid', width and height must be specified. 'grid' can "
               "only be used with modes tile, record, and "
@@ -348,6 +348,8 @@ sk_tools::PictureRenderer* parseRenderer(SkString& error, PictureTool tool) {
             bbhType = sk_tools::PictureRenderer::kNone_BBoxHierarchyType;
         } else if (0 == strcmp(type, "rtree")) {
             bbhType = sk_tools::PictureRenderer::kRTree_BBoxHierarchyType;
+        } else if (0 == strcmp(type, "packedrtree")) {
+            bbhType = sk_tools::PictureRenderer::kPackedRTree_BBoxHierarchyType;
         } else if (0 == strcmp(type, "grid")) {
             if (!gridSupported) {
                 error.printf("'--bbh grid' is not compatible with --mode=%s.\n", mode);
@@ -73,6 +73,9 @@ int tool_main(int argc, char** argv) {
         // reading the file.
         return kSuccess;
     }
+    if (info.fVersion >= 37) {
+        stream.skip(SK_PICT_HEADER_PADDING);
+    }
 
     for (;;) {
         uint32_t tag = stream.readU32();